@@ -0,0 +1,71 @@
+#ifndef KF_CALC_ACTIVITY_H
+#define KF_CALC_ACTIVITY_H
+
+#define NOMINMAX
+#include <Windows.h>
+#include <algorithm>
+#include <cstdint>
+
+#include "core/circular.h"
+#include "calc/kinematics.h"
+
+namespace kfc {
+
+    constexpr float kActivityWindowSeconds = 0.5f;   // 动能滑动窗口长度（秒）
+    constexpr float kActivityHoldSeconds = 1.0f;     // 低于结束阈值持续多久才回到静止（秒），避免动作折返处的短暂停顿
+    constexpr float kActivityDefaultRate = 30.0f;    // 不重采样时按 Kinect 原始帧率估算窗口
+
+    // 活动状态变化
+    enum class ActivityTransition {
+        None = 0,
+        Onset,      // 静止 -> 运动
+        Offset      // 运动 -> 静止
+    };
+
+    // 活动检测：按被跟踪关节的单位质量动能（½|v|² 的关节平均）在短窗口内求均值，
+    // 用开始/结束两个阈值做滞回判断用户是否在运动，回到静止还需持续 kActivityHoldSeconds。
+    // 每个样本 O(1)，不分配堆内存
+    class ActivityDetector {
+    private:
+        CircularBuffer<float> _energies;   // 窗口内每个样本的动能
+        size_t _window;                    // 窗口大小（样本）
+        size_t _hold;                      // 回到静止前需持续低于结束阈值的样本数
+        size_t _quiet;                     // 运动状态下连续低于结束阈值的样本数
+        float _energySum;                  // 窗口内动能之和
+        size_t _sinceResum;                // 上次按窗口重算 _energySum 后的样本数
+        float _onsetEnergy;                // 窗口平均动能 >= 此值时进入运动
+        float _offsetEnergy;               // 窗口平均动能 < 此值时回到静止
+        bool _active;
+        uint64_t _transitions;             // 累计状态变化次数
+
+    public:
+        // rate: 输入样本的帧率，0 表示未重采样；阈值均为 0 时第一个样本即进入运动且不再回到静止
+        explicit ActivityDetector(float rate, float onsetEnergy = 0.0f, float offsetEnergy = 0.0f);
+
+        // 输入一个运动学样本，返回此样本引起的状态变化
+        ActivityTransition push(const KinematicsSample& sample);
+
+        // 新阈值从下一个样本开始生效；offsetEnergy 大于 onsetEnergy 时按 onsetEnergy 处理
+        void setThresholds(float onsetEnergy, float offsetEnergy);
+
+        [[nodiscard]] inline bool isActive() const { return _active; }
+
+        // 窗口平均动能（米²/秒²）
+        [[nodiscard]] inline float energy() const {
+            // 两次重算之间滚动求和的舍入误差仍可能使和略小于 0
+            return _energies.empty() ? 0.0f : std::max(0.0f, _energySum) / static_cast<float>(_energies.size());
+        }
+
+        // 累计状态变化次数，调用方比较前后两次的值即可得知期间是否发生过变化
+        [[nodiscard]] inline uint64_t getTransitions() const { return _transitions; }
+
+        // 清空窗口并回到静止，不计为一次状态变化
+        void reset();
+    };
+
+    // 单个样本的单位质量动能：被跟踪关节 ½|v|² 的平均，无有效关节时为 0
+    float kineticEnergy(const KinematicsSample& sample);
+
+} // namespace kfc
+
+#endif // KF_CALC_ACTIVITY_H
@@ -4,14 +4,16 @@
 #define NOMINMAX
 #include <Windows.h>
 #include <Kinect.h>
-#include <future>
 #include <mutex>
 #include <cmath> 
 #include <limits>
+#include <vector>
 #include <Eigen/Dense>
 
 #include "core/common.h"
 #include "calc/serialize.h"
+#include "calc/feature.h"
+#include "config/params.h"
 
 namespace kfc {
 
@@ -26,15 +28,63 @@ float calculateAngleSimilarity(float angle, float sigma);
 
 // 速度相关函数声明
 float calculateJointSpeed(const JointData& current, const JointData& prev, float timeInterval);
-float calculateSpeedPenalty(float speedRatio);
+float calculateSpeedPenalty(float speedRatio, const ScoringParams& params);
 
 // 相似度计算核心函数声明
-float compareFrames(const FrameData& realFrame, const FrameData& templateFrame);
-float postProcessSimilarity(float rawSimilarity, float sensitivity);
+float compareFeatures(const FrameFeature& realFrame, const FrameFeature& templateFrame, const ScoringParams& params);
+float compareFrames(const FrameData& realFrame, const FrameData& templateFrame, const ScoringParams& params);
+float postProcessSimilarity(float rawSimilarity, const ScoringParams& params, float sensitivity = 2.0f);
 
-// 动作比较相关函数声明
-float compareActionBuffer(const ActionBuffer& buffer, const ActionTemplate& actionTemplate);
-std::future<float> compareActionAsync(const ActionBuffer& buffer);
+// DTW 走廊：每行允许访问的列区间 [begin, end]（1 起，含两端），相似度只在走廊内紧凑存储。
+// Sakoe-Chiba 带是其中一种，其他约束只要给出逐行区间即可复用
+struct DtwCorridor {
+    std::vector<size_t> begin;    // 第 i 行起始列，下标 0 对应 DP 第 1 行
+    std::vector<size_t> end;
+    std::vector<size_t> offset;   // 第 i 行在 similarity 中的起点，末尾多一项为总格数
+    std::vector<float> similarity;
+
+    [[nodiscard]] inline size_t cells() const { return offset.back(); }
+    [[nodiscard]] inline float at(size_t i, size_t j) const { return similarity[offset[i - 1] + (j - begin[i - 1])]; }
+};
+
+// 评分临时缓冲：DTW 代价矩阵、走廊与实时帧的重采样/特征。
+// 容量只增不减，跨调用复用，窗口长度稳定后评分不再分配堆内存；
+// 不是线程安全的，每个评分线程（或会话）各持有一份
+struct DtwWorkspace {
+    std::vector<float> cost;                  // 走廊内的累计代价，布局与 corridor.similarity 相同
+    DtwCorridor corridor;
+
+    // params.sequenceStride > 1 时抽帧后的实时序列与模板
+    std::vector<FrameFeature> stridedReal;
+    std::vector<FrameFeature> stridedTemplate;
+
+    // compareActionBuffer 使用，frames / resampled 的元素个数可能多于本次窗口的有效帧数
+    std::vector<FrameData> frames;
+    std::vector<FrameData> resampled;
+    std::vector<FrameFeature> features;
+    KinematicsProfile kinematics;
+
+    // 当前占用的容量（字节），用于日志
+    [[nodiscard]] size_t capacityBytes() const;
+};
+
+// 动作比较相关函数声明（均不保存状态，结果平滑由 ScoringSession 负责）
+// rawSimilarity 非空时写入后处理前的相似度
+// 不带 workspace 的重载每次使用临时缓冲，适合一次性调用
+float compareFeatureSequence(const std::vector<FrameFeature>& realFeatures, float realAvgSpeed,
+                             const ActionTemplate& actionTemplate, const ScoringParams& params,
+                             float* rawSimilarity = nullptr);
+float compareFeatureSequence(const std::vector<FrameFeature>& realFeatures, float realAvgSpeed,
+                             const ActionTemplate& actionTemplate, const ScoringParams& params,
+                             DtwWorkspace& workspace, float* rawSimilarity = nullptr);
+float compareActionBuffer(const ActionBuffer& buffer, const ActionTemplate& actionTemplate, const ScoringParams& params);
+
+// 任意两段特征序列的 DTW 相似度（后处理前），用于离线分析整段训练等长序列；
+// 计算后 workspace.cost 保存走廊内的累计代价（布局同 corridor.similarity），任一序列为空时返回 0
+float compareSequences(const std::vector<FrameFeature>& realFeatures, const std::vector<FrameFeature>& referenceFeatures,
+                       float realAvgSpeed, float referenceAvgSpeed, const ScoringParams& params, DtwWorkspace& workspace);
+float compareActionBuffer(const ActionBuffer& buffer, const ActionTemplate& actionTemplate, const ScoringParams& params,
+                          DtwWorkspace& workspace);
 
 } // namespace kfc
 
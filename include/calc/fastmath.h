@@ -0,0 +1,69 @@
+#ifndef KF_CALC_FASTMATH_H
+#define KF_CALC_FASTMATH_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace kfc {
+
+    // 评分快速数学模式（similarity.fastMath）使用的近似函数。
+    // 精度足以让最终得分偏差远小于 1 个百分点，可用 --validate-fastmath 对录制文件验证
+
+    // acos，Abramowitz & Stegun 4.4.45，绝对误差 < 7e-5 弧度
+    inline float fastAcos(float x) {
+        const float ax = std::min(std::fabs(x), 1.0f);
+        const float r = std::sqrt(1.0f - ax) *
+            (1.5707288f + ax * (-0.2121144f + ax * (0.0742610f - 0.0187293f * ax)));
+        return x < 0.0f ? 3.14159265f - r : r;
+    }
+
+    // 2^x：整数部分直接写入指数位，小数部分 [-0.5, 0.5] 用 5 阶多项式，相对误差 < 3e-6
+    inline float fastExp2(float x) {
+        x = std::max(-126.0f, std::min(126.0f, x));
+        const int32_t whole = static_cast<int32_t>(x + (x >= 0.0f ? 0.5f : -0.5f));   // 四舍五入，避免调用 floor
+        const float f = x - static_cast<float>(whole);
+        const float p = 1.0f + f * (0.69314718f + f * (0.24022651f + f * (0.05550411f +
+                        f * (0.00961813f + f * 0.00133336f))));
+        const int32_t bits = (whole + 127) << 23;
+        float scale;
+        std::memcpy(&scale, &bits, sizeof(scale));
+        return p * scale;
+    }
+
+    inline float fastExp(float x) {
+        return fastExp2(x * 1.44269504f);
+    }
+
+    // log2(x)，x > 0：拆出指数，尾数折到 [√½, √2) 后用 atanh 级数，绝对误差 < 1e-6
+    inline float fastLog2(float x) {
+        int32_t bits;
+        std::memcpy(&bits, &x, sizeof(bits));
+        int32_t exponent = ((bits >> 23) & 0xFF) - 127;
+        bits = (bits & 0x007FFFFF) | 0x3F800000;
+        float m;
+        std::memcpy(&m, &bits, sizeof(m));
+        if (m > 1.41421356f) {
+            m *= 0.5f;
+            ++exponent;
+        }
+        const float t = (m - 1.0f) / (m + 1.0f);
+        const float t2 = t * t;
+        const float series = t * (2.0f + t2 * (0.66666667f + t2 * (0.4f + t2 * 0.28571429f)));
+        return static_cast<float>(exponent) + series * 1.44269504f;
+    }
+
+    // x^y，x >= 0
+    inline float fastPow(float x, float y) {
+        return x > 0.0f ? fastExp2(y * fastLog2(x)) : 0.0f;
+    }
+
+    inline float fastTanh(float x) {
+        x = std::max(-9.0f, std::min(9.0f, x));
+        return 1.0f - 2.0f / (fastExp(2.0f * x) + 1.0f);
+    }
+
+} // namespace kfc
+
+#endif // KF_CALC_FASTMATH_H
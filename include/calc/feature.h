@@ -0,0 +1,109 @@
+#ifndef KF_CALC_FEATURE_H
+#define KF_CALC_FEATURE_H
+
+#define NOMINMAX
+#include <Windows.h>
+#include <Kinect.h>
+#include <array>
+#include <deque>
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <Eigen/Dense>
+
+#include "core/circular.h"
+#include "calc/serialize.h"
+#include "calc/resample.h"
+#include "calc/kinematics.h"
+#include "calc/activity.h"
+
+namespace kfc {
+
+    constexpr size_t kBoneCount = 12;        // 参与角度比较的骨骼数
+
+    // 骨骼连接关系，用于计算相对角度
+    extern const std::array<std::pair<JointType, JointType>, kBoneCount> boneConnections;
+
+    // 单帧预计算特征：每帧只在进入缓冲区时计算一次，比较时直接使用
+    struct FrameFeature {
+        INT64 timestamp;                                        // 时间戳
+        size_t jointCount;                                      // 原始关节数量
+        std::array<Eigen::Vector3f, kBoneCount> bones;          // 归一化骨骼向量
+        std::array<Eigen::Vector3f, JointType_Count> relPositions; // 以脊柱长度归一化的相对位置
+        uint32_t boneMask;                                      // 骨骼两端均被跟踪
+        uint32_t jointMask;                                     // 关节被跟踪
+        bool spineValid;                                        // SpineBase/SpineMid 均被跟踪
+        float speed;                                            // 关键关节平均速率（米/秒），来自运动学跟踪
+        bool speedValid;                                        // speed 是否有效
+
+        [[nodiscard]] inline bool hasBone(size_t i) const { return (boneMask >> i) & 1u; }
+        [[nodiscard]] inline bool hasJoint(size_t i) const { return (jointMask >> i) & 1u; }
+    };
+
+    // 从一帧骨骼数据提取特征（单帧无法求速度，speedValid 为 false）
+    FrameFeature extractFeature(const FrameData& frame);
+
+    // 从一帧骨骼数据提取特征，速度取自对应的运动学样本
+    FrameFeature extractFeature(const FrameData& frame, const KinematicsSample& kinematics);
+
+    // 批量提取连续序列的特征
+    std::vector<FrameFeature> extractFeatures(const std::vector<FrameData>& frames);
+
+    // 实时特征缓冲区：与 ActionBuffer 对应，入队时完成重采样与特征提取
+    class FeatureBuffer {
+    private:
+        CircularBuffer<FrameFeature> _buffer; // 特征环形缓冲
+        size_t _maxFrames;                    // 最大帧数
+        FrameResampler _resampler;            // 流式重采样器
+        KinematicsTracker _kinematics;        // 增量运动学
+        ActivityDetector _activity;           // 活动检测
+        uint64_t _gaps;                       // 输入间断次数
+
+    public:
+        FeatureBuffer(size_t maxFrames, float rate) : _buffer(maxFrames), _maxFrames(maxFrames), _resampler(rate), _activity(rate), _gaps(0) {}
+
+        // 添加一帧原始数据，重采样后提取特征并入队，返回新入队的特征数。
+        // 与上一帧间隔超过 kMaxInterpolationGap 时不跨间断插值，
+        // 特征窗口、重采样、运动学与活动检测都从该帧重新开始
+        size_t addFrame(const FrameData& frame);
+
+        // 累计的输入间断次数，调用方比较前后两次的值即可知道本次输入是否跨过间断
+        [[nodiscard]] inline uint64_t getGaps() const { return _gaps; }
+
+        // 获取缓冲区中的所有特征
+        [[nodiscard]] inline const CircularBuffer<FrameFeature>& getFeatures() const {
+            return _buffer;
+        }
+
+        // 最近 kSpeedWindow 帧关键关节平均速率，O(1)
+        [[nodiscard]] inline float averageSpeed() const {
+            return _kinematics.averageSpeed();
+        }
+
+        // 重采样后每帧更新的活动状态
+        [[nodiscard]] inline const ActivityDetector& getActivity() const { return _activity; }
+        [[nodiscard]] inline ActivityDetector& getActivity() { return _activity; }
+
+        // 拷贝一份连续的特征快照，供异步比较使用
+        [[nodiscard]] inline std::vector<FrameFeature> snapshot() const {
+            return std::vector<FrameFeature>(_buffer.begin(), _buffer.end());
+        }
+
+        // 同上，写入 out 并复用其容量；首次使用即预留整个缓冲的容量，之后不再扩容
+        inline void snapshot(std::vector<FrameFeature>& out) const {
+            out.reserve(_buffer.capacity());
+            out.assign(_buffer.begin(), _buffer.end());
+        }
+
+        // 清空缓冲区
+        inline void clear() {
+            _buffer.clear();
+            _resampler.reset();
+            _kinematics.reset();
+            _activity.reset();
+        }
+    };
+
+} // namespace kfc
+
+#endif // KF_CALC_FEATURE_H
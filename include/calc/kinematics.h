@@ -0,0 +1,112 @@
+#ifndef KF_CALC_KINEMATICS_H
+#define KF_CALC_KINEMATICS_H
+
+#define NOMINMAX
+#include <Windows.h>
+#include <Kinect.h>
+#include <array>
+#include <deque>
+#include <vector>
+#include <cstdint>
+#include <Eigen/Dense>
+
+#include "core/circular.h"
+#include "calc/serialize.h"
+
+namespace kfc {
+
+    constexpr size_t kSpeedJointCount = 4;   // 参与速度比较的关节数
+    constexpr size_t kSpeedWindow = 5;       // 实时平均速度的滑动窗口（帧）
+
+    // 参与速度比较的关键关节（肘、腕）
+    extern const std::array<JointType, kSpeedJointCount> speedJoints;
+
+    // 单帧运动学量，由相邻两帧差分得到
+    struct KinematicsSample {
+        INT64 timestamp;                                           // 时间戳
+        std::array<Eigen::Vector3f, JointType_Count> velocity;     // 关节速度（米/秒）
+        std::array<Eigen::Vector3f, JointType_Count> acceleration; // 关节加速度（米/秒²）
+        uint32_t velocityMask;                                     // 速度有效（两帧均被跟踪）
+        uint32_t accelerationMask;                                 // 加速度有效（三帧均被跟踪）
+        float speedSum;                                            // 关键关节速率之和
+        int speedCount;                                            // 参与求和的关键关节数
+
+        // 关键关节的平均速率，无有效关节时为 0
+        [[nodiscard]] inline float speed() const {
+            return speedCount > 0 ? speedSum / speedCount : 0.0f;
+        }
+    };
+
+    // 增量运动学跟踪器：逐帧输入，维护速度、加速度及滑动窗口平均速率
+    class KinematicsTracker {
+    private:
+        size_t _window;                                        // 窗口大小（帧）
+        CircularBuffer<KinematicsSample> _samples;             // 窗口内的样本
+        float _windowSpeedSum;                                 // 窗口内 speedSum 之和
+        int _windowSpeedCount;                                 // 窗口内 speedCount 之和
+        size_t _sinceResum;                                    // 上次按窗口重算 _windowSpeedSum 后的帧数
+        std::array<Eigen::Vector3f, JointType_Count> _prevPositions;
+        std::array<Eigen::Vector3f, JointType_Count> _prevVelocity;
+        uint32_t _prevTrackedMask;
+        uint32_t _prevVelocityMask;
+        INT64 _prevTimestamp;
+        bool _hasPrev;
+
+    public:
+        explicit KinematicsTracker(size_t window = kSpeedWindow);
+
+        // 输入一帧，返回该帧的运动学样本（第一帧没有速度）
+        const KinematicsSample& push(const FrameData& frame);
+
+        // 窗口内关键关节平均速率，O(1)
+        [[nodiscard]] inline float averageSpeed() const {
+            return _windowSpeedCount > 0 ? _windowSpeedSum / _windowSpeedCount : 0.0f;
+        }
+
+        // 最近一帧的样本
+        [[nodiscard]] inline const KinematicsSample& latest() const {
+            return _samples.back();
+        }
+
+        [[nodiscard]] inline bool empty() const { return _samples.empty(); }
+
+        void reset();
+    };
+
+    // 整段序列的运动学剖面（模板加载时计算一次），支持 O(1) 区间平均速率查询
+    class KinematicsProfile {
+    private:
+        std::vector<KinematicsSample> _samples;
+        std::vector<float> _speedPrefix;    // speedSum 前缀和
+        std::vector<int> _countPrefix;      // speedCount 前缀和
+
+    public:
+        KinematicsProfile() = default;
+        explicit KinematicsProfile(const std::vector<FrameData>& frames) { build(frames); }
+
+        void build(const std::vector<FrameData>& frames) { build(frames.data(), frames.size()); }
+
+        // 只使用 frames 的前 count 帧
+        void build(const FrameData* frames, size_t count);
+
+        // 帧区间 [begin, end) 内关键关节平均速率
+        [[nodiscard]] float averageSpeed(size_t begin, size_t end) const;
+
+        // 整段序列平均速率
+        [[nodiscard]] inline float averageSpeed() const {
+            return averageSpeed(0, _samples.size());
+        }
+
+        [[nodiscard]] inline const std::vector<KinematicsSample>& getSamples() const {
+            return _samples;
+        }
+    };
+
+    // 节奏比：实时平均速率 / 模板平均速率，模板静止时返回 1
+    [[nodiscard]] inline float tempoRatio(float realSpeed, float templateSpeed) {
+        return templateSpeed > 0.001f ? realSpeed / templateSpeed : 1.0f;
+    }
+
+} // namespace kfc
+
+#endif // KF_CALC_KINEMATICS_H
@@ -0,0 +1,83 @@
+#ifndef KF_CALC_POSEINDEX_H
+#define KF_CALC_POSEINDEX_H
+
+#define NOMINMAX
+#include <Windows.h>
+#include <array>
+#include <vector>
+#include <cstdint>
+
+#include "calc/feature.h"
+
+namespace kfc {
+
+    // 姿态描述子：12 根骨骼的单位方向向量，未跟踪的骨骼置零。
+    // 欧氏距离 |a - b|² = Σ(2 - 2cosθ)，与角度比较同向且满足三角不等式，可用于 VP 树
+    constexpr size_t kPoseDescriptorSize = kBoneCount * 3;
+    using PoseDescriptor = std::array<float, kPoseDescriptorSize>;
+
+    // 低于该距离的最近邻才视为可信的阶段估计（约每根骨骼平均偏差 25°）
+    constexpr float kPoseMatchDistance = 1.5f;
+
+    PoseDescriptor makePoseDescriptor(const FrameFeature& feature);
+
+    float poseDistance(const PoseDescriptor& a, const PoseDescriptor& b);
+
+    // 最近邻查询结果
+    struct PoseMatch {
+        uint32_t templateId;   // addTemplate 返回的模板编号
+        uint32_t frame;        // 模板中的帧号（重采样后）
+        float phase;           // 动作阶段 [0, 1]
+        float distance;        // 描述子距离
+    };
+
+    // 模板帧姿态索引（VP 树）：加载模板时构建一次，查询实时姿态最接近的模板帧，
+    // 用于估计用户当前处于动作的哪个阶段。构建 O(n log n)，查询约 O(log n)，查询期间不分配内存
+    class PoseIndex {
+    public:
+        // 追加一个模板的全部帧，返回模板编号；须在 build 之前调用
+        uint32_t addTemplate(const std::vector<FrameFeature>& features);
+
+        // 构建 VP 树
+        void build();
+
+        // 查询最近的 k 个模板帧，按距离升序写入 out，返回实际个数
+        size_t nearest(const PoseDescriptor& query, size_t k, PoseMatch* out) const;
+
+        // 线性扫描的参考实现，用于校验
+        size_t nearestBruteForce(const PoseDescriptor& query, size_t k, PoseMatch* out) const;
+
+        void clear();
+
+        [[nodiscard]] inline size_t size() const { return _entries.size(); }
+        [[nodiscard]] inline uint32_t getTemplateCount() const { return _templateCount; }
+        [[nodiscard]] inline bool isBuilt() const { return _root >= 0; }
+
+    private:
+        struct Entry {
+            PoseDescriptor descriptor;
+            uint32_t templateId;
+            uint32_t frame;
+            float phase;
+        };
+
+        // 以 vantage 为圆心、radius 为半径划分：inside 子树距离 < radius，outside 子树距离 >= radius
+        struct Node {
+            uint32_t vantage;
+            float radius;
+            int32_t inside;
+            int32_t outside;
+        };
+
+        int32_t buildNode(std::vector<uint32_t>& order, size_t begin, size_t end, std::vector<float>& distances);
+        void search(int32_t node, const PoseDescriptor& query, size_t k, PoseMatch* out, size_t& found) const;
+
+        std::vector<Entry> _entries;
+        std::vector<Node> _nodes;
+        int32_t _root = -1;
+        uint32_t _templateCount = 0;
+    };
+
+} // namespace kfc
+
+#endif // KF_CALC_POSEINDEX_H
@@ -0,0 +1,80 @@
+#ifndef KF_CALC_REPCOUNT_H
+#define KF_CALC_REPCOUNT_H
+
+#define NOMINMAX
+#include <Windows.h>
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+#include "calc/feature.h"
+#include "config/params.h"
+
+namespace kfc {
+
+    // 一次完整重复动作的检测结果
+    struct RepEvent {
+        size_t index;        // 第几次重复（从 1 开始）
+        INT64 startTime;     // 起始帧时间戳
+        INT64 endTime;       // 结束帧时间戳
+        size_t frameCount;   // 重复动作的帧数
+        float distance;      // 子序列 DTW 距离
+        float score;         // 相似度得分 [0, 1]
+    };
+
+    // 重复计数器：对无界实时流做模板的子序列 DTW（SPRING 算法），
+    // 每帧 O(N) 时间、O(N) 内存，N 为模板帧数，与流长度无关
+    class RepCounter {
+    private:
+        std::shared_ptr<const std::vector<FrameFeature>> _template;   // 模板特征，与 ActionTemplate 共享
+        ScoringParams _params;                 // 创建时的评分参数快照
+        float _threshold;                      // 距离阈值（已乘模板长度）
+        size_t _minFrames;                     // 最短重复帧数
+
+        // 路径起点
+        struct PathStart {
+            uint64_t frame;                    // 帧号
+            INT64 time;                        // 时间戳
+        };
+
+        std::vector<float> _dist;              // 当前列累计距离 d(t, i)
+        std::vector<float> _prevDist;          // 上一列累计距离 d(t-1, i)
+        std::vector<PathStart> _start;         // 当前列路径起点
+        std::vector<PathStart> _prevStart;     // 上一列路径起点
+
+        uint64_t _frameIndex;                  // 已输入的帧数
+        float _bestDist;                       // 当前候选距离
+        PathStart _bestStart;                  // 当前候选起点
+        PathStart _bestEnd;                    // 当前候选终点
+        size_t _count;                         // 已完成的重复次数
+
+        // 输出当前候选
+        void report(RepEvent& event);
+
+    public:
+        // templateFeatures: 模板特征（通常为 ActionTemplate::getSharedFeatures()，模板重新加载后旧特征仍有效）
+        // params.repThreshold: 每模板帧的平均代价阈值（代价 = 1 - 帧相似度）
+        // params.repMinLengthRatio: 重复动作的最短长度占模板长度的比例
+        RepCounter(std::shared_ptr<const std::vector<FrameFeature>> templateFeatures, const ScoringParams& params);
+
+        // 输入一帧特征，完成一次重复时写入 event 并返回 true
+        bool push(const FrameFeature& feature, RepEvent& event);
+
+        // 输入流出现间断：路径不跨间断延续，达到阈值的候选立即输出（写入 event 并返回 true），
+        // 其余进行中的路径丢弃，已完成的次数保留
+        bool breakSequence(RepEvent& event);
+
+        // 已完成的重复次数
+        [[nodiscard]] inline size_t getCount() const { return _count; }
+
+        void reset();
+    };
+
+    // 对一段完整序列（例如回放的 .dat 文件）离线计数，间断的处理与实时会话相同
+    std::vector<RepEvent> countRepetitions(const std::vector<FrameData>& frames,
+                                           const ActionTemplate& actionTemplate,
+                                           const ScoringParams& params);
+
+} // namespace kfc
+
+#endif // KF_CALC_REPCOUNT_H
@@ -0,0 +1,89 @@
+#ifndef KF_CALC_RESAMPLE_H
+#define KF_CALC_RESAMPLE_H
+
+#include <algorithm>
+#include <vector>
+
+#include "calc/serialize.h"
+
+namespace kfc {
+
+    constexpr INT64 kMaxInterpolationGap = 5000000;   // 输入间隔超过 0.5 秒（100 纳秒）视为间断，两侧不插值
+
+    // 按 FrameData::timestamp 将帧序列线性插值到统一采样率（Hz）
+    // rate <= 0 或序列无法插值时原样返回
+    std::vector<FrameData> resampleFrames(const std::vector<FrameData>& frames, float rate);
+
+    // 同上，输入为 frames 的前 count 帧，结果写入 out 的前部并返回帧数。
+    // out 只增不减，多出的尾部帧保留以复用其关节数组的内存，调用方只使用返回的前若干帧
+    size_t resampleFrames(const FrameData* frames, size_t count, float rate, std::vector<FrameData>& out);
+
+    // 在两帧之间插值，alpha ∈ [0, 1]，跟踪状态取两端中较差者
+    FrameData interpolateFrame(const FrameData& a, const FrameData& b, float alpha, INT64 timestamp);
+    void interpolateFrame(const FrameData& a, const FrameData& b, float alpha, INT64 timestamp, FrameData& out);
+
+    // 流式重采样器：逐帧输入实时数据，按统一采样率输出插值帧
+    class FrameResampler {
+    private:
+        float _rate;           // 目标采样率（Hz），<= 0 时直通
+        INT64 _interval;       // 采样间隔（100 纳秒）
+        INT64 _nextTime;       // 下一个输出时间点
+        FrameData _prev;       // 上一帧输入
+        FrameData _scratch;    // 插值输出（复用）
+        bool _hasPrev;
+
+    public:
+        explicit FrameResampler(float rate);
+
+        // 输入一帧，把新产生的插值帧追加到 out，返回追加的数量
+        size_t push(const FrameData& frame, std::vector<FrameData>& out);
+
+        // 输入一帧，依次把新产生的插值帧交给 sink(const FrameData&)，返回帧数。
+        // 插值帧写在内部复用的缓冲中，只在 sink 调用期间有效，不分配堆内存
+        template<typename Sink>
+        size_t push(const FrameData& frame, Sink&& sink) {
+            if (_interval <= 0) {
+                sink(frame);
+                return 1;
+            }
+
+            if (!_hasPrev) {
+                _prev = frame;
+                _hasPrev = true;
+                _nextTime = frame.timestamp + _interval;
+                sink(frame);
+                return 1;
+            }
+
+            // 时间戳不递增（同一时刻的其他身体或时钟回退）时忽略该帧
+            if (frame.timestamp <= _prev.timestamp) {
+                return 0;
+            }
+
+            size_t emitted = 0;
+            const INT64 span = frame.timestamp - _prev.timestamp;
+            while (_nextTime <= frame.timestamp) {
+                float alpha = static_cast<float>(_nextTime - _prev.timestamp) / static_cast<float>(span);
+                alpha = std::max(0.0f, std::min(1.0f, alpha));
+                interpolateFrame(_prev, frame, alpha, _nextTime, _scratch);
+                sink(static_cast<const FrameData&>(_scratch));
+                _nextTime += _interval;
+                ++emitted;
+            }
+
+            _prev = frame;
+            return emitted;
+        }
+
+        // 该帧与上一帧输入之间是否为间断（跟踪丢失、暂停等）
+        [[nodiscard]] inline bool isGap(const FrameData& frame) const {
+            return _hasPrev && frame.timestamp - _prev.timestamp > kMaxInterpolationGap;
+        }
+
+        // 丢弃历史，下一帧重新作为起点
+        void reset();
+    };
+
+} // namespace kfc
+
+#endif // KF_CALC_RESAMPLE_H
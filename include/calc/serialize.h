@@ -9,6 +9,9 @@
 #include <Kinect.h>
 #include <future>
 #include <mutex>
+#include <atomic>
+#include <memory>
+#include <cstdint>
 
 namespace kfc {
 
@@ -37,12 +40,32 @@ namespace kfc {
         void deserialize(std::ifstream& in);
     };
 
+    // 定长的单人骨骼帧，可按位拷贝，用于无锁环形缓冲
+    struct BodyFrame {
+        INT64 timestamp;                        // 时间戳
+        INT64 acquireTick;                      // 采集时刻（QPC ticks），用于端到端延迟统计
+        UINT64 trackingId;                      // Kinect 跟踪 ID
+        int bodyIndex;                          // 身体槽位 [0, BODY_COUNT)
+        HandState leftHandState;                // 左手状态
+        HandState rightHandState;               // 右手状态
+        JointData joints[JointType_Count];      // 关节数据
+
+        // 转换为 FrameData（复用 out 的内存）
+        void toFrameData(FrameData& out) const;
+
+        // 从 FrameData 构造，关节不足 JointType_Count 时其余置为未跟踪
+        static BodyFrame fromFrameData(const FrameData& frame, int bodyIndex = 0);
+    };
+
     // 序列化一帧的骨骼数据到文件
     bool SaveFrame(const std::string& filename, const FrameData& frame, bool append = false);
 
     // 从文件读取一帧骨骼数据
     bool LoadFrame(const std::string& filename, FrameData& frame);
 
+    // 从文件读取全部帧（录制文件或标准动作文件）
+    bool LoadFrames(const std::string& filename, std::vector<FrameData>& frames);
+
     //// 序列化一帧的骨骼数据到文件
     //bool SaveFrameToFile(const std::string& filename, const FrameData& frame);
     //
@@ -76,14 +99,25 @@ namespace kfc {
         }
     };
 
+    struct FrameFeature;        // 定义见 calc/feature.h
+    class KinematicsProfile;    // 定义见 calc/kinematics.h
+    class PoseIndex;            // 定义见 calc/poseindex.h
+
     class ActionTemplate {
     private:
         std::unique_ptr<std::vector<kfc::FrameData>> _frames; // 使用堆存储标准动作帧
+        std::vector<kfc::FrameData> _resampledFrames;         // 按 resampleFPS 重采样后的帧，加载时计算一次
+        std::shared_ptr<const std::vector<kfc::FrameFeature>> _features; // 重采样帧的预计算特征，加载时整体替换，旧的由仍在使用者持有
+        std::unique_ptr<kfc::KinematicsProfile> _kinematics;  // 重采样帧的运动学剖面，加载时计算一次
+        std::unique_ptr<kfc::PoseIndex> _poseIndex;           // 重采样帧的姿态索引，加载时构建一次
+        std::atomic<uint64_t> _revision;                      // 每次加载或清空后更新，进程内唯一
 
     public:
         // 构造函数，直接加载文件
         ActionTemplate(const std::string& filePath);
 
+        ~ActionTemplate();
+
         // 加载标准动作数据
         bool loadFromFile(const std::string& filename);
 
@@ -95,15 +129,43 @@ namespace kfc {
             return *_frames; // 解引用智能指针
         }
 
+        // 获取重采样到统一帧率后的帧数据，用于相似度计算
+        [[nodiscard]] inline const std::vector<kfc::FrameData>& getResampledFrames() const {
+            return _resampledFrames;
+        }
+
+        // 获取重采样帧对应的预计算特征
+        [[nodiscard]] inline const std::vector<kfc::FrameFeature>& getFeatures() const {
+            return *_features;
+        }
+
+        // 同上，与模板共享所有权，模板重新加载后仍然有效
+        [[nodiscard]] inline std::shared_ptr<const std::vector<kfc::FrameFeature>> getSharedFeatures() const {
+            return _features;
+        }
+
+        // 模板内容的版本号，无需持有 templateMutex 即可读取，用于发现模板已重新加载
+        [[nodiscard]] inline uint64_t getRevision() const {
+            return _revision.load(std::memory_order_acquire);
+        }
+
+        // 获取运动学剖面（速度、加速度、平均速率）
+        [[nodiscard]] inline const kfc::KinematicsProfile& getKinematics() const {
+            return *_kinematics;
+        }
+
+        // 获取姿态索引，用于估计实时姿态处于动作的哪个阶段
+        [[nodiscard]] inline const kfc::PoseIndex& getPoseIndex() const {
+            return *_poseIndex;
+        }
+
         // 获取帧数量
         [[nodiscard]] inline size_t getFrameCount() const {
             return _frames->size();
         }
 
         // 清空数据
-        inline void clear() {
-            _frames->clear();
-        }
+        void clear();
     };
 
     // 全局变量
@@ -0,0 +1,109 @@
+#ifndef KF_CALC_SESSION_H
+#define KF_CALC_SESSION_H
+
+#define NOMINMAX
+#include <Windows.h>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "calc/feature.h"
+#include "calc/compare.h"
+#include "calc/repcount.h"
+#include "calc/stats.h"
+#include "config/params.h"
+
+namespace kfc {
+
+    // 一帧输入后的评分决定
+    enum class ScoreTrigger {
+        None = 0,     // 未到评分间隔
+        Gated,        // 到达评分间隔但用户静止，按空闲帧率跳过（每个间隔只报告一次）
+        Interval,     // 到达评分间隔
+        Onset,        // 动作开始，立即评分
+        Offset        // 动作结束，立即评分
+    };
+
+    [[nodiscard]] inline bool ShouldScore(ScoreTrigger trigger) {
+        return trigger >= ScoreTrigger::Interval;
+    }
+
+    // 评分会话：一路骨骼流的全部状态（特征缓冲、运动学、重复计数、结果平滑、会话统计）。
+    // 比较函数本身不保存状态，多个会话可在同一进程中并行评分。
+    // 输入端（addFrame 等）与评分端（score 等）可以分别由两个线程调用，二者不共享成员；
+    // 会话统计可被任意线程读取和重置
+    class ScoringSession {
+    private:
+        // 输入端
+        FeatureBuffer _features;                  // 重采样、特征提取与增量运动学
+        std::unique_ptr<RepCounter> _repCounter;  // 重复计数，设置模板后创建
+        uint64_t _templateRevision;               // 创建重复计数器时模板的版本号
+        uint64_t _seenGaps;                       // 已处理的输入间断次数
+        bool _activityGating;                     // 按活动状态调整评分频率
+        INT64 _idleInterval;                      // 静止时的评分间隔（100ns）
+        INT64 _lastCompareTime;                   // 上一次评分的帧时间戳
+        INT64 _lastSlotTime;                      // 上一个按 compareInterval 到达的评分时机（评分或跳过）
+        uint64_t _seenTransitions;                // 上一次评分决定时的活动状态变化次数
+
+        // 评分端
+        float _lastProcessed;                     // 上一次平滑后的相似度
+        SessionStats _stats;                      // 相似度统计
+        DtwWorkspace _workspace;                  // DTW 临时缓冲，跨评分复用
+
+    public:
+        // bufferFrames: 特征缓冲帧数；resampleRate: 重采样帧率，0 表示不重采样；
+        // historyWindow: 窗口统计使用的数据个数，<= 0 表示整个会话
+        ScoringSession(size_t bufferFrames, float resampleRate, int historyWindow);
+
+        ScoringSession(const ScoringSession&) = delete;
+        ScoringSession& operator=(const ScoringSession&) = delete;
+
+        // 输入一帧原始数据，返回新增特征数；完成的重复动作追加到 reps
+        size_t addFrame(const FrameData& frame, std::vector<RepEvent>& reps);
+
+        // 决定是否在此帧对当前缓冲评分：运动中按 compareInterval，静止时按 params.idleCompareInterval，
+        // 动作开始/结束时立即评分一次；缓冲为空时不评分。返回 ShouldScore() 为真的决定即记为一次评分
+        ScoreTrigger nextTrigger(INT64 timestamp, INT64 compareInterval);
+
+        // 以模板特征创建重复计数器（与模板共享特征，不拷贝），计数阈值与活动检测参数取自 params；
+        // 须持有该模板的读锁（全局模板为 templateMutex）
+        void setTemplate(const ActionTemplate& actionTemplate, const ScoringParams& params);
+        [[nodiscard]] inline bool hasTemplate() const { return _repCounter != nullptr; }
+
+        // 重复计数器是否基于该模板的当前内容；模板重新加载后返回 false，调用方应重新 setTemplate
+        [[nodiscard]] inline bool isTemplateCurrent(const ActionTemplate& actionTemplate) const {
+            return _repCounter != nullptr && _templateRevision == actionTemplate.getRevision();
+        }
+
+        [[nodiscard]] inline const CircularBuffer<FrameFeature>& getFeatures() const { return _features.getFeatures(); }
+        [[nodiscard]] inline std::vector<FrameFeature> snapshot() const { return _features.snapshot(); }
+        inline void snapshot(std::vector<FrameFeature>& out) const { _features.snapshot(out); }
+        [[nodiscard]] inline float averageSpeed() const { return _features.averageSpeed(); }
+        [[nodiscard]] inline const ActivityDetector& getActivity() const { return _features.getActivity(); }
+
+        // 清空特征缓冲与活动状态并丢弃重复计数器（下次设置模板时按最新参数重建）
+        void resetInput();
+
+        // 对一段特征快照评分并平滑（比较失败也参与平滑），有效结果计入会话统计；timestamp 为传感器时间戳（100ns）
+        float score(const std::vector<FrameFeature>& features, float averageSpeed,
+                    const ActionTemplate& actionTemplate, const ScoringParams& params, INT64 timestamp);
+
+        // 对当前缓冲评分，输入端与评分端在同一线程时使用
+        float scoreCurrent(const ActionTemplate& actionTemplate, const ScoringParams& params, INT64 timestamp);
+
+        // 平滑一次后处理结果：原始相似度过低时更多保留上一次的值
+        float smooth(float rawSimilarity, float processed);
+
+        // 重新开始平滑
+        inline void resetScoring() { _lastProcessed = 0.0f; }
+
+        [[nodiscard]] inline SessionStats& getStats() { return _stats; }
+        [[nodiscard]] inline const SessionStats& getStats() const { return _stats; }
+
+        // 评分端的临时缓冲，只应在评分线程或其停止后访问
+        [[nodiscard]] inline const DtwWorkspace& getWorkspace() const { return _workspace; }
+    };
+
+} // namespace kfc
+
+#endif // KF_CALC_SESSION_H
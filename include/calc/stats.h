@@ -0,0 +1,125 @@
+#ifndef KF_CALC_STATS_H
+#define KF_CALC_STATS_H
+
+#define NOMINMAX
+#include <Windows.h>
+#include <array>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <cstdint>
+
+#include "core/circular.h"
+
+namespace kfc {
+
+    // 滑动窗口均值与方差：每次更新 O(1)
+    // window <= 0 时不限窗口，统计全部数据
+    class RollingStats {
+    private:
+        CircularBuffer<float> _values; // 窗口内的数据
+        int _window;                 // 窗口大小
+        uint64_t _count;             // 参与统计的数据个数
+        double _mean;                // 均值
+        double _m2;                  // 与均值之差的平方和
+
+    public:
+        explicit RollingStats(int window = 0);
+
+        void add(float value);
+        void reset();
+
+        [[nodiscard]] inline uint64_t count() const { return _count; }
+        [[nodiscard]] inline float mean() const { return static_cast<float>(_mean); }
+        [[nodiscard]] float variance() const;
+        [[nodiscard]] float stddev() const;
+    };
+
+    // P² 流式分位数估计（Jain & Chlamtac），O(1) 内存，不保存原始数据
+    class P2Quantile {
+    private:
+        double _p;                          // 目标分位
+        std::array<double, 5> _heights;     // 标记高度
+        std::array<double, 5> _positions;   // 标记实际位置
+        std::array<double, 5> _desired;     // 标记期望位置
+        std::array<double, 5> _increments;  // 期望位置增量
+        uint64_t _count;
+
+        double parabolic(int i, double d) const;
+        double linear(int i, int d) const;
+
+    public:
+        explicit P2Quantile(double p);
+
+        void add(double value);
+        void reset();
+
+        // 当前估计值，数据不足 5 个时返回已有数据的精确分位
+        [[nodiscard]] double value() const;
+    };
+
+    // 每分钟一个桶
+    struct MinuteBucket {
+        int minute;        // 会话开始后的第几分钟
+        uint32_t count;    // 数据个数
+        float mean;        // 均值
+        float min;         // 最小值
+        float max;         // 最大值
+    };
+
+    // 一次性发布的完整统计快照，读者拿到的各项数据来自同一时刻
+    struct SessionSnapshot {
+        uint64_t count = 0;             // 会话内数据个数
+        float current = 0.0f;           // 最新值
+        float windowMean = 0.0f;        // 窗口均值
+        float windowStdDev = 0.0f;      // 窗口标准差
+        float sessionMean = 0.0f;       // 会话均值
+        float min = 0.0f;               // 会话最小值
+        float max = 0.0f;               // 会话最大值
+        float p10 = 0.0f;               // 会话 10% 分位
+        float p50 = 0.0f;               // 会话中位数
+        float p90 = 0.0f;               // 会话 90% 分位
+        std::vector<MinuteBucket> minutes;   // 每分钟统计（最近两小时）
+    };
+
+    // 会话统计：单写者调用 add，任意线程通过 snapshot 读取一致的快照。
+    // add 只更新累加器、不分配内存，快照在读取时按需生成（读者承担分配）
+    class SessionStats {
+    private:
+        RollingStats _window;            // 窗口统计
+        RollingStats _session;           // 会话统计
+        P2Quantile _p10;
+        P2Quantile _p50;
+        P2Quantile _p90;
+        INT64 _startTime;                // 第 0 分钟的起点（100ns），时间戳回退时重新对齐
+        INT64 _lastTime;                 // 上一条数据的时间戳
+        float _current;                  // 最新值
+        float _min;                      // 会话最小值
+        float _max;                      // 会话最大值
+        CircularBuffer<MinuteBucket> _minutes;   // 最近的每分钟统计，容量固定，满时覆盖最旧的一分钟
+
+        mutable std::mutex _writeMutex;                  // 保护上面的累加器与快照缓存
+        mutable std::shared_ptr<const SessionSnapshot> _snapshot; // 最近一次生成的快照
+        mutable bool _dirty;                             // add 之后快照需要重新生成
+
+    public:
+        // window: 窗口均值/方差使用的数据个数，<= 0 表示整个会话
+        explicit SessionStats(int window);
+
+        // 加入一个数据，timestamp 为传感器时间戳（100ns）
+        void add(float value, INT64 timestamp);
+
+        // 开始新会话
+        void reset();
+
+        // 最新快照，不会读到半更新的数据
+        [[nodiscard]] std::shared_ptr<const SessionSnapshot> snapshot() const;
+    };
+
+    // 输出会话总结：均值、标准差、分位数与每分钟统计
+    void logSessionSummary(const SessionSnapshot& snapshot);
+
+} // namespace kfc
+
+#endif // KF_CALC_STATS_H
@@ -9,8 +9,10 @@
 #include <map>
 #include <algorithm>
 #include <cstdint>
+#include <memory>
 
 #include "calc/serialize.h"
+#include "config/params.h"
 
 #define KF_DATA_DIR "data"
 #define KFC_CONFIG_FILE "data\\config.toml"
@@ -38,6 +40,7 @@ struct Config {
     int displayFPS;                // 画面显示帧率
     int recordFPS;                 // 动作录制帧率
     int compareFPS;                // 相似度计算帧率
+    int resampleFPS;               // 比较前统一重采样的帧率，0 表示不重采样
     
     // 动作缓冲区配置
     int actionBufferSize;          // 动作缓冲区大小（帧数）
@@ -49,8 +52,40 @@ struct Config {
     float minSpeedPenalty;         // 最小速度惩罚
     float dtwBandwidthRatio;       // DTW带宽比例
     float similarityThreshold;      // 相似度阈值
-    int similarityHistorySize;
+    int similarityHistorySize;     // 平均准确率的滑动窗口大小，小于等于0表示整个会话
     int difficulty;                // 难度等级 (1-5)
+    bool fastMath;                 // 评分使用快速近似数学函数
+
+    // 重复计数参数
+    float repThreshold;            // 每模板帧的平均代价阈值
+    float repMinLengthRatio;       // 最短重复长度占模板长度的比例
+
+    // 过滤参数
+    float filterSmoothing;         // 关节位置指数平滑系数，0 表示不平滑
+
+    // 活动检测（运动触发评分）
+    bool activityGating;           // 静止时降低评分频率，动作开始/结束时立即评分；false 时固定按 compareFPS 评分
+    float activityOnsetEnergy;     // 进入运动的窗口平均动能（米²/秒²）
+    float activityOffsetEnergy;    // 回到静止的窗口平均动能（米²/秒²）
+    int idleCompareFPS;            // 静止时的评分帧率
+
+    // 质量调节
+    bool governorEnabled;          // 比较延迟超出预算时自动降低评分质量
+    float governorBudgetMs;        // 比较延迟预算（毫秒），0 表示比较间隔（1 / compareFPS）的一半
+
+    // 指标输出
+    std::string metricsPath;       // 指标快照追加写入的文件，空表示不输出
+    int metricsInterval;           // 指标快照输出间隔（秒）
+
+    // 跟踪输出
+    std::string tracePath;         // Chrome trace 文件，空表示不记录
+
+    // 评分服务
+    std::string serverHost;        // --serve 监听地址，缺省只接受本机连接；协议没有认证，对外开放需显式配置
+    int serverPort;                // --serve 监听端口
+    int serverWorkers;             // 评分工作线程数，0 表示取硬件线程数
+    int serverMaxSessions;         // 同时在线的会话上限，超出的连接直接关闭
+    int serverIdleTimeout;         // 会话多久收不到数据即断开（秒），0 表示不限
     
     [[nodiscard]] static inline Config& getInstance() {
         static Config instance;
@@ -61,11 +96,42 @@ struct Config {
     [[nodiscard]] inline INT64 getDisplayInterval() const { return static_cast<INT64>(10000000.0 / displayFPS); }
     [[nodiscard]] inline INT64 getRecordInterval() const { return static_cast<INT64>(10000000.0 / recordFPS); }
     [[nodiscard]] inline INT64 getCompareInterval() const { return static_cast<INT64>(10000000.0 / compareFPS); }
+    [[nodiscard]] inline INT64 getResampleInterval() const { return resampleFPS > 0 ? static_cast<INT64>(10000000.0 / resampleFPS) : 0; }
+
+    // 质量调节器的延迟预算（微秒），未启用时为 0；未配置预算时取比较间隔的一半
+    [[nodiscard]] inline double getGovernorBudget() const {
+        if (!governorEnabled) return 0.0;
+        if (governorBudgetMs > 0.0f) return governorBudgetMs * 1000.0;
+        const double intervalMicros = getCompareInterval() / 10.0;   // 100ns → 微秒
+        return intervalMicros / 2.0;
+    }
+
+    // actionBufferSize 以传感器帧率（30Hz）计，换算为重采样后覆盖相同时长的帧数
+    [[nodiscard]] inline size_t getFeatureBufferSize() const {
+        if (resampleFPS <= 0) return static_cast<size_t>(actionBufferSize);
+        return std::max<size_t>(2, static_cast<size_t>(actionBufferSize) * resampleFPS / 30);
+    }
+
+    // 当前评分参数快照，评分线程每个任务取一次，之后只读
+    [[nodiscard]] inline std::shared_ptr<const ScoringParams> getScoringParams() const {
+        return std::atomic_load(&scoringParams);
+    }
 
     static bool Init(const std::string& configPath);
 
+    // 重新读取配置文件，只替换评分参数快照，其余配置需重启生效。
+    // 以当前生效的配置为基础：文件中缺失或无法解析的项保持原值
+    static bool Reload(const std::string& configPath);
+
 private:
     static bool Read(const std::string& filename, std::map<std::string, std::string>& config);
+    // 解析成功的项同时写入 applied（可为空）
+    static void Apply(const std::map<std::string, std::string>& configMap, Config& config,
+                      std::map<std::string, std::string>* applied = nullptr);
+    static void PublishScoringParams(const Config& source);   // 由 source 生成新快照并替换单例中的快照
+
+    std::shared_ptr<const ScoringParams> scoringParams;
+    std::map<std::string, std::string> appliedValues;         // 当前生效的配置项（只由加载与热重载线程访问）
 
     Config() : 
         windowWidth(800),
@@ -73,13 +139,33 @@ private:
         displayFPS(60),
         recordFPS(30),
         compareFPS(10),
+        resampleFPS(15),
         actionBufferSize(120),     // 默认120帧
         speedWeight(0.3f),
         minSpeedRatio(0.6f),
         maxSpeedRatio(1.4f),
         minSpeedPenalty(0.5f),
         dtwBandwidthRatio(0.3f),
-        similarityThreshold(0.6f) {}
+        similarityThreshold(0.6f),
+        similarityHistorySize(100),
+        difficulty(3),
+        fastMath(false),
+        repThreshold(0.35f),
+        repMinLengthRatio(0.5f),
+        filterSmoothing(0.0f),
+        activityGating(true),
+        activityOnsetEnergy(0.003f),
+        activityOffsetEnergy(0.0015f),
+        idleCompareFPS(1),
+        governorEnabled(true),
+        governorBudgetMs(0.0f),
+        metricsInterval(10),
+        serverHost("127.0.0.1"),
+        serverPort(5710),
+        serverWorkers(0),
+        serverMaxSessions(64),
+        serverIdleTimeout(60),
+        scoringParams(std::make_shared<const ScoringParams>(ScoringParams::FromConfig(*this, 0))) {}
     
     Config(const Config&) = delete;
     Config& operator=(const Config&) = delete;
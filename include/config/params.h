@@ -0,0 +1,85 @@
+#ifndef KF_CONFIG_PARAMS_H
+#define KF_CONFIG_PARAMS_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+
+namespace kfc {
+
+    struct Config;
+
+    // DTW 动态规划的执行方式，结果逐位相同
+    enum class DtwSchedule {
+        Auto = 0,       // 走廊足够大且线程池多于一个线程时使用波前
+        Sequential,     // 逐行
+        Wavefront       // 按反对角线分块并行
+    };
+
+    // 评分参数快照：由配置生成后不再修改，派生常量预先算好，
+    // 评分函数显式接收该结构，热循环中不再访问 Config 单例
+    struct ScoringParams {
+        static constexpr size_t kMinBandWidth = 10;   // DTW 最小带宽
+
+        uint64_t version;              // 快照版本，每次重新加载加一
+
+        // 速度惩罚
+        float speedWeight;             // 速度惩罚权重
+        float frameWeight;             // 1 - speedWeight
+        float minSpeedRatio;
+        float maxSpeedRatio;
+        float invMinSpeedRatio;        // 1 / minSpeedRatio
+        float invMaxSpeedRatio;        // 1 / maxSpeedRatio
+        float minSpeedPenalty;
+        float speedPenaltyRange;       // 1 - minSpeedPenalty
+
+        // DTW
+        float dtwBandwidthRatio;
+        size_t sequenceStride;         // 比较前实时序列与模板每隔几帧取一帧，1 表示不抽帧（由质量调节器设置）
+        DtwSchedule dtwSchedule;
+
+        // 阈值
+        float similarityThreshold;
+
+        // 快速数学：逐格比较与后处理使用近似的 acos/exp/pow/tanh
+        bool fastMath;
+
+        // 难度相关的后处理系数（postProcessSimilarity）
+        int difficulty;
+        float difficultyFactor;        // 难度3为基准，每级难度增减10%
+        float basePunishment;          // 低相似度的惩罚系数
+        float stretchFactor;           // 非线性拉伸系数
+        float mappingRange;            // sigmoid 映射范围
+        float finalPower;              // 最终幂次
+        float lowSegmentScale;         // 低分段缩放
+        float midSegmentScale;         // 中分段缩放
+        float highSegmentScale;        // 高分段缩放
+
+        // 重复计数
+        float repThreshold;
+        float repMinLengthRatio;
+
+        // 过滤
+        float filterSmoothing;
+
+        // 活动检测
+        bool activityGating;
+        float activityOnsetEnergy;
+        float activityOffsetEnergy;
+        int64_t idleCompareInterval;   // 静止时的评分间隔（100 纳秒）
+
+        // 质量调节
+        double governorBudget;         // 比较延迟预算（微秒），0 表示不调节
+
+        // 由配置生成快照
+        static ScoringParams FromConfig(const Config& config, uint64_t version);
+
+        // 两段序列比较时的 Sakoe-Chiba 带宽
+        [[nodiscard]] inline size_t bandWidth(size_t M, size_t N) const {
+            return std::max<size_t>(static_cast<size_t>(std::min(M, N) * dtwBandwidthRatio), kMinBandWidth);
+        }
+    };
+
+} // namespace kfc
+
+#endif // KF_CONFIG_PARAMS_H
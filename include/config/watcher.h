@@ -0,0 +1,40 @@
+#ifndef KF_CONFIG_WATCHER_H
+#define KF_CONFIG_WATCHER_H
+
+#include <string>
+#include <thread>
+#include <mutex>
+#include <filesystem>
+#include <condition_variable>
+
+namespace kfc {
+
+    // 配置文件监视：后台线程轮询修改时间，文件变化后调用 Config::Reload
+    // 替换评分参数快照，正在进行的评分任务继续使用旧快照
+    class ConfigWatcher {
+    public:
+        [[nodiscard]] static ConfigWatcher& getInstance();
+
+        void start(const std::string& path);
+        void stop();
+
+    private:
+        ConfigWatcher();
+        ~ConfigWatcher();
+        ConfigWatcher(const ConfigWatcher&) = delete;
+        ConfigWatcher& operator=(const ConfigWatcher&) = delete;
+
+        void run();
+
+        std::string _path;
+        std::filesystem::file_time_type _lastWrite;
+
+        std::thread _thread;
+        std::mutex _mutex;
+        std::condition_variable _wake;
+        bool _running;
+    };
+
+} // namespace kfc
+
+#endif // KF_CONFIG_WATCHER_H
@@ -0,0 +1,32 @@
+#ifndef KF_CORE_ALLOC_H
+#define KF_CORE_ALLOC_H
+
+#include <cstdint>
+
+// 诊断构建开关：定义 KF_ALLOC_HOOKS=1（如 /DKF_ALLOC_HOOKS=1）时本模块才替换全局 operator new/delete，
+// 缺省构建保持运行库自带的分配器，计数始终为 0
+#ifndef KF_ALLOC_HOOKS
+#define KF_ALLOC_HOOKS 0
+#endif
+
+namespace kfc {
+
+    // 堆分配计数：诊断构建中全局 operator new/delete 转发到 malloc/free，
+    // 开启后统计所有线程经 operator new 的分配次数与字节数，用于验证热路径不分配内存。
+    // 未开启时每次分配只多一次原子读；对齐版本（align_val_t）与直接调用 malloc 的分配不计入
+    struct AllocationCount {
+        uint64_t count;    // 分配次数
+        uint64_t bytes;    // 分配字节数
+    };
+
+    // 当前构建是否替换了全局分配函数，为 false 时计数不可用
+    [[nodiscard]] constexpr bool IsAllocationCountingAvailable() { return KF_ALLOC_HOOKS != 0; }
+
+    void SetAllocationCounting(bool enabled);
+
+    // 开启计数以来的累计值
+    AllocationCount GetAllocationCount();
+
+} // namespace kfc
+
+#endif // KF_CORE_ALLOC_H
@@ -11,6 +11,7 @@
 #include <strsafe.h>
 #include <atomic>
 #include <mutex>
+#include <memory>
 #include <condition_variable>
 #include <d2d1.h>
 #include <Kinect.h>
@@ -21,6 +22,15 @@
 #include "ui/window.h"
 #include "calc/serialize.h"
 #include "calc/compare.h"
+#include "calc/repcount.h"
+#include "calc/stats.h"
+#include "calc/poseindex.h"
+#include "core/replay.h"
+#include "core/sensor.h"
+#include "core/pipeline.h"
+#include "core/metrics.h"
+#include "core/trace.h"
+#include "core/color.h"
 #include "config/config.h"
 
 // 声明视频窗口子类处理过程
@@ -80,20 +90,27 @@ public:
 
     void ProcessColor(INT64 nTime, RGBQUAD* pBuffer, int nWidth, int nHeight);
 
-    inline void SetRecording(bool isRecording) { m_isRecording = isRecording; }
-    [[nodiscard]] inline bool IsRecording() const { return m_isRecording; }
+    inline void SetRecording(bool isRecording) { m_isRecording.store(isRecording, std::memory_order_release); }
+    [[nodiscard]] inline bool IsRecording() const { return m_isRecording.load(std::memory_order_acquire); }
 
     inline void SetCalcing(bool isCalcing) { 
         if (!isCalcing) {
-            // 重置计算时重置总准确率统计
-            m_fTotalSimilarity.store(0.0f, std::memory_order_relaxed);
-            m_nSimilarityCount.store(0, std::memory_order_relaxed);
+            // 结束本次会话：输出统计总结后重新开始
+            kfc::logSessionSummary(*m_pPipeline->getSessionStats());
+            // 统计、特征缓冲、重复计数与结果平滑一起重新开始
+            m_pPipeline->reset();
+            m_nRepCount.store(0, std::memory_order_relaxed);
+            m_fLastRepScore.store(0.0f, std::memory_order_relaxed);
         }
+        m_pPipeline->setActive(isCalcing);
         m_isCalcing = isCalcing; 
     }
     [[nodiscard]] inline bool IsCalcing() const { return m_isCalcing; }
 
-    inline void ClearRecordFilePath() { m_recordFilePath.clear(); }
+    inline void ClearRecordFilePath() {
+        std::lock_guard<std::mutex> lock(m_recordMutex);
+        m_recordFilePath.clear();
+    }
 
     [[nodiscard]] inline ID2D1HwndRenderTarget* GetRenderTarget() const { return m_pRenderTarget; }
 
@@ -109,6 +126,9 @@ public:
 
     inline void SetPlaybackStartTime(const INT64& playbackStartTime) { m_playbackStartTime = playbackStartTime; }
 
+    // 用户当前处于标准动作的哪个阶段（0 为开始、1 为结束），由姿态索引估计；没有可信匹配时返回负数
+    [[nodiscard]] inline float GetTemplatePhase() const { return m_fTemplatePhase.load(std::memory_order_relaxed); }
+
 
 private:
     HWND                    m_hWnd;
@@ -122,8 +142,8 @@ private:
     IKinectSensor* m_pKinectSensor;
     ICoordinateMapper* m_pCoordinateMapper;
 
-    // Body reader
-    IBodyFrameReader* m_pBodyFrameReader;
+    // Body source（独立采集线程）
+    kfc::KinectBodySource m_bodySource;
 
     // Direct2D
     ID2D1Factory* m_pD2DFactory;
@@ -145,13 +165,15 @@ private:
     // Color Frame 相关
     IColorFrameReader*      m_pColorFrameReader;
     class ImageRenderer*    m_pColorRenderer;
-    RGBQUAD*               m_pColorRGBX;
+    RGBQUAD*               m_pColorRGBX;           // 非 YUY2/BGRA 格式时的全分辨率转换缓冲
+    kfc::ColorConverter    m_colorConverter;       // 彩色帧转换与缩放
+    std::vector<RGBQUAD>   m_colorView;            // 缩放到显示尺寸的 BGRA 帧
     
     // 颜色位图相关
     ID2D1Bitmap*           m_pColorBitmap;
     D2D1_SIZE_U           m_colorBitmapSize;
 
-    bool m_isRecording;             // 是否正在录制
+    std::atomic<bool> m_isRecording; // 是否正在录制（录制线程读取）
     bool m_isCalcing;               // 是否正在计算
     bool m_isPlayingTemplate;       // 是否显示标准动作
     INT64 m_playbackStartTime;      // 播放开始时间
@@ -163,18 +185,28 @@ private:
     
 
     std::string             m_recordFilePath;   // 添加文件路径成员
+    std::mutex              m_recordMutex;      // 保护 m_recordFilePath
 
-    std::atomic<float>      m_fCurrentSimilarity;     // 原子变量用于线程安全的相似度更新
-    std::vector<float>     m_similarityHistory;   // 相似度历史记录
-    size_t                m_historyIndex;         // 历史记录的当前索引
-    std::mutex            m_historyMutex;         // 历史记录的互斥锁
+    // 骨骼帧环形缓冲：采集线程是唯一生产者，渲染、评分流水线、录制各自持有游标
+    std::unique_ptr<kfc::BodyFrameRing> m_pBodyRing;
+    kfc::BodyFrameRing::Cursor* m_pRenderCursor;   // 渲染游标（Overwrite，只关心最新帧）
+    kfc::BodyFrameRing::Cursor* m_pRecordCursor;   // 录制游标（Overwrite，写盘过慢时只丢录制自己的帧）
+    std::unique_ptr<kfc::Pipeline> m_pPipeline;    // 评分流水线（filter → buffer → score → publish）
+    std::thread             m_recordThread;        // 录制线程
+    std::atomic<bool>       m_bRecorderRunning;    // 录制线程运行标志
 
-    std::atomic<float>      m_fTotalSimilarity;       // 总相似度
-    std::atomic<int>        m_nSimilarityCount;       // 相似度计数
+    kfc::BodyFrame          m_latestBodies[BODY_COUNT]; // 渲染端每个身体槽位的最新一帧
+    kfc::FrameData          m_poseFrame;                // 阶段估计时复用的帧缓冲
+
+    std::atomic<float>      m_fCurrentSimilarity;     // 原子变量用于线程安全的相似度更新
     std::mutex             m_similarityMutex;        // 相似度互斥锁
     std::condition_variable m_similarityCV;          // 相似度条件变量
     bool                   m_similarityUpdated;      // 相似度更新标志
 
+    std::atomic<int>        m_nRepCount;              // 已完成的重复次数
+    std::atomic<float>      m_fLastRepScore;          // 最近一次重复的得分
+    std::atomic<float>      m_fTemplatePhase;         // 姿态索引估计的动作阶段 [0, 1]，无可信匹配时为 -1
+
     /// <summary>
     /// Main processing function
     /// </summary>
@@ -187,12 +219,22 @@ private:
     HRESULT                 InitializeDefaultSensor();
 
     /// <summary>
-    /// Handle new body data
-    /// <param name="nTime">timestamp of frame</param>
-    /// <param name="nBodyCount">body data count</param>
-    /// <param name="ppBodies">body data in frame</param>
+    /// Draw template and the latest bodies read from the ring
+    /// <param name="nTime">timestamp of the latest body frame</param>
     /// </summary>
-    void                    ProcessBody(INT64 nTime, int nBodyCount, IBody** ppBodies);
+    void                    ProcessBody(INT64 nTime);
+
+    // 评分流水线发布阶段的回调（在发布线程上执行）
+    void OnPipelineResult(const kfc::PipelineResult& result);
+
+    // 渲染消费者：绘制时间戳为 nTime 的所有身体
+    void RenderBodies(int width, int height, INT64 nTime);
+
+    // 在模板姿态索引中查找与最近一帧用户姿态最接近的模板帧，没有可信匹配时返回 false（须持有 templateMutex）
+    bool EstimateTemplatePhase(INT64 nTime, kfc::PoseMatch& match);
+
+    // 录制线程：从录制游标读取并顺序写入文件
+    void RecordLoop();
 
     // 播放标准动作骨架（蓝色）
     void PlayActionTemplate(INT64 nTime);
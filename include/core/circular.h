@@ -0,0 +1,144 @@
+#ifndef KF_CORE_CIRCULAR_H
+#define KF_CORE_CIRCULAR_H
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace kfc {
+
+    // 定长环形缓冲（单线程）：替代热路径上的 std::deque。
+    // 槽位在构造或扩容时一次分配，容量足够时 push/pop 不分配堆内存。
+    // RetainSlots 为 true 时出队只移动下标，槽位保留旧对象，入队时复用其内存；
+    // 为 false 时出队的槽位重置为 T()，及时释放其持有的资源（连接、套接字等）。
+    // 缺省只有平凡析构的类型保留，只持有内存、需要跨出队复用缓冲的类型可显式指定 true
+    template<typename T, bool RetainSlots = std::is_trivially_destructible_v<T>>
+    class CircularBuffer {
+    private:
+        std::vector<T> _slots;
+        size_t _head = 0;     // 队首所在槽位
+        size_t _size = 0;
+
+        [[nodiscard]] inline size_t slotIndex(size_t i) const {
+            const size_t index = _head + i;
+            return index < _slots.size() ? index : index - _slots.size();
+        }
+
+        inline void release(size_t slot) {
+            if constexpr (!RetainSlots) {
+                _slots[slot] = T();
+            }
+        }
+
+        // 已满时容量翻倍并按逻辑顺序重排，只在预热阶段发生
+        void grow() {
+            std::vector<T> slots(_slots.empty() ? 1 : _slots.size() * 2);
+            for (size_t i = 0; i < _size; ++i) {
+                slots[i] = std::move(_slots[slotIndex(i)]);
+            }
+            _slots.swap(slots);
+            _head = 0;
+        }
+
+    public:
+        template<typename Buffer, typename Value>
+        class Iterator {
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = Value*;
+            using reference = Value&;
+
+            Iterator(Buffer* buffer, size_t index) : _buffer(buffer), _index(index) {}
+
+            inline reference operator*() const { return (*_buffer)[_index]; }
+            inline pointer operator->() const { return &(*_buffer)[_index]; }
+            inline reference operator[](difference_type n) const { return (*_buffer)[_index + n]; }
+            inline Iterator& operator++() { ++_index; return *this; }
+            inline Iterator operator++(int) { Iterator it = *this; ++_index; return it; }
+            inline Iterator& operator--() { --_index; return *this; }
+            inline Iterator operator--(int) { Iterator it = *this; --_index; return it; }
+            inline Iterator& operator+=(difference_type n) { _index += n; return *this; }
+            inline Iterator& operator-=(difference_type n) { _index -= n; return *this; }
+            inline Iterator operator+(difference_type n) const { return Iterator(_buffer, _index + n); }
+            inline Iterator operator-(difference_type n) const { return Iterator(_buffer, _index - n); }
+            inline difference_type operator-(const Iterator& other) const {
+                return static_cast<difference_type>(_index) - static_cast<difference_type>(other._index);
+            }
+            inline bool operator==(const Iterator& other) const { return _index == other._index; }
+            inline bool operator!=(const Iterator& other) const { return _index != other._index; }
+            inline bool operator<(const Iterator& other) const { return _index < other._index; }
+
+        private:
+            Buffer* _buffer;
+            size_t _index;
+        };
+
+        using iterator = Iterator<CircularBuffer, T>;
+        using const_iterator = Iterator<const CircularBuffer, const T>;
+
+        explicit CircularBuffer(size_t capacity = 0) : _slots(capacity) {}
+
+        // 预留容量，已有元素保持顺序
+        void reserve(size_t capacity) {
+            while (_slots.size() < capacity) {
+                grow();
+            }
+        }
+
+        // 追加一个元素并返回其槽位，槽位中保留上一次使用时的对象，调用方直接覆盖写入
+        T& emplace_back() {
+            if (_size == _slots.size()) {
+                grow();
+            }
+            return _slots[slotIndex(_size++)];
+        }
+
+        inline void push_back(const T& value) { emplace_back() = value; }
+        inline void push_back(T&& value) { emplace_back() = std::move(value); }
+
+        inline void pop_front() {
+            release(_head);
+            _head = slotIndex(1);
+            --_size;
+        }
+
+        inline void pop_back() {
+            release(slotIndex(_size - 1));
+            --_size;
+        }
+
+        inline void clear() {
+            if constexpr (!RetainSlots) {
+                for (size_t i = 0; i < _size; ++i) {
+                    release(slotIndex(i));
+                }
+            }
+            _head = 0;
+            _size = 0;
+        }
+
+        [[nodiscard]] inline T& operator[](size_t i) { return _slots[slotIndex(i)]; }
+        [[nodiscard]] inline const T& operator[](size_t i) const { return _slots[slotIndex(i)]; }
+        [[nodiscard]] inline T& front() { return _slots[_head]; }
+        [[nodiscard]] inline const T& front() const { return _slots[_head]; }
+        [[nodiscard]] inline T& back() { return _slots[slotIndex(_size - 1)]; }
+        [[nodiscard]] inline const T& back() const { return _slots[slotIndex(_size - 1)]; }
+
+        [[nodiscard]] inline size_t size() const { return _size; }
+        [[nodiscard]] inline size_t capacity() const { return _slots.size(); }
+        [[nodiscard]] inline bool empty() const { return _size == 0; }
+        [[nodiscard]] inline bool full() const { return _size == _slots.size(); }
+
+        inline iterator begin() { return iterator(this, 0); }
+        inline iterator end() { return iterator(this, _size); }
+        inline const_iterator begin() const { return const_iterator(this, 0); }
+        inline const_iterator end() const { return const_iterator(this, _size); }
+    };
+
+} // namespace kfc
+
+#endif // KF_CORE_CIRCULAR_H
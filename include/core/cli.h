@@ -0,0 +1,33 @@
+#ifndef KF_CORE_CLI_H
+#define KF_CORE_CLI_H
+
+namespace kfc {
+
+    // 命令行工具模式（无需 Kinect 与窗口），识别到命令时执行并写入退出码，返回 true
+    //   --reps <file.dat>              对录制文件离线计数重复动作
+    //   --pose-index <file.dat> [k]    姿态索引校验：逐帧查询最近的模板帧，对比线性扫描与耗时
+    //   --validate-fastmath <file.dat|dir> [...]
+    //                                  对比快速数学与精确模式的评分偏差与耗时
+    //   --validate-wavefront <file.dat> [repeat]
+    //                                  录制与模板各重复 repeat 次（缺省 25），对比波前与逐行 DTW 的结果与耗时
+    //   --golden-record <corpus.txt> <golden.txt>
+    //                                  按用例清单（模板 录制 [容差]）记录当前引擎的逐窗口得分
+    //   --golden-check <golden.txt>    各评分引擎变体对照 golden 文件检查得分、计数与耗时
+    //   --replay <file.dat> [speed]    经评分流水线无窗口回放，speed 为倍速（缺省尽快）
+    //   --headless                     无窗口实时评分，Ctrl+C 结束
+    //   --alloc-check <file.dat> [speed]
+    //                                  回放驱动评分流水线，预热后统计堆分配，稳态出现分配时退出码为 1
+    //   --capture-color <out.yuy2>     抓取一帧原始彩色数据
+    //   --bench-color [raw.yuy2] [n]   彩色转换内核基准（SIMD 与标量对比）
+    //   --serve [port] [host]          多会话评分服务，缺省只监听本机，Ctrl+C 结束
+    //   --replay-clients <file.dat> [clients] [speed] [host] [port]
+    //                                  以回放源模拟多个采集站连接评分服务
+    //   --capture-shm [name]           采集进程：Kinect 骨骼帧发布到共享内存
+    //   --replay-shm <file.dat> [speed] [name]
+    //                                  以回放源代替 Kinect 发布到共享内存
+    //   --score-shm [name]             评分进程：从共享内存读取骨骼帧评分，Ctrl+C 结束
+    bool TryRunCommand(int argc, char** argv, int& exitCode);
+
+} // namespace kfc
+
+#endif // KF_CORE_CLI_H
@@ -0,0 +1,68 @@
+#ifndef KF_CORE_CLIENT_H
+#define KF_CORE_CLIENT_H
+
+#define NOMINMAX
+#include <Windows.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "core/metrics.h"
+#include "core/protocol.h"
+
+namespace kfc {
+
+    // 评分服务客户端：把一路骨骼帧发往 ScoringServer，后台线程接收评分与重复计数
+    class ScoringClient {
+    public:
+        ScoringClient();
+        ~ScoringClient();
+
+        ScoringClient(const ScoringClient&) = delete;
+        ScoringClient& operator=(const ScoringClient&) = delete;
+
+        // 连接并握手，name 为采集站名称
+        bool connect(const std::string& host, uint16_t port, const std::string& name);
+
+        bool sendFrame(const BodyFrame& body);
+        bool sendReset();
+
+        // 发送 Bye 并等待服务端的会话统计，超时或连接断开时返回 false
+        bool finish(WireStats& stats, int timeoutMs = 5000);
+
+        void close();
+
+        [[nodiscard]] inline uint32_t getSessionId() const { return _sessionId; }
+        [[nodiscard]] inline uint64_t getScoreCount() const { return _scores.load(std::memory_order_relaxed); }
+        [[nodiscard]] inline uint64_t getRepCount() const { return _repetitions.load(std::memory_order_relaxed); }
+        [[nodiscard]] inline float getLastSimilarity() const { return _lastSimilarity.load(std::memory_order_relaxed); }
+
+        // 服务端报告的每次评分延迟
+        [[nodiscard]] inline HistogramSnapshot getServerLatency() const { return _serverLatency.snapshot(); }
+
+    private:
+        void receiveLoop();
+
+        uintptr_t _socket;
+        uint32_t _sessionId;
+        std::thread _receiver;
+
+        std::atomic<uint64_t> _scores;
+        std::atomic<uint64_t> _repetitions;
+        std::atomic<float> _lastSimilarity;
+        LatencyHistogram _serverLatency;
+
+        // 会话统计到达或连接断开时唤醒 finish
+        std::mutex _statsMutex;
+        std::condition_variable _statsArrived;
+        WireStats _stats;
+        bool _hasStats;
+        bool _disconnected;
+    };
+
+} // namespace kfc
+
+#endif // KF_CORE_CLIENT_H
@@ -0,0 +1,64 @@
+#ifndef KF_CORE_COLOR_H
+#define KF_CORE_COLOR_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace kfc {
+
+    // 当前编译使用的转换内核："AVX2" / "SSE2" / "scalar"
+    const char* GetColorKernelName();
+
+    // 按纵横比把 srcWidth × srcHeight 适配到 maxWidth × maxHeight 以内（不放大）
+    void FitColorSize(int srcWidth, int srcHeight, int maxWidth, int maxHeight, int& outWidth, int& outHeight);
+
+    // 生成 width × height 的 YUY2 测试图（水平亮度渐变、垂直色度渐变），供基准在没有 Kinect 时使用
+    void FillTestPatternYUY2(uint8_t* frame, int width, int height);
+
+    // 两幅 BGRA 图像 B/G/R 通道的最大差值
+    int MaxChannelDifference(const uint32_t* a, const uint32_t* b, size_t count);
+
+    // 把打包的 YUY2 宏像素（Y0 U Y1 V，小端 uint32）转换为 BGRA 像素，Y 取 (Y0 + Y1) / 2
+    // BT.601 有限范围系数；SIMD 与标量实现的结果相差不超过 1
+    void ConvertPackedYUY2(const uint32_t* packed, uint32_t* bgra, size_t count);
+    void ConvertPackedYUY2Scalar(const uint32_t* packed, uint32_t* bgra, size_t count);
+
+    // 彩色帧转换器：YUY2/BGRA 源帧在转换的同时缩放到显示尺寸，
+    // 每个目标像素对源图 2×2 区域取平均（缩放比小于 2 时退化为最近邻）
+    class ColorConverter {
+    private:
+        int _srcWidth = 0;
+        int _srcHeight = 0;
+        int _dstWidth = 0;
+        int _dstHeight = 0;
+        bool _averageRows = false;                 // 垂直方向缩放比 >= 2
+        bool _averageColumns = false;              // 水平方向缩放比 >= 2
+        std::vector<int> _rows;                    // 目标行 → 源行
+        std::vector<int> _columns;                 // 目标列 → 源列
+        std::vector<uint8_t> _rowBuffer;           // 两行平均后的源行
+        std::vector<uint32_t> _packed;             // 一行采样后的宏像素/像素
+        std::vector<uint32_t> _packedNext;         // BGRA 水平相邻像素
+
+        const uint8_t* sampleRow(const uint8_t* src, size_t stride, int y);
+
+    public:
+        // 设置源/目标尺寸，尺寸不变时复用索引表
+        void configure(int srcWidth, int srcHeight, int dstWidth, int dstHeight);
+
+        // src: srcWidth × srcHeight 的 YUY2 帧；dst: dstWidth × dstHeight 的 BGRA
+        void convertYUY2(const uint8_t* src, uint32_t* dst);
+
+        // src: srcWidth × srcHeight 的 BGRA 帧；dst: dstWidth × dstHeight 的 BGRA
+        void convertBGRA(const uint32_t* src, uint32_t* dst);
+
+        // 与 convertYUY2 相同的采样，使用标量转换，供校验与基准对比
+        void convertYUY2Scalar(const uint8_t* src, uint32_t* dst);
+
+        [[nodiscard]] inline int getWidth() const { return _dstWidth; }
+        [[nodiscard]] inline int getHeight() const { return _dstHeight; }
+    };
+
+} // namespace kfc
+
+#endif // KF_CORE_COLOR_H
@@ -0,0 +1,73 @@
+#ifndef KF_CORE_GOLDEN_H
+#define KF_CORE_GOLDEN_H
+
+#define NOMINMAX
+#include <Windows.h>
+#include <string>
+#include <vector>
+
+#include "calc/serialize.h"
+#include "calc/feature.h"
+#include "calc/kinematics.h"
+#include "calc/compare.h"
+#include "config/params.h"
+
+namespace kfc {
+
+    // 评分引擎变体：同一组参数下只替换计算方式，得分须与基准一致（在容差内）
+    enum class ScoringVariant {
+        Reference = 0,   // 精确数学
+        FastMath,        // similarity.fastMath
+        Wavefront,       // DTW 按反对角线分块并行，须与基准逐位一致
+        Count
+    };
+
+    const char* GetScoringVariantName(ScoringVariant variant);
+
+    // 在 base 的基础上切换到指定变体
+    ScoringParams MakeVariantParams(const ScoringParams& base, ScoringVariant variant);
+
+    // 一次窗口评分
+    struct WindowScore {
+        size_t end;      // 窗口结束位置（重采样帧）
+        float raw;       // 后处理前的相似度
+        float score;     // 最终得分
+    };
+
+    // 离线评分器：把录制文件按评分流水线的缓冲长度与比较节奏切成窗口逐一评分，
+    // 结果与实时评分使用的函数相同，用于验证与回归测试
+    class OfflineScorer {
+    public:
+        // window/step 为 0 时取当前配置（特征缓冲长度、重采样帧率 / 比较帧率）
+        explicit OfflineScorer(size_t window = 0, size_t step = 0);
+
+        // 读取录制文件并完成重采样与特征提取
+        bool load(const std::string& recording);
+
+        // 逐窗口评分，elapsedMs 非空时累加评分耗时（不含加载）
+        std::vector<WindowScore> score(const ActionTemplate& actionTemplate, const ScoringParams& params,
+                                       double* elapsedMs = nullptr) const;
+
+        // 对整段录制计数重复动作
+        size_t countReps(const ActionTemplate& actionTemplate, const ScoringParams& params) const;
+
+        [[nodiscard]] inline size_t getWindow() const { return _window; }
+        [[nodiscard]] inline size_t getStep() const { return _step; }
+
+    private:
+        size_t _window;
+        size_t _step;
+        std::vector<FrameData> _frames;
+        std::vector<FrameFeature> _features;
+        KinematicsProfile _kinematics;
+        mutable DtwWorkspace _workspace;   // 评分临时缓冲，不影响结果
+    };
+
+    // 金标准得分回归：corpus 每行一个 "模板.dat 录制.dat [容差]" 用例，
+    // 用当前引擎（Reference）生成 golden 文件；之后每个引擎变体都对照 golden 检查并报告耗时
+    int RecordGoldenScores(const std::string& corpusPath, const std::string& goldenPath);
+    int CheckGoldenScores(const std::string& goldenPath);
+
+} // namespace kfc
+
+#endif // KF_CORE_GOLDEN_H
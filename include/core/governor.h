@@ -0,0 +1,69 @@
+#ifndef KF_CORE_GOVERNOR_H
+#define KF_CORE_GOVERNOR_H
+
+#define NOMINMAX
+#include <Windows.h>
+#include <array>
+#include <atomic>
+#include <mutex>
+
+#include "config/params.h"
+
+namespace kfc {
+
+    // 一个评分质量等级
+    struct QualityLevel {
+        float bandScale;       // dtwBandwidthRatio 的缩放
+        size_t stride;         // 实时序列与模板的抽帧步长
+        float intervalScale;   // 比较间隔的缩放
+    };
+
+    // 从完整质量开始，依次收窄 DTW 带宽、隔帧比较（相当于降低重采样帧率与模板分辨率）、降低比较频率
+    constexpr std::array<QualityLevel, 5> kQualityLevels = {{
+        { 1.0f, 1, 1.0f },
+        { 0.7f, 1, 1.0f },
+        { 0.7f, 2, 1.0f },
+        { 0.5f, 2, 1.5f },
+        { 0.5f, 3, 2.0f },
+    }};
+
+    // 质量调节器：记录每次比较从提交到得出结果的延迟，指数滑动平均超过预算时降一级，
+    // 持续低于预算的一半时升一级；升级比降级慢，避免在两级之间来回振荡。
+    // 预算随每次记录从参数快照传入，配置热重载后下一次比较即按新预算调节。
+    // record 可由多个评分线程调用；当前等级为原子量，输入端与评分端随时读取
+    class QualityGovernor {
+    public:
+        QualityGovernor();
+
+        QualityGovernor(const QualityGovernor&) = delete;
+        QualityGovernor& operator=(const QualityGovernor&) = delete;
+
+        // 记录一次比较延迟（微秒），budgetMicros 取本次比较所用快照的 governorBudget。
+        // 预算变化时重新统计延迟，<= 0 表示不调节并回到完整质量
+        void record(double micros, double budgetMicros);
+
+        // 按当前等级调整一份参数快照
+        void apply(ScoringParams& params) const;
+
+        // 按当前等级放大比较间隔
+        [[nodiscard]] INT64 scaleInterval(INT64 interval) const;
+
+        [[nodiscard]] inline size_t getLevel() const { return _level.load(std::memory_order_relaxed); }
+
+        // 回到完整质量并清空延迟统计
+        void reset();
+
+    private:
+        void setLevel(size_t level, double average);
+
+        std::mutex _mutex;
+        double _budget;            // 最近一次记录所用的预算（微秒）
+        double _average;           // 比较延迟的指数滑动平均（微秒）
+        size_t _sinceChange;       // 等级变化后记录的比较次数
+        size_t _headroom;          // 连续低于预算一半的比较次数
+        std::atomic<size_t> _level;
+    };
+
+} // namespace kfc
+
+#endif // KF_CORE_GOVERNOR_H
@@ -0,0 +1,164 @@
+#ifndef KF_CORE_METRICS_H
+#define KF_CORE_METRICS_H
+
+#define NOMINMAX
+#include <Windows.h>
+#include <array>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <cstdint>
+#include <condition_variable>
+
+#include "core/utils.h"
+
+namespace kfc {
+
+    // 延迟直方图快照（微秒）
+    struct HistogramSnapshot {
+        uint64_t count = 0;
+        double mean = 0.0;
+        double p50 = 0.0;
+        double p90 = 0.0;
+        double p99 = 0.0;
+        double p999 = 0.0;
+        double max = 0.0;
+    };
+
+    // HDR 风格的对数-线性直方图：每个 2 的幂区间再均分 16 个桶，相对误差约 6%。
+    // record 只有几次 relaxed 原子操作，无锁、无分配，可在任意线程常开
+    class LatencyHistogram {
+    public:
+        static constexpr int kSubBucketBits = 4;
+        static constexpr uint64_t kSubBuckets = 1ull << kSubBucketBits;   // 每个量级的桶数
+        static constexpr size_t kBucketCount = (64 - kSubBucketBits + 1) * kSubBuckets;
+
+        LatencyHistogram() = default;
+        LatencyHistogram(const LatencyHistogram&) = delete;
+        LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+        void record(double micros);
+        void reset();
+
+        [[nodiscard]] HistogramSnapshot snapshot() const;
+
+    private:
+        static size_t bucketIndex(uint64_t value);
+        static uint64_t bucketUpperBound(size_t index);
+
+        std::array<std::atomic<uint64_t>, kBucketCount> _buckets{};
+        std::atomic<uint64_t> _count{ 0 };
+        std::atomic<uint64_t> _sum{ 0 };
+        std::atomic<uint64_t> _max{ 0 };
+    };
+
+    // 延迟指标
+    enum MetricId {
+        Metric_Acquire = 0,    // 骨骼帧采集：取帧到写入环形缓冲
+        Metric_Ingest,         // 缓冲入队：重采样、特征提取
+        Metric_Similarity,     // 帧相似度矩阵
+        Metric_DTW,            // DTW 动态规划
+        Metric_PostProcess,    // 相似度后处理
+        Metric_Render,         // 界面绘制一帧
+        Metric_RecordWrite,    // 录制写盘一帧
+        Metric_EndToEnd,       // 采集到评分结果发布
+        Metric_Count
+    };
+
+    // 计数器
+    enum CounterId {
+        Counter_RingRejected = 0,    // 环形缓冲满，采集端丢弃的帧
+        Counter_RingSkipped,         // 评分流水线落后一圈，被覆盖跳过的帧
+        Counter_InvalidFrames,       // 无被跟踪关节，被过滤的帧
+        Counter_ComparesSkipped,     // 评分阶段忙，被新快照替换的比较任务
+        Counter_DTWRetries,          // DTW 找不到路径、加宽带宽重算的次数
+        Counter_SharedRingDropped,   // 共享内存环形缓冲中评分进程落后、被覆盖跳过的帧
+        Counter_ComparesGated,       // 用户静止，按空闲帧率跳过的比较
+        Counter_ActivityChanges,     // 动作开始/结束触发的比较
+        Counter_Count
+    };
+
+    // 瞬时值
+    enum GaugeId {
+        Gauge_QualityLevel = 0,      // 评分质量等级，0 为完整质量，越大降级越多
+        Gauge_Count
+    };
+
+    const char* GetMetricName(MetricId id);
+    const char* GetCounterName(CounterId id);
+    const char* GetGaugeName(GaugeId id);
+
+    // 全部指标的一次快照
+    struct MetricsSnapshot {
+        double uptimeSeconds = 0.0;
+        std::array<HistogramSnapshot, Metric_Count> latencies;
+        std::array<uint64_t, Counter_Count> counters{};
+        std::array<int64_t, Gauge_Count> gauges{};
+    };
+
+    // 进程级指标：各线程直接写入，snapshot 随时读取，可选后台线程定期追加到文件
+    class Metrics {
+    public:
+        [[nodiscard]] static inline Metrics& getInstance() {
+            static Metrics instance;
+            return instance;
+        }
+
+        inline void record(MetricId id, double micros) { _latencies[id].record(micros); }
+        inline void add(CounterId id, uint64_t n = 1) { _counters[id].fetch_add(n, std::memory_order_relaxed); }
+        inline void set(GaugeId id, int64_t value) { _gauges[id].store(value, std::memory_order_relaxed); }
+
+        [[nodiscard]] MetricsSnapshot snapshot() const;
+
+        // 清零延迟与计数器；瞬时值反映当前状态，保持不变
+        void reset();
+
+        // 以 JSON 行的形式追加一次快照
+        bool dump(const std::string& path) const;
+
+        // 每 intervalSeconds 秒追加一次快照，stopDump 时再写一次
+        void startDump(const std::string& path, int intervalSeconds);
+        void stopDump();
+
+        // 输出到日志
+        void log() const;
+
+    private:
+        Metrics();
+        ~Metrics();
+        Metrics(const Metrics&) = delete;
+        Metrics& operator=(const Metrics&) = delete;
+
+        void dumpLoop(std::string path, int intervalSeconds);
+
+        INT64 _startTick;
+        std::array<LatencyHistogram, Metric_Count> _latencies;
+        std::array<std::atomic<uint64_t>, Counter_Count> _counters{};
+        std::array<std::atomic<int64_t>, Gauge_Count> _gauges{};
+
+        std::thread _dumpThread;
+        std::mutex _dumpMutex;
+        std::condition_variable _dumpWake;
+        bool _dumpRunning;
+    };
+
+    // 作用域计时：析构时把经过的时间记入对应指标
+    class ScopedLatency {
+    public:
+        explicit ScopedLatency(MetricId id) : _id(id), _start(QueryTicks()) {}
+        ~ScopedLatency() {
+            Metrics::getInstance().record(_id, TicksToMicroseconds(QueryTicks() - _start));
+        }
+
+        ScopedLatency(const ScopedLatency&) = delete;
+        ScopedLatency& operator=(const ScopedLatency&) = delete;
+
+    private:
+        MetricId _id;
+        INT64 _start;
+    };
+
+} // namespace kfc
+
+#endif // KF_CORE_METRICS_H
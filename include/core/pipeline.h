@@ -0,0 +1,152 @@
+#ifndef KF_CORE_PIPELINE_H
+#define KF_CORE_PIPELINE_H
+
+#define NOMINMAX
+#include <Windows.h>
+#include <Kinect.h>
+#include <array>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <vector>
+#include <functional>
+#include <condition_variable>
+
+#include "core/queue.h"
+#include "core/metrics.h"
+#include "core/governor.h"
+#include "core/replay.h"
+#include "calc/feature.h"
+#include "calc/repcount.h"
+#include "calc/session.h"
+
+namespace kfc {
+
+    // 流水线阶段，每个阶段（除采集外）运行在独立线程上
+    enum PipelineStage {
+        Stage_Acquire = 0,   // 采集：传感器或回放源写入环形缓冲
+        Stage_Filter,        // 过滤：丢弃无效帧、关节平滑
+        Stage_Buffer,        // 缓冲：重采样、特征提取、重复计数
+        Stage_Score,         // 评分：DTW 比较
+        Stage_Publish,       // 发布：把结果交给界面或日志
+        Stage_Count
+    };
+
+    const char* GetStageName(PipelineStage stage);
+
+    // 随帧端到端传递的时间戳
+    struct FrameStamps {
+        INT64 sensorTime;                      // 传感器时间戳（100ns）
+        INT64 ticks[Stage_Count];              // 各阶段完成时刻（QPC ticks），0 表示未经过该阶段
+    };
+
+    // 流水线输出
+    struct PipelineResult {
+        enum class Kind { Similarity, Repetition };
+
+        Kind kind;
+        float similarity;                      // Kind::Similarity 时有效
+        RepEvent rep;                          // Kind::Repetition 时有效
+        FrameStamps stamps;
+    };
+
+    // 评分流水线：acquire → filter → buffer → score → publish
+    // 阶段之间使用有界队列，评分延迟不再受界面消息循环影响；不依赖窗口，可无界面运行。
+    // 预热（特征缓冲填满、首次评分）之后各阶段不再分配堆内存，可用 --alloc-check 验证
+    class Pipeline {
+    public:
+        using PublishCallback = std::function<void(const PipelineResult&)>;
+
+        // ring: 采集端写入的环形缓冲；policy: 本流水线读游标的策略
+        // 实时运行用 Overwrite（评分跟不上时跳帧），回放用 Backpressure（逐帧处理）
+        Pipeline(BodyFrameRing& ring, RingPolicy policy, PublishCallback onPublish);
+        ~Pipeline();
+
+        Pipeline(const Pipeline&) = delete;
+        Pipeline& operator=(const Pipeline&) = delete;
+
+        void start();
+
+        // 处理完环形缓冲中剩余的帧后依次关闭各阶段
+        void stop();
+
+        // 采集端写入新帧后调用，唤醒过滤阶段
+        void notify();
+
+        // 开启/暂停评分，暂停时帧被读出并丢弃
+        inline void setActive(bool active) { _active.store(active, std::memory_order_release); }
+
+        // 开始新会话：统计立即清空；特征缓冲、重复计数与结果平滑由各自阶段在处理下一项前清空
+        void reset();
+
+        // 本会话的相似度统计，任意线程可调用
+        [[nodiscard]] inline std::shared_ptr<const SessionSnapshot> getSessionStats() const {
+            return _session.getStats().snapshot();
+        }
+
+        // 单个阶段的耗时分布：从上一阶段完成到本阶段完成（含排队时间）
+        // Stage_Acquire 一项记录的是采集到发布的端到端延迟
+        [[nodiscard]] HistogramSnapshot getStageTiming(PipelineStage stage) const;
+
+        // 输出各阶段耗时
+        void logTimings() const;
+
+    private:
+        // 过滤阶段输出：定长骨骼帧，入队出队只做拷贝
+        struct StampedFrame {
+            BodyFrame body;
+            FrameStamps stamps;
+        };
+
+        // 评分任务：特征快照。经 pushSwap/popSwap 在缓冲与评分阶段之间轮转，
+        // 快照缓冲预热后不再分配
+        struct ScoreJob {
+            std::vector<FrameFeature> features;
+            float averageSpeed;
+            FrameStamps stamps;
+        };
+
+        void filterLoop();
+        void bufferLoop();
+        void scoreLoop();
+        void publishLoop();
+
+        // 平滑关节位置，返回该帧是否有效
+        bool filterFrame(BodyFrame& body);
+
+        void recordTiming(const FrameStamps& stamps);
+
+        BodyFrameRing& _ring;
+        BodyFrameRing::Cursor* _cursor;
+        PublishCallback _onPublish;
+
+        BoundedQueue<StampedFrame> _filtered;          // filter → buffer
+        BoundedQueue<ScoreJob, true> _jobs;            // buffer → score，只保留最新快照，槽位保留换回的快照缓冲
+        BoundedQueue<PipelineResult> _results;         // buffer/score → publish
+
+        std::thread _filterThread;
+        std::thread _bufferThread;
+        std::thread _scoreThread;
+        std::thread _publishThread;
+
+        std::atomic<bool> _running;
+        std::atomic<bool> _active;
+        std::atomic<bool> _resetRequested;             // 由缓冲阶段处理
+        std::atomic<bool> _scoreResetRequested;        // 由评分阶段处理
+        std::mutex _wakeMutex;
+        std::condition_variable _wake;
+
+        // 过滤阶段状态：每个身体槽位的平滑结果
+        std::array<BodyFrame, BODY_COUNT> _smoothed;
+        std::array<bool, BODY_COUNT> _smoothedValid;
+
+        // 缓冲阶段使用输入端，评分阶段使用评分端
+        ScoringSession _session;
+        QualityGovernor _governor;                     // 评分阶段记录延迟，缓冲阶段按等级调整比较间隔
+
+        std::array<LatencyHistogram, Stage_Count> _timings;
+    };
+
+} // namespace kfc
+
+#endif // KF_CORE_PIPELINE_H
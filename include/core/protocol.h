@@ -0,0 +1,127 @@
+#ifndef KF_CORE_PROTOCOL_H
+#define KF_CORE_PROTOCOL_H
+
+#define NOMINMAX
+#include <Windows.h>
+#include <Kinect.h>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "calc/serialize.h"
+
+namespace kfc {
+
+    // 评分服务的二进制协议（TCP，小端）：每条消息为 8 字节消息头 + 定长负载
+    // 客户端: Hello → Frame* → [Reset] → Frame* → Bye
+    // 服务端: Welcome → Score/Repetition* → Stats（收到 Bye 后）
+    constexpr uint32_t kProtocolMagic = 0x3146534B;    // "KSF1"
+    constexpr uint16_t kProtocolVersion = 1;
+    constexpr uint16_t kDefaultServerPort = 5710;
+    constexpr uint32_t kMaxMessageSize = 4096;          // 超过即视为协议错误
+    constexpr size_t kClientNameSize = 32;
+
+    enum class MessageType : uint16_t {
+        // 客户端 → 服务端
+        Hello = 1,          // WireHello
+        Frame = 2,          // WireFrame
+        Reset = 3,          // 无负载，开始新的会话统计
+        Bye = 4,            // 无负载，服务端回复 Stats 后关闭连接
+
+        // 服务端 → 客户端
+        Welcome = 16,       // WireWelcome
+        Score = 17,         // WireScore
+        Repetition = 18,    // WireRepetition
+        Stats = 19          // WireStats
+    };
+
+#pragma pack(push, 1)
+    struct MessageHeader {
+        uint16_t type;                      // MessageType
+        uint16_t reserved;
+        uint32_t length;                    // 负载字节数
+    };
+
+    struct WireHello {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t reserved;
+        char name[kClientNameSize];         // 采集站名称，不足时以 0 结尾
+    };
+
+    struct WireWelcome {
+        uint32_t sessionId;
+        uint32_t templateFrames;            // 服务端模板帧数，0 表示没有模板
+    };
+
+    struct WireJoint {
+        float x;
+        float y;
+        float z;
+        uint8_t trackingState;
+    };
+
+    // 一帧骨骼：8 + 25 * 13 = 333 字节
+    struct WireFrame {
+        int64_t timestamp;                  // 传感器时间戳（100ns）
+        WireJoint joints[JointType_Count];
+    };
+
+    struct WireScore {
+        int64_t timestamp;                  // 触发本次评分的帧的时间戳
+        float similarity;
+        uint32_t latencyUs;                 // 服务端收到该帧到发出结果的时间
+    };
+
+    struct WireRepetition {
+        uint32_t index;
+        uint32_t frameCount;
+        int64_t startTime;
+        int64_t endTime;
+        float score;
+    };
+
+    struct WireStats {
+        uint64_t frames;                    // 收到的帧数
+        uint64_t scores;                    // 发出的评分数
+        uint64_t repetitions;
+        uint64_t scoresSkipped;             // 评分忙时被新快照替换的任务
+        float meanSimilarity;
+        float latencyP50Us;
+        float latencyP99Us;
+        float latencyMaxUs;
+    };
+#pragma pack(pop)
+
+    // 编解码（服务端与客户端共用）
+    WireFrame EncodeFrame(const BodyFrame& body);
+    void DecodeFrame(const WireFrame& wire, FrameData& out);
+
+    // 阻塞套接字上的消息收发，socket 为 Winsock SOCKET；失败或连接关闭时返回 false
+    bool InitSockets();
+    bool SendPacket(uintptr_t socket, MessageType type, const void* payload = nullptr, uint32_t length = 0);
+    bool ReceivePacket(uintptr_t socket, MessageHeader& header, std::vector<char>& payload);
+    void CloseSocket(uintptr_t socket);
+
+    // 关闭读写，使阻塞在 recv 上的线程返回
+    void ShutdownSocket(uintptr_t socket);
+
+    template<typename T>
+    inline bool SendPacket(uintptr_t socket, MessageType type, const T& payload) {
+        return SendPacket(socket, type, &payload, static_cast<uint32_t>(sizeof(T)));
+    }
+
+    // 按负载类型读取，长度不符时返回 false
+    template<typename T>
+    inline bool ReadPayload(const MessageHeader& header, const std::vector<char>& payload, T& out) {
+        if (header.length != sizeof(T) || payload.size() < sizeof(T)) {
+            return false;
+        }
+        memcpy(&out, payload.data(), sizeof(T));
+        return true;
+    }
+
+} // namespace kfc
+
+#endif // KF_CORE_PROTOCOL_H
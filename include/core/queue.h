@@ -0,0 +1,131 @@
+#ifndef KF_CORE_QUEUE_H
+#define KF_CORE_QUEUE_H
+
+#include <utility>
+#include <cstdint>
+#include <type_traits>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+
+#include "core/circular.h"
+
+namespace kfc {
+
+    // 队列满时的处理策略
+    enum class QueuePolicy {
+        Block,        // 生产者等待空位
+        DropOldest    // 丢弃最旧的元素（只关心最新结果的阶段）
+    };
+
+    // 有界阻塞队列，用于流水线阶段之间传递数据。
+    // 槽位在构造时一次分配，入队出队不再分配堆内存；RetainSlots 含义同 CircularBuffer，
+    // 经 pushSwap/popSwap 轮转缓冲的队列须指定 true，否则换回槽位的对象在出队时即被释放
+    template<typename T, bool RetainSlots = std::is_trivially_destructible_v<T>>
+    class BoundedQueue {
+    private:
+        CircularBuffer<T, RetainSlots> _items;
+        size_t _capacity;
+        QueuePolicy _policy;
+        bool _closed = false;
+        std::atomic<uint64_t> _dropped{ 0 };
+        mutable std::mutex _mutex;
+        std::condition_variable _notEmpty;
+        std::condition_variable _notFull;
+
+    public:
+        explicit BoundedQueue(size_t capacity, QueuePolicy policy = QueuePolicy::Block) :
+            _items(capacity > 0 ? capacity : 1), _capacity(capacity > 0 ? capacity : 1), _policy(policy) {}
+
+        BoundedQueue(const BoundedQueue&) = delete;
+        BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+        // 入队，队列已关闭时返回 false
+        bool push(T value) {
+            return exchange(value, false);
+        }
+
+        // 入队并与槽位交换：value 换回槽位中的旧对象（例如已分配好的缓冲），生产者可直接复用
+        bool pushSwap(T& value) {
+            return exchange(value, true);
+        }
+
+        // 出队，队列为空时等待；已关闭且为空时返回 false
+        bool pop(T& out) {
+            return take(out, false);
+        }
+
+        // 出队并与槽位交换：out 原有的对象留在槽位中，之后经 pushSwap 回到生产者
+        bool popSwap(T& out) {
+            return take(out, true);
+        }
+
+        // 关闭队列：不再接受新元素，已有元素仍可取出，取空后槽位随出队释放
+        void close() {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _closed = true;
+            }
+            _notEmpty.notify_all();
+            _notFull.notify_all();
+        }
+
+        // 重新打开并清空
+        void reopen() {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _items.clear();
+            _closed = false;
+        }
+
+        [[nodiscard]] size_t size() const {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _items.size();
+        }
+
+        [[nodiscard]] uint64_t getDropped() const { return _dropped.load(std::memory_order_relaxed); }
+
+    private:
+        bool exchange(T& value, bool swap) {
+            std::unique_lock<std::mutex> lock(_mutex);
+            if (_policy == QueuePolicy::Block) {
+                _notFull.wait(lock, [this] { return _closed || _items.size() < _capacity; });
+            }
+            // 已关闭时拒绝入队，也不能为此丢弃队列中尚未取出的元素
+            if (_closed) {
+                return false;
+            }
+            if (_items.size() >= _capacity) {
+                _items.pop_front();
+                _dropped.fetch_add(1, std::memory_order_relaxed);
+            }
+            if (swap) {
+                std::swap(_items.emplace_back(), value);
+            } else {
+                _items.emplace_back() = std::move(value);
+            }
+            lock.unlock();
+            _notEmpty.notify_one();
+            return true;
+        }
+
+        bool take(T& out, bool swap) {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _notEmpty.wait(lock, [this] { return _closed || !_items.empty(); });
+            if (_items.empty()) {
+                return false;
+            }
+            if (swap) {
+                std::swap(out, _items.front());
+            } else {
+                out = std::move(_items.front());
+            }
+            _items.pop_front();
+            lock.unlock();
+            _notFull.notify_one();
+            return true;
+        }
+    };
+
+} // namespace kfc
+
+#endif // KF_CORE_QUEUE_H
@@ -0,0 +1,44 @@
+#ifndef KF_CORE_REPLAY_H
+#define KF_CORE_REPLAY_H
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "core/ring.h"
+#include "calc/serialize.h"
+
+namespace kfc {
+
+    constexpr size_t kBodyRingCapacity = 256;   // 约 8 秒的单人 30Hz 骨骼帧
+
+    // 采集端与各消费者之间的骨骼帧环形缓冲
+    using BodyFrameRing = FrameRing<BodyFrame, kBodyRingCapacity>;
+
+    // 回放源：把录制的 .dat 文件当作采集端推入环形缓冲，无需 Kinect 即可驱动消费者
+    class ReplaySource {
+    private:
+        std::vector<FrameData> _frames;   // 录制的帧
+        float _speed;                     // 回放倍速，<= 0 表示尽快推送
+
+    public:
+        explicit ReplaySource(float speed = 1.0f) : _speed(speed) {}
+
+        // 读取录制文件
+        bool open(const std::string& filename);
+
+        // 推送全部帧，直到结束或 stop 被置位，返回写入的帧数
+        // 遇到 Backpressure 时等待消费者追上，保证每一帧都被送达；每写入一帧调用 onPublish
+        size_t run(BodyFrameRing& ring, const std::atomic<bool>& stop,
+                   const std::function<void()>& onPublish = nullptr) const;
+
+        // 按录制节奏把每一帧交给 sink（例如发往评分服务），sink 返回 false 时停止，返回送出的帧数
+        size_t run(const std::atomic<bool>& stop, const std::function<bool(const BodyFrame&)>& sink) const;
+
+        [[nodiscard]] inline size_t size() const { return _frames.size(); }
+    };
+
+} // namespace kfc
+
+#endif // KF_CORE_REPLAY_H
@@ -0,0 +1,140 @@
+#ifndef KF_CORE_RING_H
+#define KF_CORE_RING_H
+
+#include <atomic>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace kfc {
+
+    // 消费者策略
+    enum class RingPolicy {
+        Overwrite,      // 落后超过容量时只有该消费者跳过旧帧（渲染、评分、录制）
+        Backpressure    // 未读帧不允许被覆盖，满时生产者丢弃新帧，所有消费者都会缺帧（离线回放）
+    };
+
+    // 单生产者、多游标广播环形缓冲
+    // 生产者无等待：push 只做有限步操作，从不阻塞；每个消费者持有独立的读游标。
+    // 槽位使用序号（seqlock）校验，Overwrite 消费者可以安全地检测到被覆盖的槽位。
+    template<typename T, size_t Capacity, size_t MaxConsumers = 4>
+    class FrameRing {
+        static_assert(std::is_trivially_copyable<T>::value, "FrameRing requires trivially copyable T");
+        static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+    public:
+        // 消费者游标
+        struct Cursor {
+            std::atomic<uint64_t> position{ 0 };   // 下一个待读取的序号
+            std::atomic<uint64_t> dropped{ 0 };    // 因被覆盖而跳过的帧数
+            RingPolicy policy = RingPolicy::Overwrite;
+            std::atomic<bool> active{ false };     // 生产者据此跳过未登记的游标
+        };
+
+        FrameRing() = default;
+        FrameRing(const FrameRing&) = delete;
+        FrameRing& operator=(const FrameRing&) = delete;
+
+        // 注册消费者，从当前写入位置开始读取；超出 MaxConsumers 时返回 nullptr。
+        // 生产者运行期间也可调用，但 subscribe / unsubscribe 之间须由调用方串行化
+        Cursor* subscribe(RingPolicy policy) {
+            for (auto& cursor : _cursors) {
+                if (!cursor.active.load(std::memory_order_acquire)) {
+                    cursor.policy = policy;
+                    cursor.position.store(_head.load(std::memory_order_acquire), std::memory_order_relaxed);
+                    cursor.dropped.store(0, std::memory_order_relaxed);
+                    cursor.active.store(true, std::memory_order_release);   // 字段就绪后才对生产者可见
+                    return &cursor;
+                }
+            }
+            return nullptr;
+        }
+
+        // 注销消费者，之后生产者不再因该游标丢帧；调用后不得再用该游标读取
+        void unsubscribe(Cursor& cursor) {
+            cursor.active.store(false, std::memory_order_release);
+        }
+
+        // 生产者写入一帧；有 Backpressure 消费者已满时丢弃并返回 false
+        bool push(const T& value) {
+            const uint64_t head = _head.load(std::memory_order_relaxed);
+
+            for (const auto& cursor : _cursors) {
+                if (cursor.active.load(std::memory_order_acquire) && cursor.policy == RingPolicy::Backpressure &&
+                    head - cursor.position.load(std::memory_order_acquire) >= Capacity) {
+                    _rejected.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+            }
+
+            Slot& slot = _slots[head & (Capacity - 1)];
+            slot.version.store(head * 2 + 1, std::memory_order_relaxed);   // 奇数：写入中
+            std::atomic_thread_fence(std::memory_order_release);
+            std::memcpy(&slot.value, &value, sizeof(T));
+            slot.version.store(head * 2 + 2, std::memory_order_release);   // 偶数：序号 head 已就绪
+            _head.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        // 消费者读取下一帧，无新帧时返回 false
+        bool pop(Cursor& cursor, T& out) {
+            uint64_t pos = cursor.position.load(std::memory_order_relaxed);
+
+            for (;;) {
+                const uint64_t head = _head.load(std::memory_order_acquire);
+                if (pos >= head) {
+                    cursor.position.store(pos, std::memory_order_release);
+                    return false;
+                }
+
+                // 落后超过一圈：跳到仍然有效的最旧一帧
+                if (head - pos > Capacity) {
+                    cursor.dropped.fetch_add(head - Capacity - pos, std::memory_order_relaxed);
+                    pos = head - Capacity;
+                }
+
+                const Slot& slot = _slots[pos & (Capacity - 1)];
+                const uint64_t expected = pos * 2 + 2;
+                const uint64_t before = slot.version.load(std::memory_order_acquire);
+                if (before == expected) {
+                    std::memcpy(&out, &slot.value, sizeof(T));
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    if (slot.version.load(std::memory_order_relaxed) == expected) {
+                        cursor.position.store(pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+
+                // 读取期间被覆盖，跳过该帧
+                cursor.dropped.fetch_add(1, std::memory_order_relaxed);
+                ++pos;
+            }
+        }
+
+        // 游标之后尚未读取的帧数（可能包含已被覆盖的帧）
+        [[nodiscard]] uint64_t available(const Cursor& cursor) const {
+            return _head.load(std::memory_order_acquire) - cursor.position.load(std::memory_order_relaxed);
+        }
+
+        // 已写入的帧总数
+        [[nodiscard]] uint64_t getWritten() const { return _head.load(std::memory_order_acquire); }
+
+        // 因 Backpressure 被生产者丢弃的帧数
+        [[nodiscard]] uint64_t getRejected() const { return _rejected.load(std::memory_order_relaxed); }
+
+    private:
+        struct Slot {
+            std::atomic<uint64_t> version{ 0 };
+            T value;
+        };
+
+        alignas(64) std::atomic<uint64_t> _head{ 0 };
+        alignas(64) std::atomic<uint64_t> _rejected{ 0 };
+        std::array<Cursor, MaxConsumers> _cursors;
+        std::array<Slot, Capacity> _slots;
+    };
+
+} // namespace kfc
+
+#endif // KF_CORE_RING_H
@@ -0,0 +1,166 @@
+#ifndef KF_CORE_SCHEDULER_H
+#define KF_CORE_SCHEDULER_H
+
+#define NOMINMAX
+#include <Windows.h>
+#include <array>
+#include <atomic>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+#include <condition_variable>
+
+#include "core/circular.h"
+
+namespace kfc {
+
+    // 任务优先级，数值越小越先执行
+    enum class TaskPriority {
+        Realtime = 0,   // 实时评分及其内部的并行循环
+        Loading,        // 标准动作加载
+        Batch,          // 离线批量任务（golden 录制等）
+        Count
+    };
+
+    // 进程共享的工作窃取线程池，线程数等于硬件线程数。
+    // 每个工作线程按优先级各有一个双端队列：自己从尾部取（后进先出，缓存友好），
+    // 空闲线程从其他线程的头部窃取；外部线程提交的任务进入共享队列。
+    // 取任务时总是先看高优先级，实时评分不会排在模板加载或批量任务之后。
+    // parallelFor 的调用方自己也参与计算，可在任务内部嵌套使用。等待期间只回收本次提交、
+    // 尚未被其他线程取走的帮助任务，不执行无关任务：调用方可能持有锁，执行其他任务会重入同一把锁
+    class TaskScheduler {
+    public:
+        [[nodiscard]] static inline TaskScheduler& getInstance() {
+            static TaskScheduler instance;
+            return instance;
+        }
+
+        // 提交一个任务，返回其结果；任务对象在堆上，适合加载等低频调用
+        template<typename F>
+        auto submit(TaskPriority priority, F&& f) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+            using Result = std::invoke_result_t<std::decay_t<F>>;
+            auto* task = new std::packaged_task<Result()>(std::forward<F>(f));
+            auto future = task->get_future();
+            post(priority, Task{ [](void* context) {
+                std::unique_ptr<std::packaged_task<Result()>> owned(static_cast<std::packaged_task<Result()>*>(context));
+                (*owned)();
+            }, task });
+            return future;
+        }
+
+        // 把 [begin, end) 按 grain 切块并行执行 body(chunkBegin, chunkEnd)，全部完成后返回。
+        // 任务描述放在调用方栈上，队列预热后不分配堆内存，可用于评分热路径
+        template<typename Body>
+        void parallelFor(size_t begin, size_t end, size_t grain, const Body& body,
+                         TaskPriority priority = TaskPriority::Realtime) {
+            if (begin >= end) {
+                return;
+            }
+            grain = std::max<size_t>(1, grain);
+            const size_t chunks = (end - begin + grain - 1) / grain;
+            if (chunks == 1) {
+                body(begin, end);
+                return;
+            }
+
+            ParallelRange<Body> range(begin, end, grain, body);
+            const size_t helpers = std::min(chunks - 1, _workers.size());
+            range.pending.store(helpers, std::memory_order_relaxed);
+            for (size_t i = 0; i < helpers; ++i) {
+                post(priority, Task{ &ParallelRange<Body>::runHelper, &range });
+            }
+            range.run();
+            wait(range.pending, &range, priority);
+        }
+
+        [[nodiscard]] inline size_t getWorkerCount() const { return _workers.size(); }
+
+    private:
+        // 队列中的任务：函数指针与上下文，拷贝不分配
+        struct Task {
+            void (*run)(void* context);
+            void* context;
+        };
+
+        // 一次 parallelFor：各线程用 next 原子地领取下一块
+        template<typename Body>
+        struct ParallelRange {
+            std::atomic<size_t> next;
+            size_t end;
+            size_t grain;
+            const Body& body;
+            std::atomic<size_t> pending{ 0 };   // 尚未结束的帮助任务
+
+            ParallelRange(size_t begin, size_t end, size_t grain, const Body& body) :
+                next(begin), end(end), grain(grain), body(body) {}
+
+            void run() {
+                for (;;) {
+                    const size_t chunkBegin = next.fetch_add(grain, std::memory_order_relaxed);
+                    if (chunkBegin >= end) {
+                        return;
+                    }
+                    body(chunkBegin, std::min(end, chunkBegin + grain));
+                }
+            }
+
+            static void runHelper(void* context) {
+                auto* range = static_cast<ParallelRange*>(context);
+                range->run();
+                if (range->pending.fetch_sub(1) == 1) {   // 此后不能再访问 range
+                    TaskScheduler::getInstance().notifyDone();
+                }
+            }
+        };
+
+        // 单个工作线程的队列
+        struct Worker {
+            std::mutex mutex;
+            std::array<CircularBuffer<Task>, static_cast<size_t>(TaskPriority::Count)> queues;
+            std::thread thread;
+        };
+
+        TaskScheduler();
+        ~TaskScheduler();
+        TaskScheduler(const TaskScheduler&) = delete;
+        TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+        void post(TaskPriority priority, const Task& task);
+
+        // 按优先级取一个不低于 maxPriority 的任务：本线程队列尾部 → 共享队列 → 窃取其他线程队列头部
+        bool findTask(TaskPriority maxPriority, Task& task);
+
+        // 从本线程提交任务的队列中取出全部上下文为 context 的任务，返回取出的个数（其余已被其他线程取走）
+        size_t takeOwnTasks(TaskPriority priority, const void* context, Task& task);
+
+        // 等待 pending 归零。调用方已领取完全部块，仍在队列中的帮助任务直接取回执行（立即结束），
+        // 已被其他线程取走的先短暂自旋等待，仍未结束则阻塞到最后一个帮助任务通知；不执行其他任务
+        void wait(const std::atomic<size_t>& pending, const void* context, TaskPriority priority);
+
+        // 某次 parallelFor 的最后一个帮助任务结束时调用，唤醒阻塞在 wait 中的调用方
+        void notifyDone();
+
+        void workerLoop(size_t index);
+
+        std::vector<std::unique_ptr<Worker>> _workers;
+        std::mutex _sharedMutex;
+        std::array<CircularBuffer<Task>, static_cast<size_t>(TaskPriority::Count)> _shared;   // 外部线程提交的任务
+
+        std::atomic<size_t> _queued;     // 所有队列中的任务数
+        std::mutex _sleepMutex;
+        std::condition_variable _wake;
+        std::atomic<bool> _running;
+
+        // parallelFor 调用方的阻塞等待；通知不区分是哪一次 parallelFor，被唤醒后各自检查 pending
+        std::atomic<size_t> _doneWaiters;
+        std::mutex _doneMutex;
+        std::condition_variable _done;
+    };
+
+} // namespace kfc
+
+#endif // KF_CORE_SCHEDULER_H
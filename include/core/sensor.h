@@ -0,0 +1,60 @@
+#ifndef KF_CORE_SENSOR_H
+#define KF_CORE_SENSOR_H
+
+#define NOMINMAX
+#include <Windows.h>
+#include <Kinect.h>
+#include <atomic>
+#include <thread>
+#include <functional>
+
+#include "core/replay.h"
+
+namespace kfc {
+
+    // 接收一帧传感器数据中所有被跟踪的身体，没有人时 count 为 0
+    using BodySink = std::function<void(INT64 timestamp, const BodyFrame* bodies, int count)>;
+
+    // Kinect 骨骼采集源：在独立线程等待骨骼帧到达事件，把被跟踪的身体写入环形缓冲，
+    // 采集节奏只取决于传感器，与界面消息循环无关
+    class KinectBodySource {
+    private:
+        IBodyFrameReader* _reader;               // 骨骼帧读取器
+        WAITABLE_HANDLE _frameEvent;             // 帧到达事件
+        std::thread _thread;                     // 采集线程
+        std::atomic<bool> _running;              // 运行标志
+        std::atomic<INT64> _lastFrameTime;       // 最近一帧骨骼的传感器时间戳
+
+        void run(BodySink sink);
+
+    public:
+        KinectBodySource();
+        ~KinectBodySource();
+
+        KinectBodySource(const KinectBodySource&) = delete;
+        KinectBodySource& operator=(const KinectBodySource&) = delete;
+
+        // 从已打开的传感器创建骨骼帧读取器
+        HRESULT open(IKinectSensor* sensor);
+
+        // 启动采集线程；每写入一帧调用 onPublish
+        bool start(BodyFrameRing& ring, std::function<void()> onPublish = nullptr);
+
+        // 启动采集线程，每个传感器帧整体交给 sink（例如发布到共享内存）
+        bool start(BodySink sink);
+
+        // 停止采集线程
+        void stop();
+
+        // 释放读取器（须在传感器关闭前调用）
+        void close();
+
+        [[nodiscard]] inline bool isOpen() const { return _reader != nullptr; }
+
+        // 最近一帧骨骼（无论是否有人）的传感器时间戳
+        [[nodiscard]] inline INT64 getLastFrameTime() const { return _lastFrameTime.load(std::memory_order_acquire); }
+    };
+
+} // namespace kfc
+
+#endif // KF_CORE_SENSOR_H
@@ -0,0 +1,76 @@
+#ifndef KF_CORE_SERVER_H
+#define KF_CORE_SERVER_H
+
+#define NOMINMAX
+#include <Windows.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/queue.h"
+#include "core/governor.h"
+#include "calc/serialize.h"
+
+namespace kfc {
+
+    // 多会话评分服务：每个采集站一条 TCP 连接，各自拥有独立的 ScoringSession。
+    // 每条连接一个读线程负责收帧、特征提取与重复计数，DTW 评分交给共享的工作线程池；
+    // 同一会话同时至多一个评分任务，评分忙时旧快照被新快照替换。
+    // 在线会话数受 server.maxSessions 限制，握手与空闲连接有接收超时
+    class ScoringServer {
+    public:
+        ScoringServer();
+        ~ScoringServer();
+
+        ScoringServer(const ScoringServer&) = delete;
+        ScoringServer& operator=(const ScoringServer&) = delete;
+
+        // 在 host（IPv4 地址，"0.0.0.0" 表示所有接口）的 port 上监听，workers 为 0 时取硬件线程数
+        bool start(const std::string& host, uint16_t port, size_t workers);
+
+        // 断开全部连接并停止线程
+        void stop();
+
+        [[nodiscard]] size_t getSessionCount() const;
+
+    private:
+        struct Connection;
+
+        void acceptLoop();
+        void readLoop(std::shared_ptr<Connection> connection);
+        void workerLoop();
+
+        // 在工作线程上执行会话的一个评分任务，还有待处理任务时返回 true
+        bool runScore(Connection& connection);
+
+        // 输出会话总结并回复 Stats
+        void finishSession(Connection& connection, bool reply);
+
+        // 回收已结束的连接，all 为 true 时等待全部连接结束
+        void reap(bool all);
+
+        uintptr_t _listenSocket;
+        std::unique_ptr<ActionTemplate> _template;   // 服务端自己的模板副本，评分时只读、无需加锁
+
+        std::thread _acceptThread;
+        std::vector<std::thread> _workers;
+        BoundedQueue<std::shared_ptr<Connection>> _ready;   // 有待处理评分任务的会话
+        // 全部会话共用一个等级：延迟主要来自工作线程池的排队，反映的是整体负载而不是单个会话，
+        // 降级同时作用于所有会话；某个会话的得分因此可能受其他会话负载影响
+        QualityGovernor _governor;
+        size_t _maxSessions;                                // 同时在线的会话上限，不超过 _ready 的容量
+
+        mutable std::mutex _connectionsMutex;
+        std::vector<std::shared_ptr<Connection>> _connections;
+
+        std::atomic<bool> _running;
+        std::atomic<uint32_t> _nextSessionId;
+    };
+
+} // namespace kfc
+
+#endif // KF_CORE_SERVER_H
@@ -0,0 +1,133 @@
+#ifndef KF_CORE_SHM_H
+#define KF_CORE_SHM_H
+
+#define NOMINMAX
+#include <Windows.h>
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include "calc/serialize.h"
+
+namespace kfc {
+
+    constexpr uint32_t kSharedRingMagic = 0x5253464B;   // "KFSR"
+    constexpr uint32_t kSharedRingVersion = 1;
+    constexpr uint32_t kSharedRingCapacity = 64;        // 约 2 秒的 30Hz 传感器帧
+    constexpr uint32_t kSharedRingMaxReaders = 8;
+    constexpr const char* kDefaultSharedRingName = "KinectFitness.Skeleton";
+
+    static_assert((kSharedRingCapacity & (kSharedRingCapacity - 1)) == 0, "Capacity must be a power of two");
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "Shared ring requires lock-free 64-bit atomics");
+
+    // 一帧传感器数据：同一时刻所有被跟踪的身体（没有人时 bodyCount 为 0，仍然发布以表明采集进程存活）
+    struct SharedBodySlot {
+        std::atomic<uint64_t> version;     // seqlock：奇数表示写入中，序号 n 就绪后为 2n+2
+        INT64 timestamp;                   // 传感器时间戳
+        INT64 publishTick;                 // 发布时刻（QPC ticks，跨进程一致）
+        uint32_t bodyCount;
+        uint32_t reserved;
+        BodyFrame bodies[BODY_COUNT];
+    };
+
+    // 消费者登记：用于唤醒与观测，不参与背压——采集进程从不等待评分进程
+    struct SharedRingReaderSlot {
+        std::atomic<uint32_t> state;       // 0 空闲，1 占用
+        std::atomic<uint32_t> processId;
+        std::atomic<uint64_t> position;    // 下一个待读取的序号
+    };
+
+    // 共享内存起始处的头部，之后紧跟 kSharedRingCapacity 个槽位
+    struct alignas(64) SharedRingHeader {
+        std::atomic<uint32_t> magic;       // 初始化完成后最后写入
+        uint32_t version;
+        uint32_t capacity;
+        uint32_t slotSize;
+        std::atomic<uint32_t> publisherPid;      // 0 表示当前没有采集进程
+        std::atomic<uint32_t> publisherEpoch;    // 采集进程每次（重新）接管加 1
+        alignas(64) std::atomic<uint64_t> head;  // 已发布的帧数
+        std::atomic<int64_t> heartbeatTick;      // 最近一次发布的时刻
+        alignas(64) SharedRingReaderSlot readers[kSharedRingMaxReaders];
+    };
+
+    // 采集进程一侧：创建（或接管）命名共享内存并发布传感器帧。
+    // 采集进程崩溃后重启会接着原有序号写入，评分进程无需重新连接
+    class SharedBodyRingWriter {
+    public:
+        SharedBodyRingWriter();
+        ~SharedBodyRingWriter();
+
+        SharedBodyRingWriter(const SharedBodyRingWriter&) = delete;
+        SharedBodyRingWriter& operator=(const SharedBodyRingWriter&) = delete;
+
+        // 已有存活的采集进程时返回 false
+        bool create(const std::string& name = kDefaultSharedRingName);
+
+        // 发布一帧，count 超过 BODY_COUNT 的部分被截断；发布后唤醒所有登记的消费者
+        void publish(INT64 timestamp, const BodyFrame* bodies, int count);
+
+        void close();
+
+        [[nodiscard]] inline bool isOpen() const { return _header != nullptr; }
+        [[nodiscard]] uint64_t getPublished() const;
+
+    private:
+        // 持有采集进程互斥量时执行的创建与接管
+        bool createLocked(const std::string& name);
+        void signalReaders();
+
+        std::string _name;
+        HANDLE _mapping;
+        SharedRingHeader* _header;
+        SharedBodySlot* _slots;
+        HANDLE _readerEvents[kSharedRingMaxReaders];   // 按需打开的消费者唤醒事件
+    };
+
+    // 评分进程一侧：打开共享内存并登记为消费者，以零拷贝方式读取槽位。
+    // 落后超过一圈时跳到最旧的有效帧，跳过的帧数计入 getDropped
+    class SharedBodyRingReader {
+    public:
+        SharedBodyRingReader();
+        ~SharedBodyRingReader();
+
+        SharedBodyRingReader(const SharedBodyRingReader&) = delete;
+        SharedBodyRingReader& operator=(const SharedBodyRingReader&) = delete;
+
+        // 共享内存尚未创建或消费者已满时返回 false，可稍后重试
+        bool open(const std::string& name = kDefaultSharedRingName);
+
+        void close();
+
+        // 取下一帧的只读视图（直接指向共享内存），无新帧时返回 nullptr
+        const SharedBodySlot* peek();
+
+        // 确认 peek 得到的视图在读取期间未被覆盖并前进游标；返回 false 时应丢弃本次读取的结果
+        bool release();
+
+        // 等待新帧发布，超时返回 false
+        bool wait(DWORD timeoutMs);
+
+        // 采集进程仍在运行（进程存在且未主动关闭）
+        [[nodiscard]] bool isPublisherAlive() const;
+
+        // 距离最近一次发布的毫秒数
+        [[nodiscard]] double getPublisherIdleMs() const;
+
+        [[nodiscard]] inline bool isOpen() const { return _header != nullptr; }
+        [[nodiscard]] inline uint64_t getDropped() const { return _dropped; }
+        [[nodiscard]] inline uint32_t getReaderIndex() const { return _index; }
+
+    private:
+        HANDLE _mapping;
+        HANDLE _event;
+        SharedRingHeader* _header;
+        const SharedBodySlot* _slots;
+        uint32_t _index;           // 登记的消费者槽位
+        uint64_t _position;        // 下一个待读取的序号
+        uint64_t _pending;         // peek 返回的视图对应的序号
+        uint64_t _dropped;
+    };
+
+} // namespace kfc
+
+#endif // KF_CORE_SHM_H
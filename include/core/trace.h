@@ -0,0 +1,146 @@
+#ifndef KF_CORE_TRACE_H
+#define KF_CORE_TRACE_H
+
+#define NOMINMAX
+#include <Windows.h>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fstream>
+#include <cstdint>
+#include <condition_variable>
+
+#include "core/utils.h"
+
+namespace kfc {
+
+    // 一个完整跨度（Chrome trace 的 "X" 事件）
+    struct TraceEvent {
+        const char* name;       // 跨度名，必须是字符串字面量
+        const char* argName;    // 可选参数名，nullptr 表示无参数
+        int64_t argValue;
+        INT64 begin;            // QPC ticks
+        INT64 end;
+    };
+
+    // 每线程事件缓冲：所属线程写入、后台线程读出的单生产者单消费者环形队列
+    struct TraceBuffer {
+        static constexpr size_t kCapacity = 16384;
+
+        std::array<TraceEvent, kCapacity> events;
+        std::atomic<uint64_t> head{ 0 };       // 所属线程写入位置
+        std::atomic<uint64_t> tail{ 0 };       // 后台线程读取位置
+        std::atomic<uint64_t> dropped{ 0 };    // 缓冲满时丢弃的事件数
+        DWORD threadId = 0;
+        std::string threadName;                // 由注册表互斥锁保护
+        bool nameWritten = false;
+    };
+
+    struct TraceThreadState;    // 每线程的名字与缓冲，定义见 trace.cpp
+
+    // Chrome trace-event 记录器：各线程无锁写入自己的缓冲，后台线程定期写成 JSON，
+    // 生成的文件可直接用 Perfetto 或 chrome://tracing 打开
+    class Tracer {
+    public:
+        [[nodiscard]] static inline Tracer& getInstance() {
+            static Tracer instance;
+            return instance;
+        }
+
+        // 开始记录到 path，已在记录时返回 false
+        bool start(const std::string& path);
+
+        // 停止记录，写出剩余事件并关闭文件
+        void stop();
+
+        [[nodiscard]] inline bool isEnabled() const { return _enabled.load(std::memory_order_relaxed); }
+
+        void record(const char* name, INT64 begin, INT64 end, const char* argName = nullptr, int64_t argValue = 0);
+
+        // 设置当前线程在时间线上显示的名字，name 必须是字符串字面量。
+        // 只记下名字，不分配缓冲：缓冲在记录开启后该线程第一次写入事件时才创建
+        void setThreadName(const char* name);
+
+    private:
+        friend struct TraceThreadState;
+
+        Tracer();
+        ~Tracer();
+        Tracer(const Tracer&) = delete;
+        Tracer& operator=(const Tracer&) = delete;
+
+        TraceBuffer* threadBuffer();
+
+        // 取一个空闲且事件已全部写出的缓冲，没有时新建
+        TraceBuffer* acquireBuffer(const char* threadName);
+
+        // 线程退出时归还缓冲，剩余事件仍由后台线程写出
+        void releaseBuffer(TraceBuffer* buffer);
+        void flushLoop();
+        void flush();
+
+        std::atomic<bool> _enabled;
+        INT64 _startTick;
+        DWORD _processId;
+
+        std::mutex _registryMutex;                         // 保护 _buffers、_freeBuffers 与线程名
+        std::vector<std::unique_ptr<TraceBuffer>> _buffers;
+        std::vector<TraceBuffer*> _freeBuffers;            // 所属线程已退出、可复用的缓冲
+
+        std::mutex _fileMutex;                             // 保护 _file 与 _firstEvent
+        std::ofstream _file;
+        bool _firstEvent;
+
+        std::thread _flushThread;
+        std::mutex _flushMutex;
+        std::condition_variable _flushWake;
+        bool _flushRunning;
+    };
+
+    // 作用域跨度：记录未开启时只有一次原子读
+    class TraceScope {
+    public:
+        explicit TraceScope(const char* name, const char* argName = nullptr, int64_t argValue = 0) :
+            _name(name),
+            _argName(argName),
+            _argValue(argValue),
+            _begin(Tracer::getInstance().isEnabled() ? QueryTicks() : 0) {}
+
+        ~TraceScope() {
+            if (_begin != 0) {
+                Tracer::getInstance().record(_name, _begin, QueryTicks(), _argName, _argValue);
+            }
+        }
+
+        TraceScope(const TraceScope&) = delete;
+        TraceScope& operator=(const TraceScope&) = delete;
+
+    private:
+        const char* _name;
+        const char* _argName;
+        int64_t _argValue;
+        INT64 _begin;
+    };
+
+    // 加锁，并把等待锁的时间记为一个跨度，用于观察锁竞争
+    template<typename Mutex>
+    inline std::unique_lock<Mutex> LockTraced(Mutex& mutex, const char* name) {
+        TraceScope scope(name);
+        return std::unique_lock<Mutex>(mutex);
+    }
+
+} // namespace kfc
+
+#define KF_TRACE_CONCAT_IMPL(a, b) a##b
+#define KF_TRACE_CONCAT(a, b) KF_TRACE_CONCAT_IMPL(a, b)
+
+// 记录当前作用域为一个跨度
+#define KF_TRACE_SCOPE(name) ::kfc::TraceScope KF_TRACE_CONCAT(_traceScope, __LINE__)(name)
+#define KF_TRACE_SCOPE_ARG(name, argName, argValue) \
+    ::kfc::TraceScope KF_TRACE_CONCAT(_traceScope, __LINE__)(name, argName, static_cast<int64_t>(argValue))
+
+#endif // KF_CORE_TRACE_H
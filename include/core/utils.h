@@ -29,6 +29,24 @@ inline void SafeRelease(Interface *& pInterfaceToRelease)
     }
 }
 
+// 高精度计时（QPC ticks），用于流水线各阶段的延迟统计
+inline INT64 QueryTicks()
+{
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return counter.QuadPart;
+}
+
+inline double TicksToMicroseconds(INT64 ticks)
+{
+    static const double frequency = [] {
+        LARGE_INTEGER freq;
+        QueryPerformanceFrequency(&freq);
+        return static_cast<double>(freq.QuadPart);
+    }();
+    return static_cast<double>(ticks) * 1000000.0 / frequency;
+}
+
 } // namespace kfc
 
 #endif // KF_CORE_UTILS_H 
\ No newline at end of file
@@ -5,13 +5,27 @@
 #ifndef KF_LOG_LOGGER_H
 #define KF_LOG_LOGGER_H
 
-#define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_TRACE
+// 编译期日志级别：低于该级别的日志点直接编译为空，参数也不会求值
+// 调试构建保留全部日志，发布构建默认只保留 info 及以上
+#ifndef KF_LOG_ACTIVE_LEVEL
+#ifdef NDEBUG
+#define KF_LOG_ACTIVE_LEVEL SPDLOG_LEVEL_INFO
+#else
+#define KF_LOG_ACTIVE_LEVEL SPDLOG_LEVEL_TRACE
+#endif
+#endif
+
+#define SPDLOG_ACTIVE_LEVEL KF_LOG_ACTIVE_LEVEL
 
 #include <cassert>
 #include <memory>
+#include <string>
+#include <atomic>
 #include "spdlog/spdlog.h"
 #include "spdlog/common.h"
 
+#include "log/record.h"
+
 namespace kfc {
 
     class Logger {
@@ -22,6 +36,12 @@ namespace kfc {
 
         static void Init();
 
+        // 输出热路径日志队列中剩余的记录
+        static void Shutdown();
+
+        // 运行时日志级别（trace/debug/info/warn/error），不能低于编译期级别
+        static void SetLevel(const std::string& level);
+
         static spdlog::logger* GetLoggerInstance() {
             assert(sLoggerInstance && "Logger instance is null, have not execute Logger::Init().");
             return sLoggerInstance.get();
@@ -37,6 +57,57 @@ namespace kfc {
 #define LOG_W(...)  SPDLOG_LOGGER_WARN(kfc::Logger::GetLoggerInstance(), __VA_ARGS__)
 #define LOG_E(...) SPDLOG_LOGGER_ERROR(kfc::Logger::GetLoggerInstance(), __VA_ARGS__)
 
+// 热路径日志：调用线程只记录格式串和数值参数，格式化在后台线程完成
+// 格式串必须是字符串字面量，参数只能是数值、枚举或字符串字面量
+#define KF_LOG_FAST(level, ...) \
+    do { \
+        if (kfc::Logger::GetLoggerInstance()->should_log(level)) { \
+            kfc::LogRecorder::getInstance().push(level, __FILE__, __LINE__, __VA_ARGS__); \
+        } \
+    } while (0)
+
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_TRACE
+#define LOG_FAST_T(...) KF_LOG_FAST(spdlog::level::trace, __VA_ARGS__)
+#else
+#define LOG_FAST_T(...) (void)0
+#endif
+
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_DEBUG
+#define LOG_FAST_D(...) KF_LOG_FAST(spdlog::level::debug, __VA_ARGS__)
+#else
+#define LOG_FAST_D(...) (void)0
+#endif
+
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_INFO
+#define LOG_FAST_I(...) KF_LOG_FAST(spdlog::level::info, __VA_ARGS__)
+#else
+#define LOG_FAST_I(...) (void)0
+#endif
+
+#define LOG_FAST_W(...) KF_LOG_FAST(spdlog::level::warn, __VA_ARGS__)
+
+// 采样：每个日志点每 n 次调用输出一次，例如 KF_LOG_EVERY_N(30, LOG_FAST_D, "...", x)
+#define KF_LOG_EVERY_N(n, logMacro, ...) \
+    do { \
+        static std::atomic<uint64_t> kfLogCounter{ 0 }; \
+        if (kfLogCounter.fetch_add(1, std::memory_order_relaxed) % (n) == 0) { \
+            logMacro(__VA_ARGS__); \
+        } \
+    } while (0)
+
+// 限流：每个日志点至多每 ms 毫秒输出一次，并报告期间被抑制的次数
+#define KF_LOG_EVERY_MS(ms, logMacro, ...) \
+    do { \
+        static kfc::LogRateLimiter kfLogLimiter(ms); \
+        uint64_t kfLogSuppressed = 0; \
+        if (kfLogLimiter.allow(kfLogSuppressed)) { \
+            logMacro(__VA_ARGS__); \
+            if (kfLogSuppressed > 0) { \
+                logMacro("({} similar messages suppressed)", kfLogSuppressed); \
+            } \
+        } \
+    } while (0)
+
 }
 
 #endif //KF_LOG_LOGGER_H
@@ -0,0 +1,139 @@
+#ifndef KF_LOG_RECORD_H
+#define KF_LOG_RECORD_H
+
+#include <array>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <cstdint>
+#include <type_traits>
+#include <condition_variable>
+
+#include "spdlog/common.h"
+
+namespace kfc {
+
+    constexpr size_t kMaxLogArgs = 8;             // 单条记录最多参数个数
+
+    // 日志参数：只保存数值或静态字符串，不做任何格式化
+    struct LogArg {
+        enum class Type : uint8_t { Int, UInt, Double, CStr };
+
+        Type type;
+        union {
+            int64_t i;
+            uint64_t u;
+            double d;
+            const char* s;   // 必须是字符串字面量或生命周期足够长的字符串
+        };
+    };
+
+    // 紧凑的二进制日志记录，由后台线程格式化
+    struct LogRecord {
+        spdlog::level::level_enum level;
+        const char* format;      // 格式串，必须是字符串字面量
+        const char* file;
+        int line;
+        uint8_t argc;
+        std::array<LogArg, kMaxLogArgs> args;
+    };
+
+    template<typename T>
+    inline LogArg MakeLogArg(T value) {
+        LogArg arg;
+        if constexpr (std::is_floating_point<T>::value) {
+            arg.type = LogArg::Type::Double;
+            arg.d = static_cast<double>(value);
+        } else if constexpr (std::is_enum<T>::value) {
+            arg.type = LogArg::Type::Int;
+            arg.i = static_cast<int64_t>(value);
+        } else if constexpr (std::is_integral<T>::value && std::is_signed<T>::value) {
+            arg.type = LogArg::Type::Int;
+            arg.i = static_cast<int64_t>(value);
+        } else if constexpr (std::is_integral<T>::value) {
+            arg.type = LogArg::Type::UInt;
+            arg.u = static_cast<uint64_t>(value);
+        } else {
+            static_assert(std::is_convertible<T, const char*>::value,
+                          "Fast log arguments must be numbers, enums or string literals");
+            arg.type = LogArg::Type::CStr;
+            arg.s = value;
+        }
+        return arg;
+    }
+
+    // 热路径日志记录器：调用线程只把参数写入无锁有界队列（多生产者单消费者），
+    // 字符串格式化和输出都在后台线程完成；队列满时丢弃并计数
+    class LogRecorder {
+    public:
+        static constexpr size_t kCapacity = 4096;
+
+        [[nodiscard]] static LogRecorder& getInstance();
+
+        template<typename... Args>
+        inline void push(spdlog::level::level_enum level, const char* file, int line,
+                         const char* format, const Args&... args) {
+            static_assert(sizeof...(Args) <= kMaxLogArgs, "Too many fast log arguments");
+            LogRecord record;
+            record.level = level;
+            record.format = format;
+            record.file = file;
+            record.line = line;
+            record.argc = static_cast<uint8_t>(sizeof...(Args));
+            size_t index = 0;
+            ((record.args[index++] = MakeLogArg(args)), ...);
+            (void)index;
+            enqueue(record);
+        }
+
+        void start();
+
+        // 停止后台线程并输出队列中剩余的记录
+        void stop();
+
+        [[nodiscard]] inline uint64_t getDropped() const { return _dropped.load(std::memory_order_relaxed); }
+
+    private:
+        LogRecorder();
+        ~LogRecorder();
+        LogRecorder(const LogRecorder&) = delete;
+        LogRecorder& operator=(const LogRecorder&) = delete;
+
+        void enqueue(const LogRecord& record);
+        bool dequeue(LogRecord& record);
+        void drain();
+        void run();
+
+        struct Cell {
+            std::atomic<size_t> sequence;
+            LogRecord record;
+        };
+
+        std::array<Cell, kCapacity> _cells;
+        alignas(64) std::atomic<size_t> _enqueuePos;
+        alignas(64) size_t _dequeuePos;
+        std::atomic<uint64_t> _dropped;
+
+        std::thread _thread;
+        std::mutex _mutex;
+        std::condition_variable _wake;
+        bool _running;
+    };
+
+    // 按时间限流：每个日志点至多每 intervalMs 毫秒输出一次
+    class LogRateLimiter {
+    public:
+        explicit LogRateLimiter(int intervalMs);
+
+        // 允许输出时返回 true，suppressed 为上次输出以来被抑制的次数
+        bool allow(uint64_t& suppressed);
+
+    private:
+        int64_t _intervalTicks;
+        std::atomic<int64_t> _next;
+        std::atomic<uint64_t> _suppressed;
+    };
+
+} // namespace kfc
+
+#endif // KF_LOG_RECORD_H
@@ -0,0 +1,91 @@
+#include <algorithm>
+#include <cmath>
+
+#include "calc/activity.h"
+
+namespace kfc {
+
+    float kineticEnergy(const KinematicsSample& sample) {
+        float sum = 0.0f;
+        int count = 0;
+        for (size_t i = 0; i < JointType_Count; ++i) {
+            if ((sample.velocityMask >> i) & 1u) {
+                sum += sample.velocity[i].squaredNorm();
+                ++count;
+            }
+        }
+        return count > 0 ? 0.5f * sum / static_cast<float>(count) : 0.0f;
+    }
+
+    // 按帧率把秒换算为样本数，至少 1 个
+    static size_t SecondsToSamples(float rate, float seconds) {
+        const float samplesPerSecond = rate > 0.0f ? rate : kActivityDefaultRate;
+        return std::max<size_t>(1, static_cast<size_t>(std::ceil(samplesPerSecond * seconds)));
+    }
+
+    ActivityDetector::ActivityDetector(float rate, float onsetEnergy, float offsetEnergy) :
+        _window(SecondsToSamples(rate, kActivityWindowSeconds)),
+        _hold(SecondsToSamples(rate, kActivityHoldSeconds)),
+        _quiet(0),
+        _energySum(0.0f),
+        _sinceResum(0),
+        _onsetEnergy(0.0f),
+        _offsetEnergy(0.0f),
+        _active(false),
+        _transitions(0) {
+        _energies.reserve(_window);
+        setThresholds(onsetEnergy, offsetEnergy);
+    }
+
+    ActivityTransition ActivityDetector::push(const KinematicsSample& sample) {
+        if (_energies.size() >= _window) {
+            _energySum -= _energies.front();
+            _energies.pop_front();
+        }
+        const float e = kineticEnergy(sample);
+        _energies.push_back(e);
+        _energySum += e;
+
+        // 浮点累加/相减的舍入误差会随会话时长累积，窗口整体更新一轮后按窗口内样本重算
+        if (++_sinceResum >= _window) {
+            _energySum = 0.0f;
+            for (const float value : _energies) {
+                _energySum += value;
+            }
+            _sinceResum = 0;
+        }
+
+        const float mean = energy();
+        if (!_active) {
+            if (mean >= _onsetEnergy) {
+                _active = true;
+                _quiet = 0;
+                ++_transitions;
+                return ActivityTransition::Onset;
+            }
+            return ActivityTransition::None;
+        }
+
+        _quiet = mean < _offsetEnergy ? _quiet + 1 : 0;
+        if (_quiet >= _hold) {
+            _active = false;
+            ++_transitions;
+            return ActivityTransition::Offset;
+        }
+        return ActivityTransition::None;
+    }
+
+    void ActivityDetector::setThresholds(float onsetEnergy, float offsetEnergy) {
+        _onsetEnergy = std::max(0.0f, onsetEnergy);
+        _offsetEnergy = std::min(std::max(0.0f, offsetEnergy), _onsetEnergy);
+    }
+
+    void ActivityDetector::reset() {
+        _energies.clear();
+        _energySum = 0.0f;
+        _sinceResum = 0;
+        _quiet = 0;
+        _active = false;
+    }
+
+} // namespace kfc
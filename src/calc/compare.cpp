@@ -1,9 +1,17 @@
 #include <Eigen/Dense>
+#include <algorithm>
+#include <array>
 #include <map>
+#include <vector>
 
 #include "calc/compare.h"
+#include "calc/resample.h"
+#include "calc/fastmath.h"
 #include "config/config.h"
 #include "core/common.h"
+#include "core/metrics.h"
+#include "core/trace.h"
+#include "core/scheduler.h"
 
 namespace kfc {
     // 定义关节权重映射
@@ -44,35 +52,41 @@ namespace kfc {
         {JointType_Neck, 1.8f}
     };
 
-    // 定义骨骼连接关系，用于计算相对角度
-    static const std::vector<std::pair<JointType, JointType>> boneConnections = {
-        // 躯干
-        {JointType_SpineBase, JointType_SpineMid},
-        {JointType_SpineMid, JointType_SpineShoulder},
-        {JointType_SpineShoulder, JointType_Neck},
-        {JointType_Neck, JointType_Head},
-        // 右臂
-        {JointType_SpineShoulder, JointType_ShoulderRight},
-        {JointType_ShoulderRight, JointType_ElbowRight},
-        {JointType_ElbowRight, JointType_WristRight},
-        {JointType_WristRight, JointType_HandRight},
-        // 左臂
-        {JointType_SpineShoulder, JointType_ShoulderLeft},
-        {JointType_ShoulderLeft, JointType_ElbowLeft},
-        {JointType_ElbowLeft, JointType_WristLeft},
-        {JointType_WristLeft, JointType_HandLeft}
-    };
-
-    // 内部工具函数
-    static const JointData* findJoint(const std::vector<JointData>& joints, JointType type) {
-        for (const auto& joint : joints) {
-            if (joint.type == type) {
-                return &joint;
+    // 按骨骼预先查表的高斯核带宽与权重，避免在逐格比较中查 map
+    static const std::array<float, kBoneCount> boneSigmas = [] {
+        std::array<float, kBoneCount> sigmas{};
+        for (size_t b = 0; b < kBoneCount; ++b) {
+            const JointType first = boneConnections[b].first;
+            float sigma = 0.8f;  // 默认带宽
+            if (first == JointType_SpineBase || first == JointType_SpineMid) {
+                sigma = 0.6f;  // 躯干部分使用更小的带宽，要求更精确
+            } else if (first == JointType_HandRight || first == JointType_HandLeft) {
+                sigma = 1.0f;  // 手部使用更大的带宽，允许更大的变化
             }
+            sigmas[b] = sigma;
         }
-        return nullptr;
-    }
+        return sigmas;
+    }();
+
+    // 高斯核指数中的 1/(2σ²)，逐格比较时只需一次乘法
+    static const std::array<float, kBoneCount> boneInvTwoSigmaSq = [] {
+        std::array<float, kBoneCount> factors{};
+        for (size_t b = 0; b < kBoneCount; ++b) {
+            factors[b] = 1.0f / (2.0f * boneSigmas[b] * boneSigmas[b]);
+        }
+        return factors;
+    }();
+
+    static const std::array<float, JointType_Count> jointWeightTable = [] {
+        std::array<float, JointType_Count> weights{};
+        for (size_t i = 0; i < JointType_Count; ++i) {
+            auto it = jointWeights.find(static_cast<JointType>(i));
+            weights[i] = it != jointWeights.end() ? it->second : 1.0f;
+        }
+        return weights;
+    }();
 
+    // 内部工具函数
     static float calculateJointDistance(const CameraSpacePoint& a, const CameraSpacePoint& b) {
         float dx = a.X - b.X;
         float dy = a.Y - b.Y;
@@ -113,64 +127,35 @@ namespace kfc {
         return std::sqrt(dx * dx + dy * dy + dz * dz) / timeInterval;
     }
 
-    float calculateSpeedPenalty(float speedRatio) {
-        const auto& config = Config::getInstance();
-
-        if (speedRatio < config.minSpeedRatio) {
+    float calculateSpeedPenalty(float speedRatio, const ScoringParams& params) {
+        if (speedRatio < params.minSpeedRatio) {
             // 速度太慢，使用平滑的惩罚函数
-            float factor = (speedRatio - config.minSpeedRatio) / config.minSpeedRatio;
+            float factor = speedRatio * params.invMinSpeedRatio - 1.0f;
             // 将惩罚值限制在 [minSpeedPenalty, 1.0] 范围内
-            return config.minSpeedPenalty + (1.0f - config.minSpeedPenalty) * 
-                   (1.0f + std::tanh(factor));  // 使用 tanh 实现平滑过渡
+            return params.minSpeedPenalty + params.speedPenaltyRange *
+                   (1.0f + (params.fastMath ? fastTanh(factor) : std::tanh(factor)));  // 使用 tanh 实现平滑过渡
         }
-        else if (speedRatio > config.maxSpeedRatio) {
+        else if (speedRatio > params.maxSpeedRatio) {
             // 速度太快，使用平滑的惩罚函数
-            float factor = (speedRatio - config.maxSpeedRatio) / config.maxSpeedRatio;
+            float factor = speedRatio * params.invMaxSpeedRatio - 1.0f;
             // 将惩罚值限制在 [minSpeedPenalty, 1.0] 范围内
-            return config.minSpeedPenalty + (1.0f - config.minSpeedPenalty) * 
-                   (1.0f - std::tanh(factor));  // 使用 tanh 实现平滑过渡
+            return params.minSpeedPenalty + params.speedPenaltyRange *
+                   (1.0f - (params.fastMath ? fastTanh(factor) : std::tanh(factor)));  // 使用 tanh 实现平滑过渡
         }
 
         return 1.0f;  // 速度在合理范围内，不惩罚
     }
 
-    static float calculateSpeedRatio(const FrameData& realFrame, const FrameData& templateFrame) {
-        // 计算关键关节的平均速度
-        const JointType targetJoints[] = {
-            JointType_ElbowRight, JointType_ElbowLeft,
-            JointType_WristRight, JointType_WristLeft
-        };
-
-        float realSpeed = 0.0f;
-        float templateSpeed = 0.0f;
-        int validCount = 0;
-
-        for (JointType type : targetJoints) {
-            const JointData* realJoint = findJoint(realFrame.joints, type);
-            const JointData* templateJoint = findJoint(templateFrame.joints, type);
-
-            if (realJoint && templateJoint &&
-                realJoint->trackingState == TrackingState_Tracked &&
-                templateJoint->trackingState == TrackingState_Tracked) {
-                realSpeed += std::sqrt(
-                    realJoint->position.X * realJoint->position.X +
-                    realJoint->position.Y * realJoint->position.Y +
-                    realJoint->position.Z * realJoint->position.Z
-                );
-                templateSpeed += std::sqrt(
-                    templateJoint->position.X * templateJoint->position.X +
-                    templateJoint->position.Y * templateJoint->position.Y +
-                    templateJoint->position.Z * templateJoint->position.Z
-                );
-                validCount++;
-            }
-        }
+    // 逐帧速度比：使用运动学跟踪得到的关键关节瞬时速率
+    static float calculateSpeedRatio(const FrameFeature& realFrame, const FrameFeature& templateFrame) {
+        // 接近静止时速率比不稳定，分母与分子都以最小速率截断
+        constexpr float minSpeed = 0.05f;  // 米/秒
 
-        if (validCount == 0 || templateSpeed < 0.001f) {
+        if (!realFrame.speedValid || !templateFrame.speedValid) {
             return 1.0f;  // 无法计算速度比率时返回1
         }
 
-        return realSpeed / (templateSpeed * validCount);
+        return std::max(realFrame.speed, minSpeed) / std::max(templateFrame.speed, minSpeed);
     }
 
     // 位置计算相关函数实现
@@ -187,89 +172,59 @@ namespace kfc {
     }
 
     // 相似度计算核心函数实现
-    float compareFrames(const FrameData& realFrame, const FrameData& templateFrame) {
-        if (realFrame.joints.size() != templateFrame.joints.size()) {
+    // Fast 为 true 时在余弦域用多项式 acos、多项式指数代替 std::acos/std::exp，位置项直接用距离平方
+    template<bool Fast>
+    static float compareFeaturesKernel(const FrameFeature& realFrame, const FrameFeature& templateFrame, const ScoringParams& params) {
+        if (realFrame.jointCount != templateFrame.jointCount) {
             return 0.0f;
         }
 
         float totalWeightedSimilarity = 0.0f;
         float totalWeight = 0.0f;
 
-        // 1. 计算角度相似度
-        for (const auto& bone : boneConnections) {
-            const auto& joint1Real = realFrame.joints[bone.first];
-            const auto& joint2Real = realFrame.joints[bone.second];
-            const auto& joint1Template = templateFrame.joints[bone.first];
-            const auto& joint2Template = templateFrame.joints[bone.second];
-
-            if (joint1Real.trackingState == TrackingState_Tracked && 
-                joint2Real.trackingState == TrackingState_Tracked &&
-                joint1Template.trackingState == TrackingState_Tracked && 
-                joint2Template.trackingState == TrackingState_Tracked) {
-                
-                // 使用归一化的骨骼向量计算角度
-                Vector3d boneVectorReal = getNormalizedBoneVector(joint1Real.position, joint2Real.position);
-                Vector3d boneVectorTemplate = getNormalizedBoneVector(joint1Template.position, joint2Template.position);
-                
-                float angle = calculateAngle(boneVectorReal, boneVectorTemplate);
-                
-                // 根据骨骼类型选择不同的高斯核带宽
-                float sigma = 0.8f;  // 默认带宽
-                if (bone.first == JointType_SpineBase || bone.first == JointType_SpineMid) {
-                    sigma = 0.6f;  // 躯干部分使用更小的带宽，要求更精确
-                } else if (bone.first == JointType_HandRight || bone.first == JointType_HandLeft) {
-                    sigma = 1.0f;  // 手部使用更大的带宽，允许更大的变化
-                }
-                
-                float angleSimilarity = calculateAngleSimilarity(angle, sigma);
-
-                float weight = 1.0f;
-                auto it = jointWeights.find(bone.second);
-                if (it != jointWeights.end()) {
-                    weight = it->second;
-                }
+        // 1. 计算角度相似度（骨骼向量已在提取特征时归一化）
+        const uint32_t boneMask = realFrame.boneMask & templateFrame.boneMask;
+        for (size_t b = 0; b < kBoneCount; ++b) {
+            if (!((boneMask >> b) & 1u)) {
+                continue;
+            }
 
-                totalWeightedSimilarity += angleSimilarity * weight;
-                totalWeight += weight;
+            float cosAngle = realFrame.bones[b].dot(templateFrame.bones[b]);
+            cosAngle = std::min(1.0f, std::max(-1.0f, cosAngle));
+            float angleSimilarity;
+            if constexpr (Fast) {
+                float angle = fastAcos(cosAngle);
+                angleSimilarity = fastExp(-angle * angle * boneInvTwoSigmaSq[b]);
+            } else {
+                float angle = std::acos(cosAngle);
+                angleSimilarity = std::exp(-angle * angle * boneInvTwoSigmaSq[b]);
             }
+
+            float weight = jointWeightTable[boneConnections[b].second];
+            totalWeightedSimilarity += angleSimilarity * weight;
+            totalWeight += weight;
         }
 
         // 2. 计算相对位置相似度
-        const auto& spineBaseReal = realFrame.joints[JointType_SpineBase];
-        const auto& spineMidReal = realFrame.joints[JointType_SpineMid];
-        const auto& spineBaseTemplate = templateFrame.joints[JointType_SpineBase];
-        const auto& spineMidTemplate = templateFrame.joints[JointType_SpineMid];
-
-        if (spineBaseReal.trackingState == TrackingState_Tracked && 
-            spineMidReal.trackingState == TrackingState_Tracked &&
-            spineBaseTemplate.trackingState == TrackingState_Tracked && 
-            spineMidTemplate.trackingState == TrackingState_Tracked) {
-            
-            // 使用 Eigen 的批量运算
-            for (size_t i = 0; i < realFrame.joints.size(); ++i) {
-                const auto& jointReal = realFrame.joints[i];
-                const auto& jointTemplate = templateFrame.joints[i];
-
-                if (jointReal.trackingState == TrackingState_Tracked && 
-                    jointTemplate.trackingState == TrackingState_Tracked) {
-                    
-                    Vector3d relPosReal = calculateRelativePosition(
-                        jointReal.position, spineMidReal.position, spineBaseReal.position);
-                    Vector3d relPosTemplate = calculateRelativePosition(
-                        jointTemplate.position, spineMidTemplate.position, spineBaseTemplate.position);
-
-                    float posDistance = (relPosReal - relPosTemplate).norm();
-                    float posSimilarity = std::exp(-posDistance * posDistance / 0.5f);
-
-                    float weight = 1.0f;
-                    auto it = jointWeights.find(static_cast<JointType>(i));
-                    if (it != jointWeights.end()) {
-                        weight = it->second;
-                    }
+        if (realFrame.spineValid && templateFrame.spineValid) {
+            const uint32_t jointMask = realFrame.jointMask & templateFrame.jointMask;
+            for (size_t i = 0; i < JointType_Count; ++i) {
+                if (!((jointMask >> i) & 1u)) {
+                    continue;
+                }
 
-                    totalWeightedSimilarity += posSimilarity * weight;
-                    totalWeight += weight;
+                float posSimilarity;
+                if constexpr (Fast) {
+                    float posDistanceSq = (realFrame.relPositions[i] - templateFrame.relPositions[i]).squaredNorm();
+                    posSimilarity = fastExp(-posDistanceSq * 2.0f);
+                } else {
+                    float posDistance = (realFrame.relPositions[i] - templateFrame.relPositions[i]).norm();
+                    posSimilarity = std::exp(-posDistance * posDistance * 2.0f);
                 }
+
+                float weight = jointWeightTable[i];
+                totalWeightedSimilarity += posSimilarity * weight;
+                totalWeight += weight;
             }
         }
 
@@ -281,263 +236,401 @@ namespace kfc {
         
         // 计算速度惩罚
         float speedRatio = calculateSpeedRatio(realFrame, templateFrame);
-        float speedPenalty = calculateSpeedPenalty(speedRatio);
+        float speedPenalty = calculateSpeedPenalty(speedRatio, params);
         
         // 应用速度惩罚
-        const auto& config = Config::getInstance();
-        similarity = similarity * (1.0f - config.speedWeight) + speedPenalty * config.speedWeight;
+        similarity = similarity * params.frameWeight + speedPenalty * params.speedWeight;
         
         return similarity;
     }
 
-    float postProcessSimilarity(float rawSimilarity, float sensitivity = 2.0f) {
-        static float lastProcessed = 0.0f;
-        const auto& config = Config::getInstance();
-        
-        // 根据难度调整参数
-        float difficultyFactor = (config.difficulty - 3) * 0.1f;  // 难度3为基准，每级难度增减10%
-        float basePunishment = 0.4f * (1.0f + difficultyFactor);  // 基础惩罚随难度调整
-        float stretchFactor = 1.3f * (1.0f - difficultyFactor);   // 拉伸系数随难度调整
-        float mappingRange = 4.5f * (1.0f - difficultyFactor);    // 映射范围随难度调整
-        float finalPower = 1.2f * (1.0f + difficultyFactor);      // 最终幂次随难度调整
-        
+    float compareFeatures(const FrameFeature& realFrame, const FrameFeature& templateFrame, const ScoringParams& params) {
+        return params.fastMath ? compareFeaturesKernel<true>(realFrame, templateFrame, params)
+                               : compareFeaturesKernel<false>(realFrame, templateFrame, params);
+    }
+
+    static void makeBandCorridor(DtwCorridor& corridor, size_t M, size_t N, size_t bandWidth) {
+        corridor.begin.resize(M);
+        corridor.end.resize(M);
+        corridor.offset.resize(M + 1);
+        corridor.offset[0] = 0;
+        for (size_t i = 1; i <= M; ++i) {
+            size_t j_start = 1;
+            size_t j_end = N;
+
+            // 应用Sakoe-Chiba带约束
+            if (bandWidth < N) {
+                // 计算理想的对齐位置（假设线性对齐）
+                double expected_j = (static_cast<double>(i) * N) / M;
+                j_start = std::max<size_t>(1, std::min<size_t>(N, static_cast<size_t>(std::ceil(expected_j - bandWidth))));
+                j_end = std::min<size_t>(N, static_cast<size_t>(std::floor(expected_j + bandWidth)));
+            }
+
+            corridor.begin[i - 1] = j_start;
+            corridor.end[i - 1] = j_end;
+            corridor.offset[i] = corridor.offset[i - 1] + (j_end >= j_start ? j_end - j_start + 1 : 0);
+        }
+    }
+
+    static constexpr size_t kParallelCells = 1000;   // 走廊格数超过此值时分块并行
+    static constexpr size_t kRowsPerTask = 8;        // 每个并行块的行数
+
+    // 只计算走廊内的帧相似度，按行分块交给共享线程池；核函数的选择在循环外完成
+    template<bool Fast>
+    static void fillCorridor(DtwCorridor& corridor, const std::vector<FrameFeature>& realFrames,
+                             const std::vector<FrameFeature>& templateFrames, const ScoringParams& params) {
+        const size_t M = realFrames.size();
+        corridor.similarity.resize(corridor.cells());
+        const auto fillRows = [&](size_t rowBegin, size_t rowEnd) {
+            for (size_t i = rowBegin; i < rowEnd; ++i) {
+                float* row = corridor.similarity.data() + corridor.offset[i];
+                const FrameFeature& realFrame = realFrames[i];
+                for (size_t j = corridor.begin[i]; j <= corridor.end[i]; ++j) {
+                    *row++ = compareFeaturesKernel<Fast>(realFrame, templateFrames[j - 1], params);
+                }
+            }
+        };
+        if (corridor.cells() > kParallelCells) {
+            TaskScheduler::getInstance().parallelFor(0, M, kRowsPerTask, fillRows);
+        } else {
+            fillRows(0, M);
+        }
+    }
+
+    float compareFrames(const FrameData& realFrame, const FrameData& templateFrame, const ScoringParams& params) {
+        return compareFeatures(extractFeature(realFrame), extractFeature(templateFrame), params);
+    }
+
+    float postProcessSimilarity(float rawSimilarity, const ScoringParams& params, float sensitivity) {
+        // 难度相关的系数在生成参数快照时已算好
         // 如果原始相似度太低，保持高惩罚
         if (rawSimilarity < 0.3f) {
-            float punished = rawSimilarity * basePunishment;
-            float smoothed = lastProcessed * 0.7f + punished * 0.3f;
-            lastProcessed = smoothed;
-            return smoothed;
+            return rawSimilarity * params.basePunishment;
         }
         
         // 先进行非线性拉伸，适度惩罚中等相似度
-        float stretched = std::pow((rawSimilarity - 0.3f) * stretchFactor, 1.1f);
+        const bool fast = params.fastMath;
+        float stretched = fast ? fastPow((rawSimilarity - 0.3f) * params.stretchFactor, 1.1f)
+                               : std::pow((rawSimilarity - 0.3f) * params.stretchFactor, 1.1f);
         stretched = std::max(0.0f, std::min(1.0f, stretched));
         
         // 将相似度映射到合适范围
-        float x = (stretched - 0.25f) * mappingRange;
+        float x = (stretched - 0.25f) * params.mappingRange;
         
         // 使用sigmoid函数进行S型映射
-        float processed = 1.0f / (1.0f + std::exp(-x * (sensitivity * 1.0f)));
+        float processed = 1.0f / (1.0f + (fast ? fastExp(-x * sensitivity) : std::exp(-x * (sensitivity * 1.0f))));
         
         // 分段线性映射，平衡各分段的惩罚
         if (processed < 0.35f) {
-            processed *= 0.45f * (1.0f + difficultyFactor);  // 低分段惩罚随难度增加
+            processed *= params.lowSegmentScale;
         } else if (processed < 0.65f) {
-            processed = 0.35f + (processed - 0.35f) * (0.8f * (1.0f - difficultyFactor));  // 中等分段惩罚随难度增加
+            processed = 0.35f + (processed - 0.35f) * params.midSegmentScale;
         } else {
-            processed = 0.65f + (processed - 0.65f) * (0.75f * (1.0f - difficultyFactor));  // 高分段奖励随难度减少
+            processed = 0.65f + (processed - 0.65f) * params.highSegmentScale;
         }
         
         // 最终调整
-        processed = std::pow(processed, finalPower);
-        
-        // 平滑处理
-        float smoothed = lastProcessed * 0.3f + processed * 0.7f;
-        lastProcessed = smoothed;
-        
-        LOG_D("Raw similarity: {:.2f}%, Processed: {:.2f}%, Difficulty: {}", 
-            rawSimilarity * 100.0f, smoothed * 100.0f, config.difficulty);
-            
-        return smoothed;
+        return fast ? fastPow(processed, params.finalPower) : std::pow(processed, params.finalPower);
     }
 
-    // DTW相关函数实现
-    static float computeDTW(const std::vector<FrameData>& realFrames,
-                    const std::vector<FrameData>& templateFrames, 
-                    size_t bandWidth = 0) {
-        const auto& config = Config::getInstance();
-        const size_t M = realFrames.size();
-        const size_t N = templateFrames.size();
-        
-        if (M == 0 || N == 0) {
-            return 0.0f;
+    size_t DtwWorkspace::capacityBytes() const {
+        size_t bytes = cost.capacity() * sizeof(float) + corridor.similarity.capacity() * sizeof(float) +
+            (corridor.begin.capacity() + corridor.end.capacity() + corridor.offset.capacity()) * sizeof(size_t) +
+            (features.capacity() + stridedReal.capacity() + stridedTemplate.capacity()) * sizeof(FrameFeature);
+        for (const auto* list : { &frames, &resampled }) {
+            bytes += list->capacity() * sizeof(FrameData);
+            for (const auto& frame : *list) {
+                bytes += frame.joints.capacity() * sizeof(JointData);
+            }
         }
+        return bytes;
+    }
 
-        // 如果没有指定带宽，使用配置的比例计算带宽
-        if (bandWidth == 0) {
-            bandWidth = std::max<size_t>(
-                static_cast<size_t>(std::min<size_t>(M, N) * config.dtwBandwidthRatio), 
-                static_cast<size_t>(10)
-            );
-        }
-        LOG_D("DTW band width: {}", bandWidth);
-
-        // 计算模板序列的平均速度
-        float templateTotalSpeed = 0.0f;
-        int speedCount = 0;
-        const JointType targetJoints[] = {
-            JointType_ElbowRight, JointType_ElbowLeft,
-            JointType_WristRight, JointType_WristLeft
-        };
+    static constexpr size_t kWavefrontTile = 64;          // 波前分块边长，64×64 的代价块约 16KB，可留在 L1
+    static constexpr size_t kWavefrontCells = 1u << 20;   // Auto 模式下走廊格数达到此值才使用波前
 
-        for (size_t i = 1; i < N; ++i) {
-            const auto& curr = templateFrames[i];
-            const auto& prev = templateFrames[i-1];
-            float timeInterval = (curr.timestamp - prev.timestamp) / 10000000.0f;  // 转换为秒
+    // 累计代价只存走廊内的格，布局与 corridor.similarity 相同，内存与带面积成正比。
+    // 走廊外的格不可达（无穷大）；第 0 行只有 (0, 0) 为 0，第 0 列除 (0, 0) 外均不可达
+    static inline float costAt(const DtwCorridor& corridor, const std::vector<float>& cost, size_t i, size_t j) {
+        if (i == 0) {
+            return j == 0 ? 0.0f : std::numeric_limits<float>::infinity();
+        }
+        if (j < corridor.begin[i - 1] || j > corridor.end[i - 1]) {
+            return std::numeric_limits<float>::infinity();
+        }
+        return cost[corridor.offset[i - 1] + (j - corridor.begin[i - 1])];
+    }
+
+    // 计算 DP 中 [rowBegin, rowEnd) × [colBegin, colEnd) 与走廊的交集（下标从 1 开始），
+    // 依赖的左、上、左上三格须已算好
+    static void fillDtwBlock(std::vector<float>& cost, const DtwCorridor& corridor,
+                             size_t rowBegin, size_t rowEnd, size_t colBegin, size_t colEnd) {
+        for (size_t i = rowBegin; i < rowEnd; ++i) {
+            const size_t j_start = std::max(colBegin, corridor.begin[i - 1]);
+            const size_t j_end = std::min(colEnd - 1, corridor.end[i - 1]);
+            const size_t firstCol = corridor.begin[i - 1];
+            const float* similarity = corridor.similarity.data() + corridor.offset[i - 1];
+            float* row = cost.data() + corridor.offset[i - 1];
             
-            for (JointType type : targetJoints) {
-                const JointData* currJoint = findJoint(curr.joints, type);
-                const JointData* prevJoint = findJoint(prev.joints, type);
+            for (size_t j = j_start; j <= j_end; ++j) {
+                float cellCost = 1.0f - similarity[j - firstCol];
+                float min_prev = std::min({
+                    costAt(corridor, cost, i - 1, j),      // 插入
+                    j > firstCol ? row[j - firstCol - 1] : std::numeric_limits<float>::infinity(),   // 删除
+                    costAt(corridor, cost, i - 1, j - 1)   // 匹配
+                });
                 
-                if (currJoint && prevJoint && 
-                    currJoint->trackingState == TrackingState_Tracked && 
-                    prevJoint->trackingState == TrackingState_Tracked) {
-                    templateTotalSpeed += calculateJointSpeed(*currJoint, *prevJoint, timeInterval);
-                    speedCount++;
+                if (std::isinf(min_prev)) {
+                    row[j - firstCol] = cellCost * static_cast<float>(i);
+                } else {
+                    row[j - firstCol] = cellCost + min_prev;
                 }
             }
         }
-        float templateAvgSpeed = speedCount > 0 ? templateTotalSpeed / speedCount : 0.0f;
+    }
+
+    // 第 bi 个行块与走廊相交的列块范围 [first, last]。走廊各行的起止列随行号单调不减，
+    // 只需看块内首行的起点与末行的终点；块内没有走廊格时返回 false
+    static bool corridorTileColumns(const DtwCorridor& corridor, size_t M, size_t bi, size_t& first, size_t& last) {
+        const size_t rowBegin = bi * kWavefrontTile;
+        const size_t rowLast = std::min(M, rowBegin + kWavefrontTile) - 1;
+        const size_t colBegin = corridor.begin[rowBegin];
+        const size_t colEnd = corridor.end[rowLast];
+        if (colEnd < colBegin) {
+            return false;
+        }
+        first = (colBegin - 1) / kWavefrontTile;
+        last = (colEnd - 1) / kWavefrontTile;
+        return true;
+    }
 
-        // 计算实时序列的平均速度（使用滑动窗口）
-        const int windowSize = 5;  // 使用5帧的滑动窗口
-        float realTotalSpeed = 0.0f;
-        speedCount = 0;
-        for (size_t i = M - std::min(M, (size_t)windowSize); i < M && i > 0; ++i) {
-            const auto& curr = realFrames[i];
-            const auto& prev = realFrames[i-1];
-            float timeInterval = (curr.timestamp - prev.timestamp) / 10000000.0f;
-            
-            for (JointType type : targetJoints) {
-                const JointData* currJoint = findJoint(curr.joints, type);
-                const JointData* prevJoint = findJoint(prev.joints, type);
-                
-                if (currJoint && prevJoint && 
-                    currJoint->trackingState == TrackingState_Tracked && 
-                    prevJoint->trackingState == TrackingState_Tracked) {
-                    realTotalSpeed += calculateJointSpeed(*currJoint, *prevJoint, timeInterval);
-                    speedCount++;
+    // 波前：把 DP 切成 kWavefrontTile 见方的块，同一条反对角线上的块互不依赖，交给线程池并行；
+    // 每格的计算与逐行版本完全相同，结果逐位一致。每条反对角线只提交与走廊相交的块，
+    // 带宽远小于序列长度时大部分块不会进入线程池
+    static void fillDtwWavefront(std::vector<float>& cost, const DtwCorridor& corridor, size_t M, size_t N) {
+        const size_t rowTiles = (M + kWavefrontTile - 1) / kWavefrontTile;
+        const size_t colTiles = (N + kWavefrontTile - 1) / kWavefrontTile;
+        auto& scheduler = TaskScheduler::getInstance();
+        for (size_t d = 0; d + 1 < rowTiles + colTiles; ++d) {
+            // 走廊单调，相交的块在反对角线上连续
+            size_t first = rowTiles;
+            size_t last = 0;
+            for (size_t bi = d >= colTiles ? d - colTiles + 1 : 0; bi <= std::min(d, rowTiles - 1); ++bi) {
+                size_t colFirst = 0;
+                size_t colLast = 0;
+                if (corridorTileColumns(corridor, M, bi, colFirst, colLast) && colFirst <= d - bi && d - bi <= colLast) {
+                    first = std::min(first, bi);
+                    last = bi;
                 }
             }
+            if (first > last) {
+                continue;
+            }
+            scheduler.parallelFor(first, last + 1, 1, [&](size_t tileBegin, size_t tileEnd) {
+                for (size_t bi = tileBegin; bi < tileEnd; ++bi) {
+                    const size_t bj = d - bi;
+                    fillDtwBlock(cost, corridor,
+                                 1 + bi * kWavefrontTile, 1 + std::min(M, (bi + 1) * kWavefrontTile),
+                                 1 + bj * kWavefrontTile, 1 + std::min(N, (bj + 1) * kWavefrontTile));
+                }
+            });
         }
-        float realAvgSpeed = speedCount > 0 ? realTotalSpeed / speedCount : 0.0f;
-
-        // 计算速度比率和惩罚系数
-        float speedRatio = templateAvgSpeed > 0.001f ? realAvgSpeed / templateAvgSpeed : 1.0f;
-        float speedPenalty = calculateSpeedPenalty(speedRatio);
+    }
 
-        // 使用 Eigen 矩阵存储 DTW 计算结果，使用 RowMajor 布局以提高缓存命中率
-        using Matrix = Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
-        Matrix dtw = Matrix::Constant(M + 1, N + 1, std::numeric_limits<float>::infinity());
-        dtw(0, 0) = 0.0f;
+    // DTW相关函数实现
+    static float computeDTW(const std::vector<FrameFeature>& realFrames,
+                    const std::vector<FrameFeature>& templateFrames, 
+                    float realAvgSpeed, float templateAvgSpeed,
+                    const ScoringParams& params, DtwWorkspace& workspace, size_t bandWidth = 0) {
+        const size_t M = realFrames.size();
+        const size_t N = templateFrames.size();
+        
+        if (M == 0 || N == 0) {
+            return 0.0f;
+        }
 
-        // 预计算所有帧的相似度，同样使用 RowMajor 布局
-        Matrix similarityMatrix = Matrix::Zero(M, N);
-        #pragma omp parallel for collapse(2) if(M * N > 1000)
-        for (int i = 0; i < static_cast<int>(M); ++i) {
-            for (int j = 0; j < static_cast<int>(N); ++j) {
-                similarityMatrix(i, j) = compareFrames(realFrames[i], templateFrames[j]);
+        // 如果没有指定带宽，使用配置的比例计算带宽
+        if (bandWidth == 0) {
+            bandWidth = params.bandWidth(M, N);
+        }
+        LOG_FAST_D("DTW band width: {}", bandWidth);
+        KF_TRACE_SCOPE_ARG("computeDTW", "band", bandWidth);
+
+        // 计算速度比率和惩罚系数（模板平均速率在加载时计算，实时平均速率由增量运动学维护）
+        float speedRatio = tempoRatio(realAvgSpeed, templateAvgSpeed);
+        float speedPenalty = calculateSpeedPenalty(speedRatio, params);
+
+        // 只预计算带内各帧的相似度，代价与带面积成正比
+        DtwCorridor& corridor = workspace.corridor;
+        makeBandCorridor(corridor, M, N, bandWidth);
+        const bool wavefront = params.dtwSchedule == DtwSchedule::Wavefront ||
+            (params.dtwSchedule == DtwSchedule::Auto && corridor.cells() >= kWavefrontCells &&
+             TaskScheduler::getInstance().getWorkerCount() > 1);
+
+        // 累计代价与相似度同样只存走廊内的格，走廊内每格都会被写入，无需初始化
+        std::vector<float>& cost = workspace.cost;
+        cost.resize(corridor.cells());
+
+        {
+            ScopedLatency timer(Metric_Similarity);
+            if (params.fastMath) {
+                fillCorridor<true>(corridor, realFrames, templateFrames, params);
+            } else {
+                fillCorridor<false>(corridor, realFrames, templateFrames, params);
             }
         }
         
         // DTW 动态规划计算，带Sakoe-Chiba带约束
-        for (size_t i = 1; i <= M; ++i) {
-            // 计算当前行的带约束范围
-            size_t j_start = 1;
-            size_t j_end = N;
-            
-            // 应用Sakoe-Chiba带约束
-            if (bandWidth < N) {
-                // 计算理想的对齐位置（假设线性对齐）
-                double expected_j = (static_cast<double>(i) * N) / M;
-                j_start = std::max<size_t>(1, std::min<size_t>(N, static_cast<size_t>(std::ceil(expected_j - bandWidth))));
-                j_end = std::min<size_t>(N, static_cast<size_t>(std::floor(expected_j + bandWidth)));
-            }
-            
-            // 使用向量化操作计算当前行
-            for (size_t j = j_start; j <= j_end; ++j) {
-                float cost = 1.0f - similarityMatrix(i-1, j-1);
-                float min_prev = std::min({
-                    dtw(i-1, j),   // 插入
-                    dtw(i, j-1),   // 删除
-                    dtw(i-1, j-1)  // 匹配
-                });
-                
-                if (std::isinf(min_prev)) {
-                    dtw(i, j) = cost * static_cast<float>(i);
-                } else {
-                    dtw(i, j) = cost + min_prev;
-                }
-            }
+        const INT64 dpStart = QueryTicks();
+        if (wavefront) {
+            fillDtwWavefront(cost, corridor, M, N);
+        } else {
+            fillDtwBlock(cost, corridor, 1, M + 1, 1, N + 1);
         }
         
+        Metrics::getInstance().record(Metric_DTW, TicksToMicroseconds(QueryTicks() - dpStart));
+
         // 计算相似度得分
-        float dtwDistance = dtw(M, N);
+        float dtwDistance = costAt(corridor, cost, M, N);
         if (std::isinf(dtwDistance)) {
             // 如果带宽已经接近序列长度的一半，尝试使用最近的有效值
             if (bandWidth >= std::min<size_t>(M, N) / 3) {
                 float minDistance = std::numeric_limits<float>::infinity();
                 
-                // 在最后几行和列中寻找最小的有效距离
-                Eigen::Matrix<float, 5, 5> endRegion = dtw.block(M-4, N-4, 5, 5);
-                float validMin = endRegion.array().isFinite().select(endRegion, std::numeric_limits<float>::infinity()).minCoeff();
+                // 在最后几行和列中寻找最小的有效距离，序列不足 5 帧时从第 1 行/列开始
+                float validMin = std::numeric_limits<float>::infinity();
+                for (size_t i = M > 4 ? M - 4 : 1; i <= M; ++i) {
+                    for (size_t j = N > 4 ? N - 4 : 1; j <= N; ++j) {
+                        validMin = std::min(validMin, costAt(corridor, cost, i, j));
+                    }
+                }
                 
                 if (!std::isinf(validMin)) {
-                    dtwDistance = validMin * (static_cast<float>(M + N) / static_cast<float>(M + N - 5));
-                    LOG_W("Using approximate DTW distance: {:.2f}", dtwDistance);
+                    dtwDistance = validMin * (static_cast<float>(M + N) / static_cast<float>(M + N > 5 ? M + N - 5 : 1));
+                    KF_LOG_EVERY_MS(1000, LOG_FAST_W, "Using approximate DTW distance: {:.2f}", dtwDistance);
                 } else if (bandWidth >= std::min<size_t>(M, N) / 2) {
-                    LOG_W("DTW path not found even with wide band, sequences might be too different");
+                    KF_LOG_EVERY_MS(1000, LOG_FAST_W, "DTW path not found even with wide band, sequences might be too different");
                     return 0.0f;
                 } else {
                     // 增加带宽并重试
-                    LOG_W("DTW path not found within the band width {}, increasing to {}", bandWidth, bandWidth * 2);
-                    return computeDTW(realFrames, templateFrames, bandWidth * 2);
+                    KF_LOG_EVERY_MS(1000, LOG_FAST_W, "DTW path not found within the band width {}, increasing to {}", bandWidth, bandWidth * 2);
+                    Metrics::getInstance().add(Counter_DTWRetries);
+                    return computeDTW(realFrames, templateFrames, realAvgSpeed, templateAvgSpeed, params, workspace, bandWidth * 2);
                 }
             } else {
                 // 增加带宽并重试
-                LOG_W("DTW path not found within the band width {}, increasing to {}", bandWidth, bandWidth * 2);
-                return computeDTW(realFrames, templateFrames, bandWidth * 2);
+                KF_LOG_EVERY_MS(1000, LOG_FAST_W, "DTW path not found within the band width {}, increasing to {}", bandWidth, bandWidth * 2);
+                Metrics::getInstance().add(Counter_DTWRetries);
+                return computeDTW(realFrames, templateFrames, realAvgSpeed, templateAvgSpeed, params, workspace, bandWidth * 2);
             }
         }
 
         float similarity = 1.0f / (1.0f + dtwDistance / std::max(M, N));
         
-        LOG_D("DTW distance: {:.2f}, sequence length: {} vs {}, raw similarity: {:.2f}%, speed ratio: {:.2f}, penalty: {:.2f}", 
+        LOG_FAST_D("DTW distance: {:.2f}, sequence length: {} vs {}, raw similarity: {:.2f}%, speed ratio: {:.2f}, penalty: {:.2f}",
             dtwDistance, M, N, similarity * 100.0f, speedRatio, speedPenalty);
             
         // 使用配置的权重混合DTW相似度和速度惩罚
-        float weightedSimilarity = similarity * (1.0f - config.speedWeight + config.speedWeight * speedPenalty);
-        return postProcessSimilarity(weightedSimilarity);
+        return similarity * (params.frameWeight + params.speedWeight * speedPenalty);
+    }
+
+    float compareSequences(const std::vector<FrameFeature>& realFeatures, const std::vector<FrameFeature>& referenceFeatures,
+                           float realAvgSpeed, float referenceAvgSpeed, const ScoringParams& params, DtwWorkspace& workspace) {
+        if (realFeatures.empty() || referenceFeatures.empty()) {
+            workspace.cost.clear();
+            return 0.0f;
+        }
+        return computeDTW(realFeatures, referenceFeatures, realAvgSpeed, referenceAvgSpeed, params, workspace);
+    }
+
+    // 每隔 stride 帧取一帧写入 out，保留最后一帧（实时序列的最新姿态、模板的结束姿态）
+    static void strideFeatures(const std::vector<FrameFeature>& features, size_t stride, std::vector<FrameFeature>& out) {
+        out.clear();
+        if (features.empty()) {
+            return;
+        }
+        out.reserve((features.size() + stride - 1) / stride);
+        for (size_t i = (features.size() - 1) % stride; i < features.size(); i += stride) {
+            out.push_back(features[i]);
+        }
     }
 
     // 动作比较相关函数实现
-    float compareActionBuffer(const ActionBuffer& buffer, const ActionTemplate& actionTemplate) {
-        const auto& realDeque = buffer.getFrames();
-        const auto& templateFrames = actionTemplate.getFrames();
+    float compareFeatureSequence(const std::vector<FrameFeature>& realFeatures, float realAvgSpeed,
+                                 const ActionTemplate& actionTemplate, const ScoringParams& params,
+                                 float* rawSimilarity) {
+        DtwWorkspace workspace;
+        return compareFeatureSequence(realFeatures, realAvgSpeed, actionTemplate, params, workspace, rawSimilarity);
+    }
 
-        if (realDeque.empty() || templateFrames.empty()) {
+    float compareFeatureSequence(const std::vector<FrameFeature>& realFeatures, float realAvgSpeed,
+                                 const ActionTemplate& actionTemplate, const ScoringParams& params,
+                                 DtwWorkspace& workspace, float* rawSimilarity) {
+        const auto& templateFeatures = actionTemplate.getFeatures();
+
+        if (realFeatures.empty() || templateFeatures.empty()) {
             LOG_E("Real action or template action is empty");
+            if (rawSimilarity) {
+                *rawSimilarity = 0.0f;
+            }
             return 0.0f;
         }
 
-        std::vector<FrameData> realFrames(realDeque.begin(), realDeque.end());
-        float similarity = computeDTW(realFrames, templateFrames);
-        
-        return similarity;
+        // 降级时两段序列按相同步长抽帧，相当于以 resampleFPS / stride 的帧率比较
+        const auto* real = &realFeatures;
+        const auto* reference = &templateFeatures;
+        if (params.sequenceStride > 1) {
+            strideFeatures(realFeatures, params.sequenceStride, workspace.stridedReal);
+            strideFeatures(templateFeatures, params.sequenceStride, workspace.stridedTemplate);
+            real = &workspace.stridedReal;
+            reference = &workspace.stridedTemplate;
+        }
+
+        float raw = computeDTW(*real, *reference,
+                               realAvgSpeed, actionTemplate.getKinematics().averageSpeed(), params, workspace);
+        if (rawSimilarity) {
+            *rawSimilarity = raw;
+        }
+
+        ScopedLatency timer(Metric_PostProcess);
+        float processed = postProcessSimilarity(raw, params);
+        LOG_FAST_D("Raw similarity: {:.2f}%, Processed: {:.2f}%, Difficulty: {}",
+            raw * 100.0f, processed * 100.0f, params.difficulty);
+        return processed;
     }
 
-    std::future<float> compareActionAsync(const ActionBuffer& buffer) {
-        return std::async(std::launch::async, [&]() {
-            std::lock_guard<std::mutex> lock(templateMutex);
-            if (!g_actionTemplate) {
-                LOG_E("No action template loaded");
-                return 0.0f;
-            }
+    float compareActionBuffer(const ActionBuffer& buffer, const ActionTemplate& actionTemplate, const ScoringParams& params) {
+        DtwWorkspace workspace;
+        return compareActionBuffer(buffer, actionTemplate, params, workspace);
+    }
 
-            float similarity = compareActionBuffer(buffer, *g_actionTemplate);
-            
-            // 使用阈值进行判断并记录日志
-            const auto& config = Config::getInstance();
-            if (similarity < config.similarityThreshold) {
-                LOG_D("Similarity {:.2f} below threshold {:.2f}", 
-                      similarity * 100.0f, config.similarityThreshold * 100.0f);
-            } else {
-                LOG_D("Similarity {:.2f} above threshold {:.2f}", 
-                      similarity * 100.0f, config.similarityThreshold * 100.0f);
-            }
-            
-            return similarity;
-        });
+    float compareActionBuffer(const ActionBuffer& buffer, const ActionTemplate& actionTemplate, const ScoringParams& params,
+                              DtwWorkspace& workspace) {
+        const auto& realDeque = buffer.getFrames();
+
+        // 实时帧按传感器节奏到达，同样按时间戳重采样，保证两侧采样率一致。
+        // frames 与 resampled 只增不减，只使用前 frameCount / M 帧，窗口变短时不释放尾部帧的关节数组
+        const size_t frameCount = realDeque.size();
+        if (workspace.frames.size() < frameCount) {
+            workspace.frames.resize(frameCount);
+        }
+        std::copy(realDeque.begin(), realDeque.end(), workspace.frames.begin());
+        const size_t M = resampleFrames(workspace.frames.data(), frameCount,
+                                        static_cast<float>(Config::getInstance().resampleFPS), workspace.resampled);
+        const auto& realFrames = workspace.resampled;
+
+        // 实时平均速率取最后 kSpeedWindow 帧
+        workspace.kinematics.build(realFrames.data(), M);
+        float realAvgSpeed = workspace.kinematics.averageSpeed(M - std::min(M, kSpeedWindow), M);
+
+        // 特征的速度直接取运动学剖面中的样本，与 extractFeatures 结果相同
+        const auto& samples = workspace.kinematics.getSamples();
+        workspace.features.resize(M);
+        for (size_t i = 0; i < M; ++i) {
+            workspace.features[i] = extractFeature(realFrames[i], samples[i]);
+        }
+
+        return compareFeatureSequence(workspace.features, realAvgSpeed, actionTemplate, params, workspace);
     }
 
-} // namespace kfc
\ No newline at end of file
+} // namespace kfc
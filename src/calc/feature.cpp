@@ -0,0 +1,118 @@
+#include <cmath>
+
+#include "calc/feature.h"
+
+namespace kfc {
+
+    // 定义骨骼连接关系，用于计算相对角度
+    const std::array<std::pair<JointType, JointType>, kBoneCount> boneConnections = {{
+        // 躯干
+        {JointType_SpineBase, JointType_SpineMid},
+        {JointType_SpineMid, JointType_SpineShoulder},
+        {JointType_SpineShoulder, JointType_Neck},
+        {JointType_Neck, JointType_Head},
+        // 右臂
+        {JointType_SpineShoulder, JointType_ShoulderRight},
+        {JointType_ShoulderRight, JointType_ElbowRight},
+        {JointType_ElbowRight, JointType_WristRight},
+        {JointType_WristRight, JointType_HandRight},
+        // 左臂
+        {JointType_SpineShoulder, JointType_ShoulderLeft},
+        {JointType_ShoulderLeft, JointType_ElbowLeft},
+        {JointType_ElbowLeft, JointType_WristLeft},
+        {JointType_WristLeft, JointType_HandLeft}
+    }};
+
+    static inline Eigen::Vector3f toVector(const CameraSpacePoint& p) {
+        return Eigen::Vector3f(p.X, p.Y, p.Z);
+    }
+
+    FrameFeature extractFeature(const FrameData& frame) {
+        FrameFeature feature;
+        feature.timestamp = frame.timestamp;
+        feature.jointCount = frame.joints.size();
+        feature.boneMask = 0;
+        feature.jointMask = 0;
+        feature.spineValid = false;
+        feature.speed = 0.0f;
+        feature.speedValid = false;
+
+        const auto& joints = frame.joints;
+        const size_t count = std::min<size_t>(joints.size(), JointType_Count);
+
+        for (size_t i = 0; i < count; ++i) {
+            if (joints[i].trackingState == TrackingState_Tracked) {
+                feature.jointMask |= 1u << i;
+            }
+        }
+
+        // 1. 归一化骨骼向量
+        for (size_t b = 0; b < kBoneCount; ++b) {
+            const size_t j1 = boneConnections[b].first;
+            const size_t j2 = boneConnections[b].second;
+            feature.bones[b] = Eigen::Vector3f::Zero();
+
+            if (j1 < count && j2 < count && feature.hasJoint(j1) && feature.hasJoint(j2)) {
+                Eigen::Vector3f bone = toVector(joints[j2].position) - toVector(joints[j1].position);
+                float length = bone.norm();
+                if (length > 1e-6f) {
+                    feature.bones[b] = bone / length;
+                }
+                feature.boneMask |= 1u << b;
+            }
+        }
+
+        // 2. 以脊柱长度归一化的相对位置
+        feature.spineValid = feature.hasJoint(JointType_SpineBase) && feature.hasJoint(JointType_SpineMid);
+        Eigen::Vector3f spineBase = Eigen::Vector3f::Zero();
+        float spineLength = 0.0f;
+        if (feature.spineValid) {
+            spineBase = toVector(joints[JointType_SpineBase].position);
+            spineLength = (toVector(joints[JointType_SpineMid].position) - spineBase).norm();
+        }
+
+        for (size_t i = 0; i < JointType_Count; ++i) {
+            if (i < count && feature.spineValid && spineLength >= 1e-6f) {
+                feature.relPositions[i] = (toVector(joints[i].position) - spineBase) / spineLength;
+            } else {
+                feature.relPositions[i] = Eigen::Vector3f::Zero();
+            }
+        }
+
+        return feature;
+    }
+
+    FrameFeature extractFeature(const FrameData& frame, const KinematicsSample& kinematics) {
+        FrameFeature feature = extractFeature(frame);
+        feature.speed = kinematics.speed();
+        feature.speedValid = kinematics.speedCount > 0;
+        return feature;
+    }
+
+    std::vector<FrameFeature> extractFeatures(const std::vector<FrameData>& frames) {
+        std::vector<FrameFeature> features;
+        features.reserve(frames.size());
+        KinematicsTracker kinematics(1);
+        for (const auto& frame : frames) {
+            features.push_back(extractFeature(frame, kinematics.push(frame)));
+        }
+        return features;
+    }
+
+    size_t FeatureBuffer::addFrame(const FrameData& frame) {
+        if (_resampler.isGap(frame)) {
+            // 间断前的特征不与之后的动作拼成同一段序列
+            clear();
+            ++_gaps;
+        }
+        return _resampler.push(frame, [this](const FrameData& resampled) {
+            if (_buffer.size() >= _maxFrames) {
+                _buffer.pop_front(); // 超过最大帧数时丢弃最早的一帧
+            }
+            const KinematicsSample& sample = _kinematics.push(resampled);
+            _activity.push(sample);
+            _buffer.push_back(extractFeature(resampled, sample));
+        });
+    }
+
+} // namespace kfc
@@ -0,0 +1,137 @@
+#include <algorithm>
+
+#include "calc/kinematics.h"
+
+namespace kfc {
+
+    const std::array<JointType, kSpeedJointCount> speedJoints = {
+        JointType_ElbowRight, JointType_ElbowLeft,
+        JointType_WristRight, JointType_WristLeft
+    };
+
+    KinematicsTracker::KinematicsTracker(size_t window) :
+        _window(std::max<size_t>(1, window)),
+        _samples(_window),
+        _windowSpeedSum(0.0f),
+        _windowSpeedCount(0),
+        _sinceResum(0),
+        _prevTrackedMask(0),
+        _prevVelocityMask(0),
+        _prevTimestamp(0),
+        _hasPrev(false) {}
+
+    const KinematicsSample& KinematicsTracker::push(const FrameData& frame) {
+        KinematicsSample sample;
+        sample.timestamp = frame.timestamp;
+        sample.velocityMask = 0;
+        sample.accelerationMask = 0;
+        sample.speedSum = 0.0f;
+        sample.speedCount = 0;
+
+        const size_t count = std::min<size_t>(frame.joints.size(), JointType_Count);
+        uint32_t trackedMask = 0;
+        std::array<Eigen::Vector3f, JointType_Count> positions;
+        for (size_t i = 0; i < JointType_Count; ++i) {
+            if (i < count) {
+                const auto& p = frame.joints[i].position;
+                positions[i] = Eigen::Vector3f(p.X, p.Y, p.Z);
+                if (frame.joints[i].trackingState == TrackingState_Tracked) {
+                    trackedMask |= 1u << i;
+                }
+            } else {
+                positions[i] = Eigen::Vector3f::Zero();
+            }
+            sample.velocity[i] = Eigen::Vector3f::Zero();
+            sample.acceleration[i] = Eigen::Vector3f::Zero();
+        }
+
+        // 时间戳单位为 100 纳秒
+        const float dt = _hasPrev ? (frame.timestamp - _prevTimestamp) / 10000000.0f : 0.0f;
+        if (dt > 0.0f) {
+            sample.velocityMask = trackedMask & _prevTrackedMask;
+            for (size_t i = 0; i < JointType_Count; ++i) {
+                if ((sample.velocityMask >> i) & 1u) {
+                    sample.velocity[i] = (positions[i] - _prevPositions[i]) / dt;
+                }
+            }
+
+            sample.accelerationMask = sample.velocityMask & _prevVelocityMask;
+            for (size_t i = 0; i < JointType_Count; ++i) {
+                if ((sample.accelerationMask >> i) & 1u) {
+                    sample.acceleration[i] = (sample.velocity[i] - _prevVelocity[i]) / dt;
+                }
+            }
+
+            for (JointType type : speedJoints) {
+                if ((sample.velocityMask >> type) & 1u) {
+                    sample.speedSum += sample.velocity[type].norm();
+                    sample.speedCount++;
+                }
+            }
+        }
+
+        _prevPositions = positions;
+        _prevVelocity = sample.velocity;
+        _prevTrackedMask = trackedMask;
+        _prevVelocityMask = sample.velocityMask;
+        _prevTimestamp = frame.timestamp;
+        _hasPrev = true;
+
+        // 维护滑动窗口的累计值
+        if (_samples.size() >= _window) {
+            _windowSpeedSum -= _samples.front().speedSum;
+            _windowSpeedCount -= _samples.front().speedCount;
+            _samples.pop_front();
+        }
+        _windowSpeedSum += sample.speedSum;
+        _windowSpeedCount += sample.speedCount;
+        _samples.push_back(sample);
+
+        // 浮点累加/相减的舍入误差会随会话时长累积，窗口整体更新一轮后按窗口内样本重算
+        if (++_sinceResum >= _window) {
+            _windowSpeedSum = 0.0f;
+            for (const auto& s : _samples) {
+                _windowSpeedSum += s.speedSum;
+            }
+            _sinceResum = 0;
+        }
+
+        return _samples.back();
+    }
+
+    void KinematicsTracker::reset() {
+        _samples.clear();
+        _windowSpeedSum = 0.0f;
+        _windowSpeedCount = 0;
+        _sinceResum = 0;
+        _prevTrackedMask = 0;
+        _prevVelocityMask = 0;
+        _prevTimestamp = 0;
+        _hasPrev = false;
+    }
+
+    void KinematicsProfile::build(const FrameData* frames, size_t count) {
+        _samples.clear();
+        _speedPrefix.assign(1, 0.0f);
+        _countPrefix.assign(1, 0);
+        _samples.reserve(count);
+
+        KinematicsTracker tracker(1);
+        for (size_t i = 0; i < count; ++i) {
+            const auto& sample = tracker.push(frames[i]);
+            _samples.push_back(sample);
+            _speedPrefix.push_back(_speedPrefix.back() + sample.speedSum);
+            _countPrefix.push_back(_countPrefix.back() + sample.speedCount);
+        }
+    }
+
+    float KinematicsProfile::averageSpeed(size_t begin, size_t end) const {
+        end = std::min(end, _samples.size());
+        if (begin >= end) {
+            return 0.0f;
+        }
+        int count = _countPrefix[end] - _countPrefix[begin];
+        return count > 0 ? (_speedPrefix[end] - _speedPrefix[begin]) / count : 0.0f;
+    }
+
+} // namespace kfc
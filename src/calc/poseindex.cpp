@@ -0,0 +1,158 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+#include "calc/poseindex.h"
+
+namespace kfc {
+
+    PoseDescriptor makePoseDescriptor(const FrameFeature& feature) {
+        PoseDescriptor descriptor{};
+        for (size_t i = 0; i < kBoneCount; ++i) {
+            if (!feature.hasBone(i)) {
+                continue;
+            }
+            descriptor[i * 3 + 0] = feature.bones[i].x();
+            descriptor[i * 3 + 1] = feature.bones[i].y();
+            descriptor[i * 3 + 2] = feature.bones[i].z();
+        }
+        return descriptor;
+    }
+
+    float poseDistance(const PoseDescriptor& a, const PoseDescriptor& b) {
+        float sum = 0.0f;
+        for (size_t i = 0; i < kPoseDescriptorSize; ++i) {
+            const float d = a[i] - b[i];
+            sum += d * d;
+        }
+        return std::sqrt(sum);
+    }
+
+    // 把候选插入按距离升序的前 k 个结果中
+    static void InsertMatch(PoseMatch* out, size_t k, size_t& found, const PoseMatch& match) {
+        if (found == k && match.distance >= out[k - 1].distance) {
+            return;
+        }
+        size_t pos = found < k ? found++ : k - 1;
+        while (pos > 0 && out[pos - 1].distance > match.distance) {
+            out[pos] = out[pos - 1];
+            --pos;
+        }
+        out[pos] = match;
+    }
+
+    uint32_t PoseIndex::addTemplate(const std::vector<FrameFeature>& features) {
+        const uint32_t templateId = _templateCount++;
+        const size_t last = features.size() > 1 ? features.size() - 1 : 1;
+        for (size_t i = 0; i < features.size(); ++i) {
+            Entry entry;
+            entry.descriptor = makePoseDescriptor(features[i]);
+            entry.templateId = templateId;
+            entry.frame = static_cast<uint32_t>(i);
+            entry.phase = static_cast<float>(i) / static_cast<float>(last);
+            _entries.push_back(entry);
+        }
+        _root = -1;
+        return templateId;
+    }
+
+    void PoseIndex::build() {
+        _nodes.clear();
+        _nodes.reserve(_entries.size());
+        std::vector<uint32_t> order(_entries.size());
+        std::iota(order.begin(), order.end(), 0u);
+        std::vector<float> distances(_entries.size());
+        _root = buildNode(order, 0, order.size(), distances);
+    }
+
+    int32_t PoseIndex::buildNode(std::vector<uint32_t>& order, size_t begin, size_t end, std::vector<float>& distances) {
+        if (begin >= end) {
+            return -1;
+        }
+
+        // 取区间中点为圆心：模板帧按时间排列，中点与两端的距离分布更均匀
+        std::swap(order[begin], order[begin + (end - begin) / 2]);
+        const uint32_t vantage = order[begin];
+        const int32_t index = static_cast<int32_t>(_nodes.size());
+        _nodes.push_back(Node{ vantage, 0.0f, -1, -1 });
+        if (end - begin == 1) {
+            return index;
+        }
+
+        // 其余帧按到圆心的距离取中位数划分
+        const auto& center = _entries[vantage].descriptor;
+        for (size_t i = begin + 1; i < end; ++i) {
+            distances[order[i]] = poseDistance(center, _entries[order[i]].descriptor);
+        }
+        const size_t mid = begin + 1 + (end - begin - 1) / 2;
+        std::nth_element(order.begin() + begin + 1, order.begin() + mid, order.begin() + end,
+            [&distances](uint32_t a, uint32_t b) { return distances[a] < distances[b]; });
+
+        const float radius = distances[order[mid]];
+        const int32_t inside = buildNode(order, begin + 1, mid, distances);
+        const int32_t outside = buildNode(order, mid, end, distances);
+
+        Node& node = _nodes[index];
+        node.radius = radius;
+        node.inside = inside;
+        node.outside = outside;
+        return index;
+    }
+
+    size_t PoseIndex::nearest(const PoseDescriptor& query, size_t k, PoseMatch* out) const {
+        if (_root < 0 || k == 0) {
+            return 0;
+        }
+        size_t found = 0;
+        search(_root, query, k, out, found);
+        return found;
+    }
+
+    void PoseIndex::search(int32_t nodeIndex, const PoseDescriptor& query, size_t k, PoseMatch* out, size_t& found) const {
+        if (nodeIndex < 0) {
+            return;
+        }
+
+        const Node& node = _nodes[nodeIndex];
+        const Entry& entry = _entries[node.vantage];
+        const float d = poseDistance(query, entry.descriptor);
+        InsertMatch(out, k, found, PoseMatch{ entry.templateId, entry.frame, entry.phase, d });
+
+        // 先进入查询点所在的一侧，另一侧只在与当前第 k 近的球相交时才访问
+        const auto tau = [&]() {
+            return found < k ? std::numeric_limits<float>::infinity() : out[k - 1].distance;
+        };
+        if (d < node.radius) {
+            search(node.inside, query, k, out, found);
+            if (d + tau() >= node.radius) {
+                search(node.outside, query, k, out, found);
+            }
+        } else {
+            search(node.outside, query, k, out, found);
+            if (d - tau() < node.radius) {
+                search(node.inside, query, k, out, found);
+            }
+        }
+    }
+
+    size_t PoseIndex::nearestBruteForce(const PoseDescriptor& query, size_t k, PoseMatch* out) const {
+        size_t found = 0;
+        if (k == 0) {
+            return 0;
+        }
+        for (const auto& entry : _entries) {
+            InsertMatch(out, k, found, PoseMatch{ entry.templateId, entry.frame, entry.phase,
+                                                  poseDistance(query, entry.descriptor) });
+        }
+        return found;
+    }
+
+    void PoseIndex::clear() {
+        _entries.clear();
+        _nodes.clear();
+        _root = -1;
+        _templateCount = 0;
+    }
+
+} // namespace kfc
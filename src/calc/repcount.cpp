@@ -0,0 +1,160 @@
+#include <algorithm>
+#include <limits>
+
+#include "calc/repcount.h"
+#include "calc/compare.h"
+#include "config/config.h"
+
+namespace kfc {
+
+    static constexpr float kInf = std::numeric_limits<float>::infinity();
+
+    RepCounter::RepCounter(std::shared_ptr<const std::vector<FrameFeature>> templateFeatures, const ScoringParams& params) :
+        _template(templateFeatures ? std::move(templateFeatures) : std::make_shared<const std::vector<FrameFeature>>()),
+        _params(params),
+        _threshold(params.repThreshold * static_cast<float>(_template->size())),
+        _minFrames(std::max<size_t>(1, static_cast<size_t>(_template->size() * params.repMinLengthRatio))),
+        _dist(_template->size() + 1, kInf),
+        _prevDist(_template->size() + 1, kInf),
+        _start(_template->size() + 1, PathStart{ 0, 0 }),
+        _prevStart(_template->size() + 1, PathStart{ 0, 0 }),
+        _frameIndex(0),
+        _bestDist(kInf),
+        _bestStart{ 0, 0 },
+        _bestEnd{ 0, 0 },
+        _count(0) {}
+
+    bool RepCounter::push(const FrameFeature& feature, RepEvent& event) {
+        const std::vector<FrameFeature>& templateFeatures = *_template;
+        const size_t N = templateFeatures.size();
+        if (N == 0) {
+            return false;
+        }
+
+        const uint64_t t = _frameIndex++;
+        const PathStart current{ t, feature.timestamp };
+
+        // 星形填充：任意时刻都可以作为子序列起点
+        _prevDist[0] = 0.0f;
+        _prevStart[0] = current;
+        _dist[0] = 0.0f;
+        _start[0] = current;
+
+        for (size_t i = 1; i <= N; ++i) {
+            float cost = 1.0f - compareFeatures(feature, templateFeatures[i - 1], _params);
+
+            // 三个前驱：同列上一格、上一列同格、上一列上一格
+            float best = _dist[i - 1];
+            PathStart start = _start[i - 1];
+            if (_prevDist[i] < best) {
+                best = _prevDist[i];
+                start = _prevStart[i];
+            }
+            if (_prevDist[i - 1] < best) {
+                best = _prevDist[i - 1];
+                start = _prevStart[i - 1];
+            }
+
+            _dist[i] = cost + best;
+            _start[i] = start;
+        }
+
+        bool reported = false;
+
+        // 当前候选已不可能被更优路径取代时输出
+        if (_bestDist <= _threshold) {
+            bool settled = true;
+            for (size_t i = 1; i <= N; ++i) {
+                if (_dist[i] < _bestDist && _start[i].frame <= _bestEnd.frame) {
+                    settled = false;
+                    break;
+                }
+            }
+
+            if (settled) {
+                report(event);
+                reported = true;
+
+                // 与已输出重复重叠的路径全部作废
+                for (size_t i = 1; i <= N; ++i) {
+                    if (_start[i].frame <= _bestEnd.frame) {
+                        _dist[i] = kInf;
+                    }
+                }
+                _bestDist = kInf;
+            }
+        }
+
+        // 更新候选
+        const size_t length = static_cast<size_t>(t - _start[N].frame + 1);
+        if (_dist[N] <= _threshold && _dist[N] < _bestDist && length >= _minFrames) {
+            _bestDist = _dist[N];
+            _bestStart = _start[N];
+            _bestEnd = current;
+        }
+
+        std::swap(_dist, _prevDist);
+        std::swap(_start, _prevStart);
+
+        return reported;
+    }
+
+    void RepCounter::report(RepEvent& event) {
+        const size_t frameCount = static_cast<size_t>(_bestEnd.frame - _bestStart.frame + 1);
+        event.index = ++_count;
+        event.startTime = _bestStart.time;
+        event.endTime = _bestEnd.time;
+        event.frameCount = frameCount;
+        event.distance = _bestDist;
+        event.score = 1.0f / (1.0f + _bestDist / static_cast<float>(std::max(frameCount, _template->size())));
+    }
+
+    bool RepCounter::breakSequence(RepEvent& event) {
+        // 路径无法再延伸，候选不会再被取代
+        const bool reported = _bestDist <= _threshold;
+        if (reported) {
+            report(event);
+        }
+        std::fill(_dist.begin(), _dist.end(), kInf);
+        std::fill(_prevDist.begin(), _prevDist.end(), kInf);
+        _bestDist = kInf;
+        return reported;
+    }
+
+    void RepCounter::reset() {
+        std::fill(_dist.begin(), _dist.end(), kInf);
+        std::fill(_prevDist.begin(), _prevDist.end(), kInf);
+        _frameIndex = 0;
+        _bestDist = kInf;
+        _count = 0;
+    }
+
+    std::vector<RepEvent> countRepetitions(const std::vector<FrameData>& frames,
+                                           const ActionTemplate& actionTemplate,
+                                           const ScoringParams& params) {
+        const auto& config = Config::getInstance();
+        FrameResampler resampler(static_cast<float>(config.resampleFPS));
+        KinematicsTracker kinematics;
+        RepCounter counter(actionTemplate.getSharedFeatures(), params);
+
+        // 重采样帧逐个送入计数器，长间隔产生的多帧不会被缓冲截断
+        std::vector<RepEvent> events;
+        RepEvent event;
+        for (const auto& frame : frames) {
+            if (resampler.isGap(frame)) {
+                resampler.reset();
+                kinematics.reset();
+                if (counter.breakSequence(event)) {
+                    events.push_back(event);
+                }
+            }
+            resampler.push(frame, [&](const FrameData& resampled) {
+                if (counter.push(extractFeature(resampled, kinematics.push(resampled)), event)) {
+                    events.push_back(event);
+                }
+            });
+        }
+        return events;
+    }
+
+} // namespace kfc
@@ -0,0 +1,103 @@
+#include <algorithm>
+
+#include "calc/resample.h"
+
+namespace kfc {
+
+    void interpolateFrame(const FrameData& a, const FrameData& b, float alpha, INT64 timestamp, FrameData& out) {
+        // 关节数量不一致时无法逐关节插值，退化为取最近的一帧
+        if (a.joints.size() != b.joints.size()) {
+            out = alpha < 0.5f ? a : b;
+            out.timestamp = timestamp;
+            return;
+        }
+
+        out.timestamp = timestamp;
+        out.joints.resize(a.joints.size());
+
+        for (size_t i = 0; i < a.joints.size(); ++i) {
+            const auto& ja = a.joints[i];
+            const auto& jb = b.joints[i];
+            auto& joint = out.joints[i];
+
+            joint.type = ja.type;
+            joint.position.X = ja.position.X + (jb.position.X - ja.position.X) * alpha;
+            joint.position.Y = ja.position.Y + (jb.position.Y - ja.position.Y) * alpha;
+            joint.position.Z = ja.position.Z + (jb.position.Z - ja.position.Z) * alpha;
+            // 只有两端都被跟踪时插值结果才算可靠
+            joint.trackingState = std::min(ja.trackingState, jb.trackingState);
+        }
+    }
+
+    FrameData interpolateFrame(const FrameData& a, const FrameData& b, float alpha, INT64 timestamp) {
+        FrameData frame;
+        interpolateFrame(a, b, alpha, timestamp, frame);
+        return frame;
+    }
+
+    size_t resampleFrames(const FrameData* frames, size_t frameCount, float rate, std::vector<FrameData>& out) {
+        if (rate <= 0.0f || frameCount < 2 || frames[frameCount - 1].timestamp <= frames[0].timestamp) {
+            if (out.size() < frameCount) {
+                out.resize(frameCount);
+            }
+            std::copy(frames, frames + frameCount, out.begin());
+            return frameCount;
+        }
+
+        const INT64 startTime = frames[0].timestamp;
+        const INT64 endTime = frames[frameCount - 1].timestamp;
+
+        // 时间戳单位为 100 纳秒
+        const double interval = 10000000.0 / rate;
+        const size_t count = static_cast<size_t>((endTime - startTime) / interval) + 1;
+
+        // 只增不减：已有元素的关节数组直接复用，序列变短时尾部帧留待下次使用
+        if (out.size() < count) {
+            out.resize(count);
+        }
+
+        size_t seg = 0;
+        for (size_t k = 0; k < count; ++k) {
+            INT64 t = startTime + static_cast<INT64>(k * interval);
+
+            // 找到包含 t 的区间 [seg, seg + 1]，时间戳单调所以只需前进
+            while (seg + 2 < frameCount && frames[seg + 1].timestamp <= t) {
+                ++seg;
+            }
+
+            const auto& a = frames[seg];
+            const auto& b = frames[seg + 1];
+            INT64 span = b.timestamp - a.timestamp;
+            float alpha = span > 0 ? static_cast<float>(t - a.timestamp) / static_cast<float>(span) : 0.0f;
+            alpha = std::max(0.0f, std::min(1.0f, alpha));
+
+            interpolateFrame(a, b, alpha, t, out[k]);
+        }
+        return count;
+    }
+
+    std::vector<FrameData> resampleFrames(const std::vector<FrameData>& frames, float rate) {
+        std::vector<FrameData> result;
+        result.resize(resampleFrames(frames.data(), frames.size(), rate, result));
+        return result;
+    }
+
+    FrameResampler::FrameResampler(float rate) :
+        _rate(rate),
+        _interval(rate > 0.0f ? static_cast<INT64>(10000000.0 / rate) : 0),
+        _nextTime(0),
+        _prev(),
+        _scratch(),
+        _hasPrev(false) {}
+
+    size_t FrameResampler::push(const FrameData& frame, std::vector<FrameData>& out) {
+        return push(frame, [&out](const FrameData& resampled) { out.push_back(resampled); });
+    }
+
+    void FrameResampler::reset() {
+        _hasPrev = false;
+        _nextTime = 0;
+        _prev.joints.clear();
+    }
+
+} // namespace kfc
@@ -1,4 +1,9 @@
 #include "calc/serialize.h"
+#include "calc/resample.h"
+#include "calc/feature.h"
+#include "calc/kinematics.h"
+#include "calc/poseindex.h"
+#include "core/scheduler.h"
 
 namespace kfc {
 
@@ -6,6 +11,9 @@ namespace kfc {
     std::mutex templateMutex;
     std::unique_ptr<ActionTemplate> g_actionTemplate;
 
+    // 模板版本号的来源，不同模板对象的版本号也不会重复
+    static std::atomic<uint64_t> s_templateRevision{ 0 };
+
     // 序列化到文件
     void JointData::serialize(std::ofstream& out) const {
         out.write(reinterpret_cast<const char*>(&type), sizeof(type));
@@ -41,6 +49,31 @@ namespace kfc {
         }
     }
 
+    void BodyFrame::toFrameData(FrameData& out) const {
+        out.timestamp = timestamp;
+        out.joints.assign(joints, joints + JointType_Count);
+    }
+
+    BodyFrame BodyFrame::fromFrameData(const FrameData& frame, int bodyIndex) {
+        BodyFrame body = {};
+        body.timestamp = frame.timestamp;
+        body.acquireTick = 0;
+        body.trackingId = 0;
+        body.bodyIndex = bodyIndex;
+        body.leftHandState = HandState_Unknown;
+        body.rightHandState = HandState_Unknown;
+        for (int j = 0; j < JointType_Count; ++j) {
+            if (j < static_cast<int>(frame.joints.size())) {
+                body.joints[j] = frame.joints[j];
+            } else {
+                body.joints[j].type = static_cast<JointType>(j);
+                body.joints[j].position = CameraSpacePoint{ 0.0f, 0.0f, 0.0f };
+                body.joints[j].trackingState = TrackingState_NotTracked;
+            }
+        }
+        return body;
+    }
+
     // 序列化一帧的骨骼数据到文件
     bool SaveFrame(const std::string& filename, const FrameData& frame, bool append) {
         try {
@@ -71,9 +104,36 @@ namespace kfc {
         }
     }
 
+    // 从文件读取全部帧
+    bool LoadFrames(const std::string& filename, std::vector<FrameData>& frames) {
+        try {
+            std::ifstream in(filename, std::ios::binary);
+            if (!in) {
+                LOG_E("Failed to open file for reading: {}", filename);
+                return false;
+            }
+
+            frames.clear();
+            while (in.peek() != EOF) {
+                FrameData frame;
+                frame.deserialize(in);
+                frames.push_back(std::move(frame));
+            }
+            return true;
+        }
+        catch (const std::exception& e) {
+            LOG_E("Failed to load frames: {}", e.what());
+            return false;
+        }
+    }
+
     // 构造函数，加载标准动作文件
-    ActionTemplate::ActionTemplate(const std::string& filePath) {
+    ActionTemplate::ActionTemplate(const std::string& filePath) :
+        _features(std::make_shared<const std::vector<kfc::FrameFeature>>()),
+        _revision(0) {
         _frames = std::make_unique<std::vector<kfc::FrameData>>();
+        _kinematics = std::make_unique<kfc::KinematicsProfile>();
+        _poseIndex = std::make_unique<kfc::PoseIndex>();
         
         // 确保目录存在
         if (!kfc::ensureDirectoryExists()) {
@@ -91,29 +151,39 @@ namespace kfc {
         }
     }
 
+    ActionTemplate::~ActionTemplate() = default;
+
+    // 清空数据
+    void ActionTemplate::clear() {
+        _frames->clear();
+        _resampledFrames.clear();
+        _features = std::make_shared<const std::vector<kfc::FrameFeature>>();
+        _kinematics->build({});
+        _poseIndex->clear();
+        _revision.store(++s_templateRevision, std::memory_order_release);
+    }
+
     // 加载标准动作数据
     bool ActionTemplate::loadFromFile(const std::string& filename) {
         try {
             //std::string filepath = std::string(KF_DATA_DIR) + "\\" + filename;
-            std::ifstream in(filename, std::ios::binary);
-            if (!in) {
-                LOG_E("Failed to open file for reading: {}", filename);
+            if (!LoadFrames(filename, *_frames)) {
                 return false;
             }
+            size_t frameCount = _frames->size();
 
-            _frames->clear();
-            size_t frameCount = 0;
-            while (in.peek() != EOF) {
-                kfc::FrameData frame;
-                frame.deserialize(in);
-                _frames->push_back(frame);
-                frameCount++;
-            }
+            // 预先重采样到比较使用的统一帧率，避免每次比较重复计算
+            _resampledFrames = resampleFrames(*_frames, static_cast<float>(Config::getInstance().resampleFPS));
+            _features = std::make_shared<const std::vector<kfc::FrameFeature>>(extractFeatures(_resampledFrames));
+            _kinematics->build(_resampledFrames);
+            _poseIndex->clear();
+            _poseIndex->addTemplate(*_features);
+            _poseIndex->build();
+            _revision.store(++s_templateRevision, std::memory_order_release);
 
-            in.close();
             LOG_I("Loading action template from file: {}", filename);
             LOG_I("Action template loaded successfully");
-            LOG_D("Frame count: {}", frameCount);
+            LOG_D("Frame count: {}, resampled: {}", frameCount, _resampledFrames.size());
             LOG_D("First joint count: {}", _frames->empty() ? 0 : _frames->front().joints.size());
 
             return true;
@@ -144,10 +214,10 @@ namespace kfc {
 
     // 异步加载标准动作
     std::future<bool> loadStandardActionAsync(const std::string& filePath) {
-        return std::async(std::launch::async, [&]() {
+        return TaskScheduler::getInstance().submit(TaskPriority::Loading, [filePath]() {
             std::lock_guard<std::mutex> lock(templateMutex);
             return g_actionTemplate->loadFromFile(filePath);
-            });
+        });
     }
 
 
@@ -0,0 +1,104 @@
+#include <algorithm>
+
+#include "calc/session.h"
+#include "calc/compare.h"
+
+namespace kfc {
+
+    ScoringSession::ScoringSession(size_t bufferFrames, float resampleRate, int historyWindow) :
+        _features(bufferFrames, resampleRate),
+        _templateRevision(0),
+        _seenGaps(0),
+        _activityGating(false),
+        _idleInterval(0),
+        _lastCompareTime(0),
+        _lastSlotTime(0),
+        _seenTransitions(0),
+        _lastProcessed(0.0f),
+        _stats(historyWindow) {}
+
+    size_t ScoringSession::addFrame(const FrameData& frame, std::vector<RepEvent>& reps) {
+        const auto& features = _features.getFeatures();
+        size_t added = std::min(_features.addFrame(frame), features.size());
+
+        if (_repCounter) {
+            RepEvent event;
+            // 重复动作不跨输入间断计数
+            if (_features.getGaps() != _seenGaps && _repCounter->breakSequence(event)) {
+                reps.push_back(event);
+            }
+            for (size_t k = features.size() - added; k < features.size(); ++k) {
+                if (_repCounter->push(features[k], event)) {
+                    reps.push_back(event);
+                }
+            }
+        }
+        _seenGaps = _features.getGaps();
+        return added;
+    }
+
+    ScoreTrigger ScoringSession::nextTrigger(INT64 timestamp, INT64 compareInterval) {
+        if (_features.getFeatures().empty()) {
+            return ScoreTrigger::None;
+        }
+
+        const auto& activity = _features.getActivity();
+        ScoreTrigger trigger = ScoreTrigger::None;
+        if (_activityGating && activity.getTransitions() != _seenTransitions) {
+            trigger = activity.isActive() ? ScoreTrigger::Onset : ScoreTrigger::Offset;
+        } else if (timestamp - _lastSlotTime >= compareInterval) {
+            _lastSlotTime = timestamp;
+            const bool idle = _activityGating && !activity.isActive();
+            trigger = idle && timestamp - _lastCompareTime < _idleInterval ? ScoreTrigger::Gated : ScoreTrigger::Interval;
+        }
+        _seenTransitions = activity.getTransitions();
+
+        if (ShouldScore(trigger)) {
+            _lastCompareTime = timestamp;
+            _lastSlotTime = timestamp;
+        }
+        return trigger;
+    }
+
+    void ScoringSession::setTemplate(const ActionTemplate& actionTemplate, const ScoringParams& params) {
+        _repCounter = std::make_unique<RepCounter>(actionTemplate.getSharedFeatures(), params);
+        _templateRevision = actionTemplate.getRevision();
+        _activityGating = params.activityGating;
+        _idleInterval = params.idleCompareInterval;
+        _features.getActivity().setThresholds(params.activityOnsetEnergy, params.activityOffsetEnergy);
+    }
+
+    void ScoringSession::resetInput() {
+        _features.clear();
+        _repCounter.reset();
+        _lastCompareTime = 0;
+        _lastSlotTime = 0;
+        _seenTransitions = _features.getActivity().getTransitions();
+    }
+
+    float ScoringSession::score(const std::vector<FrameFeature>& features, float averageSpeed,
+                                const ActionTemplate& actionTemplate, const ScoringParams& params, INT64 timestamp) {
+        float raw = 0.0f;
+        float processed = compareFeatureSequence(features, averageSpeed, actionTemplate, params, _workspace, &raw);
+        // 比较失败时也参与平滑，上一次的分数随之逐步衰减
+        float similarity = smooth(raw, processed);
+        if (similarity > 0.0f) {
+            _stats.add(similarity, timestamp);
+        }
+        return similarity;
+    }
+
+    float ScoringSession::scoreCurrent(const ActionTemplate& actionTemplate, const ScoringParams& params, INT64 timestamp) {
+        return score(_features.snapshot(), _features.averageSpeed(), actionTemplate, params, timestamp);
+    }
+
+    float ScoringSession::smooth(float rawSimilarity, float processed) {
+        if (rawSimilarity < 0.3f) {
+            _lastProcessed = _lastProcessed * 0.7f + processed * 0.3f;
+        } else {
+            _lastProcessed = _lastProcessed * 0.3f + processed * 0.7f;
+        }
+        return _lastProcessed;
+    }
+
+} // namespace kfc
@@ -0,0 +1,263 @@
+#include <algorithm>
+#include <cmath>
+
+#include "calc/stats.h"
+#include "core/common.h"
+
+namespace kfc {
+
+    static constexpr INT64 kTicksPerMinute = 60LL * 10000000LL;   // 100ns 单位
+    static constexpr size_t kMaxMinutes = 120;                     // 每分钟统计只保留最近两小时
+
+    RollingStats::RollingStats(int window) :
+        _values(window > 0 ? static_cast<size_t>(window) : 0),
+        _window(window),
+        _count(0),
+        _mean(0.0),
+        _m2(0.0) {}
+
+    void RollingStats::add(float value) {
+        const double x = value;
+
+        if (_window > 0 && _values.size() >= static_cast<size_t>(_window)) {
+            // 窗口已满：用新值替换最旧的值，均值与平方和增量更新
+            const double y = _values.front();
+            _values.pop_front();
+            const double oldMean = _mean;
+            _mean += (x - y) / static_cast<double>(_count);
+            _m2 += (x - y) * (x - _mean + y - oldMean);
+            _m2 = std::max(0.0, _m2);
+        } else {
+            // Welford 增量
+            ++_count;
+            const double delta = x - _mean;
+            _mean += delta / static_cast<double>(_count);
+            _m2 += delta * (x - _mean);
+        }
+
+        if (_window > 0) {
+            _values.push_back(value);
+        }
+    }
+
+    void RollingStats::reset() {
+        _values.clear();
+        _count = 0;
+        _mean = 0.0;
+        _m2 = 0.0;
+    }
+
+    float RollingStats::variance() const {
+        return _count > 1 ? static_cast<float>(_m2 / static_cast<double>(_count - 1)) : 0.0f;
+    }
+
+    float RollingStats::stddev() const {
+        return std::sqrt(variance());
+    }
+
+    P2Quantile::P2Quantile(double p) : _p(p) {
+        reset();
+    }
+
+    void P2Quantile::reset() {
+        _heights.fill(0.0);
+        _positions = { 1.0, 2.0, 3.0, 4.0, 5.0 };
+        _desired = { 1.0, 1.0 + 2.0 * _p, 1.0 + 4.0 * _p, 3.0 + 2.0 * _p, 5.0 };
+        _increments = { 0.0, _p / 2.0, _p, (1.0 + _p) / 2.0, 1.0 };
+        _count = 0;
+    }
+
+    double P2Quantile::parabolic(int i, double d) const {
+        const auto& q = _heights;
+        const auto& n = _positions;
+        return q[i] + d / (n[i + 1] - n[i - 1]) *
+            ((n[i] - n[i - 1] + d) * (q[i + 1] - q[i]) / (n[i + 1] - n[i]) +
+             (n[i + 1] - n[i] - d) * (q[i] - q[i - 1]) / (n[i] - n[i - 1]));
+    }
+
+    double P2Quantile::linear(int i, int d) const {
+        return _heights[i] + d * (_heights[i + d] - _heights[i]) / (_positions[i + d] - _positions[i]);
+    }
+
+    void P2Quantile::add(double value) {
+        // 前 5 个数据直接保存，凑齐后排序作为初始标记
+        if (_count < 5) {
+            _heights[_count++] = value;
+            if (_count == 5) {
+                std::sort(_heights.begin(), _heights.end());
+            }
+            return;
+        }
+        ++_count;
+
+        int k;
+        if (value < _heights[0]) {
+            _heights[0] = value;
+            k = 0;
+        } else if (value >= _heights[4]) {
+            _heights[4] = value;
+            k = 3;
+        } else {
+            k = 0;
+            while (k < 3 && value >= _heights[k + 1]) {
+                ++k;
+            }
+        }
+
+        for (int i = k + 1; i < 5; ++i) {
+            _positions[i] += 1.0;
+        }
+        for (int i = 0; i < 5; ++i) {
+            _desired[i] += _increments[i];
+        }
+
+        // 调整中间三个标记
+        for (int i = 1; i <= 3; ++i) {
+            const double d = _desired[i] - _positions[i];
+            if ((d >= 1.0 && _positions[i + 1] - _positions[i] > 1.0) ||
+                (d <= -1.0 && _positions[i - 1] - _positions[i] < -1.0)) {
+                const int step = d >= 0.0 ? 1 : -1;
+                const double candidate = parabolic(i, step);
+                if (_heights[i - 1] < candidate && candidate < _heights[i + 1]) {
+                    _heights[i] = candidate;
+                } else {
+                    _heights[i] = linear(i, step);
+                }
+                _positions[i] += step;
+            }
+        }
+    }
+
+    double P2Quantile::value() const {
+        if (_count == 0) {
+            return 0.0;
+        }
+        if (_count >= 5) {
+            return _heights[2];
+        }
+
+        std::array<double, 5> sorted = _heights;
+        std::sort(sorted.begin(), sorted.begin() + _count);
+        const size_t index = static_cast<size_t>(std::lround(_p * static_cast<double>(_count - 1)));
+        return sorted[index];
+    }
+
+    SessionStats::SessionStats(int window) :
+        _window(window),
+        _session(0),
+        _p10(0.1),
+        _p50(0.5),
+        _p90(0.9),
+        _startTime(0),
+        _lastTime(0),
+        _current(0.0f),
+        _min(0.0f),
+        _max(0.0f),
+        _minutes(kMaxMinutes),
+        _snapshot(std::make_shared<SessionSnapshot>()),
+        _dirty(false) {}
+
+    void SessionStats::add(float value, INT64 timestamp) {
+        std::lock_guard<std::mutex> lock(_writeMutex);
+
+        if (_session.count() == 0) {
+            _startTime = timestamp;
+            _min = value;
+            _max = value;
+        }
+
+        _window.add(value);
+        _session.add(value);
+        _p10.add(value);
+        _p50.add(value);
+        _p90.add(value);
+        _min = std::min(_min, value);
+        _max = std::max(_max, value);
+
+        // 时间戳回退（传感器重启、回放从头开始）时重新对齐起点，从当前分钟继续，分钟序号保持单调
+        if (timestamp < _lastTime && !_minutes.empty()) {
+            _startTime = timestamp - static_cast<INT64>(_minutes.back().minute) * kTicksPerMinute;
+        }
+        _lastTime = timestamp;
+
+        // 每分钟统计，超过 kMaxMinutes 个桶时丢弃最旧的一分钟
+        const int minute = static_cast<int>(std::max<INT64>(0, timestamp - _startTime) / kTicksPerMinute);
+        if (_minutes.empty() || _minutes.back().minute != minute) {
+            if (_minutes.size() >= kMaxMinutes) {
+                _minutes.pop_front();
+            }
+            _minutes.push_back(MinuteBucket{ minute, 0, 0.0f, value, value });
+        }
+        auto& bucket = _minutes.back();
+        ++bucket.count;
+        bucket.mean += (value - bucket.mean) / static_cast<float>(bucket.count);
+        bucket.min = std::min(bucket.min, value);
+        bucket.max = std::max(bucket.max, value);
+
+        _current = value;
+        _dirty = true;
+    }
+
+    void SessionStats::reset() {
+        std::lock_guard<std::mutex> lock(_writeMutex);
+        _window.reset();
+        _session.reset();
+        _p10.reset();
+        _p50.reset();
+        _p90.reset();
+        _startTime = 0;
+        _lastTime = 0;
+        _min = 0.0f;
+        _max = 0.0f;
+        _minutes.clear();
+        _current = 0.0f;
+        _snapshot = std::make_shared<SessionSnapshot>();
+        _dirty = false;
+    }
+
+    std::shared_ptr<const SessionSnapshot> SessionStats::snapshot() const {
+        std::lock_guard<std::mutex> lock(_writeMutex);
+        if (!_dirty) {
+            return _snapshot;
+        }
+
+        // 生成新快照后整体替换，已发出的快照不受影响
+        auto snapshot = std::make_shared<SessionSnapshot>();
+        snapshot->count = _session.count();
+        snapshot->current = _current;
+        snapshot->windowMean = _window.mean();
+        snapshot->windowStdDev = _window.stddev();
+        snapshot->sessionMean = _session.mean();
+        snapshot->min = _min;
+        snapshot->max = _max;
+        snapshot->p10 = static_cast<float>(_p10.value());
+        snapshot->p50 = static_cast<float>(_p50.value());
+        snapshot->p90 = static_cast<float>(_p90.value());
+        snapshot->minutes.reserve(_minutes.size());
+        for (const auto& bucket : _minutes) {
+            snapshot->minutes.push_back(bucket);
+        }
+        _snapshot = std::move(snapshot);
+        _dirty = false;
+        return _snapshot;
+    }
+
+    void logSessionSummary(const SessionSnapshot& snapshot) {
+        if (snapshot.count == 0) {
+            return;
+        }
+
+        LOG_I("Session: {} scores, mean {:.1f}%, window {:.1f}% ± {:.1f}%, min {:.1f}%, max {:.1f}%",
+              snapshot.count, snapshot.sessionMean * 100.0f,
+              snapshot.windowMean * 100.0f, snapshot.windowStdDev * 100.0f,
+              snapshot.min * 100.0f, snapshot.max * 100.0f);
+        LOG_I("Session quantiles: p10 {:.1f}%, p50 {:.1f}%, p90 {:.1f}%",
+              snapshot.p10 * 100.0f, snapshot.p50 * 100.0f, snapshot.p90 * 100.0f);
+        for (const auto& bucket : snapshot.minutes) {
+            LOG_I("  minute {}: {} scores, mean {:.1f}%, min {:.1f}%, max {:.1f}%",
+                  bucket.minute, bucket.count, bucket.mean * 100.0f,
+                  bucket.min * 100.0f, bucket.max * 100.0f);
+        }
+    }
+
+} // namespace kfc
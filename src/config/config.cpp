@@ -66,17 +66,11 @@ bool Config::Read(const std::string& filename, std::map<std::string, std::string
     return true;
 }
 
-bool Config::Init(const std::string& configPath) {
-    auto& config = getInstance();
-    std::map<std::string, std::string> configMap;
-    
-    if (!Read(configPath, configMap)) {
-        LOG_E("Failed to read config file");
-        return false;
-    }
-    
+void Config::Apply(const std::map<std::string, std::string>& configMap, Config& config,
+                   std::map<std::string, std::string>* applied) {
     for (const auto& [key, value] : configMap) {
         try {
+            bool known = true;
             switch (hash_str(key.c_str(), key.length())) {
             case "window.width"_hash:
                 config.windowWidth = std::stoi(value);
@@ -93,6 +87,9 @@ bool Config::Init(const std::string& configPath) {
             case "fps.compare"_hash:
                 config.compareFPS = std::stoi(value);
                 break;
+            case "fps.resample"_hash:
+                config.resampleFPS = std::stoi(value);
+                break;
             case "action.standardPath"_hash:
                 config.standardPath = value;
                 break;
@@ -120,13 +117,74 @@ bool Config::Init(const std::string& configPath) {
             case "similarity.difficulty"_hash:
                 config.difficulty = std::stoi(value);
                 break;
+            case "similarity.fastMath"_hash:
+                config.fastMath = value == "true" || value == "1";
+                break;
             case "similarity.similarityHistorySize"_hash:
                 config.similarityHistorySize = std::stoi(value);
                 break;
+            case "rep.threshold"_hash:
+                config.repThreshold = std::stof(value);
+                break;
+            case "rep.minLengthRatio"_hash:
+                config.repMinLengthRatio = std::stof(value);
+                break;
+            case "filter.smoothing"_hash:
+                config.filterSmoothing = std::stof(value);
+                break;
+            case "activity.enabled"_hash:
+                config.activityGating = value == "true" || value == "1";
+                break;
+            case "activity.onsetEnergy"_hash:
+                config.activityOnsetEnergy = std::stof(value);
+                break;
+            case "activity.offsetEnergy"_hash:
+                config.activityOffsetEnergy = std::stof(value);
+                break;
+            case "activity.idleFPS"_hash:
+                config.idleCompareFPS = std::stoi(value);
+                break;
+            case "governor.enabled"_hash:
+                config.governorEnabled = value == "true" || value == "1";
+                break;
+            case "governor.budget"_hash:
+                config.governorBudgetMs = std::stof(value);
+                break;
+            case "metrics.path"_hash:
+                config.metricsPath = value;
+                break;
+            case "metrics.interval"_hash:
+                config.metricsInterval = std::stoi(value);
+                break;
+            case "trace.path"_hash:
+                config.tracePath = value;
+                break;
+            case "server.host"_hash:
+                config.serverHost = value;
+                break;
+            case "server.port"_hash:
+                config.serverPort = std::stoi(value);
+                break;
+            case "server.workers"_hash:
+                config.serverWorkers = std::stoi(value);
+                break;
+            case "server.maxSessions"_hash:
+                config.serverMaxSessions = std::stoi(value);
+                break;
+            case "server.idleTimeout"_hash:
+                config.serverIdleTimeout = std::stoi(value);
+                break;
+            case "log.level"_hash:
+                Logger::SetLevel(value);
+                break;
             default:
                 LOG_W("Unknown config key: {}", key);
+                known = false;
                 break;
             }
+            if (known && applied) {
+                (*applied)[key] = value;
+            }
         } catch (const std::exception& e) {
             LOG_E("Error parsing config value for {}: {}", key, e.what());
         }
@@ -138,6 +196,7 @@ bool Config::Init(const std::string& configPath) {
     config.displayFPS = std::max(30, std::min(120, config.displayFPS));
     config.recordFPS = std::max(10, std::min(60, config.recordFPS));
     config.compareFPS = std::max(1, std::min(30, config.compareFPS));
+    config.resampleFPS = config.resampleFPS <= 0 ? 0 : std::max(5, std::min(60, config.resampleFPS));
     config.actionBufferSize = std::max(20, std::min(300, config.actionBufferSize));
     
     config.speedWeight = std::max(0.0f, std::min(1.0f, config.speedWeight));
@@ -146,15 +205,47 @@ bool Config::Init(const std::string& configPath) {
     config.minSpeedPenalty = std::max(0.0f, std::min(1.0f, config.minSpeedPenalty));
     config.dtwBandwidthRatio = std::max(0.1f, std::min(1.0f, config.dtwBandwidthRatio));
     config.similarityThreshold = std::max(0.0f, std::min(1.0f, config.similarityThreshold));
+    config.repThreshold = std::max(0.01f, std::min(1.0f, config.repThreshold));
+    config.repMinLengthRatio = std::max(0.1f, std::min(1.0f, config.repMinLengthRatio));
+    config.filterSmoothing = std::max(0.0f, std::min(0.95f, config.filterSmoothing));
+    config.activityOnsetEnergy = std::max(0.0f, config.activityOnsetEnergy);
+    config.activityOffsetEnergy = std::max(0.0f, std::min(config.activityOnsetEnergy, config.activityOffsetEnergy));
+    config.idleCompareFPS = std::max(1, std::min(config.compareFPS, config.idleCompareFPS));
+    config.governorBudgetMs = std::max(0.0f, std::min(1000.0f, config.governorBudgetMs));
+    config.metricsInterval = std::max(1, std::min(3600, config.metricsInterval));
+    config.serverPort = std::max(1024, std::min(65535, config.serverPort));
+    config.serverWorkers = std::max(0, std::min(64, config.serverWorkers));
+    config.serverMaxSessions = std::max(1, std::min(1024, config.serverMaxSessions));
+    config.serverIdleTimeout = std::max(0, std::min(3600, config.serverIdleTimeout));
+}
+
+void Config::PublishScoringParams(const Config& source) {
+    auto& config = getInstance();
+    const uint64_t version = config.getScoringParams()->version + 1;
+    std::shared_ptr<const ScoringParams> params = std::make_shared<const ScoringParams>(ScoringParams::FromConfig(source, version));
+    std::atomic_store(&config.scoringParams, std::move(params));
+}
+
+bool Config::Init(const std::string& configPath) {
+    auto& config = getInstance();
+    std::map<std::string, std::string> configMap;
+    
+    if (!Read(configPath, configMap)) {
+        LOG_E("Failed to read config file");
+        return false;
+    }
+    
+    Apply(configMap, config, &config.appliedValues);
+    PublishScoringParams(config);
     
     LOG_I("Configuration loaded:\n"
           "  Window: {}x{}\n"
-          "  FPS: display={}, record={}, compare={}\n"
+          "  FPS: display={}, record={}, compare={}, resample={}\n"
           "  Standard action: {}\n"
           "  Similarity: weight={:.2f}, speedRatio={:.2f}-{:.2f}, penalty={:.2f}, "
           "bandWidth={:.2f}, threshold={:.2f}",
           config.windowWidth, config.windowHeight,
-          config.displayFPS, config.recordFPS, config.compareFPS,
+          config.displayFPS, config.recordFPS, config.compareFPS, config.resampleFPS,
           config.standardPath,
           config.speedWeight, config.minSpeedRatio, config.maxSpeedRatio,
           config.minSpeedPenalty, config.dtwBandwidthRatio, config.similarityThreshold);
@@ -169,5 +260,36 @@ bool Config::Init(const std::string& configPath) {
     return true;
 }
 
+bool Config::Reload(const std::string& configPath) {
+    std::map<std::string, std::string> configMap;
+    if (!Read(configPath, configMap)) {
+        LOG_E("Failed to reload config file");
+        return false;
+    }
+
+    // 在临时配置上先重放当前生效的项，再解析新文件：写了一半的文件中缺失或无法解析的项保持原值，
+    // 不会退回缺省值；单例中的其余字段保持启动时的值
+    auto& config = getInstance();
+    for (const auto& [key, value] : config.appliedValues) {
+        if (configMap.find(key) == configMap.end()) {
+            LOG_W("Config key {} missing on reload, keeping {}", key, value);
+        }
+    }
+    Config fresh;
+    Apply(config.appliedValues, fresh);
+    auto applied = config.appliedValues;
+    Apply(configMap, fresh, &applied);
+    PublishScoringParams(fresh);
+    config.appliedValues = std::move(applied);
+
+    const auto params = getInstance().getScoringParams();
+    LOG_I("Scoring parameters reloaded (v{}): weight={:.2f}, speedRatio={:.2f}-{:.2f}, penalty={:.2f}, "
+          "bandWidth={:.2f}, threshold={:.2f}, difficulty={}, fastMath={}",
+          params->version, params->speedWeight, params->minSpeedRatio, params->maxSpeedRatio,
+          params->minSpeedPenalty, params->dtwBandwidthRatio, params->similarityThreshold, params->difficulty,
+          params->fastMath);
+    return true;
+}
+
 } // namespace kfc
 
@@ -0,0 +1,49 @@
+#include "config/params.h"
+#include "config/config.h"
+
+namespace kfc {
+
+    ScoringParams ScoringParams::FromConfig(const Config& config, uint64_t version) {
+        ScoringParams params;
+        params.version = version;
+
+        params.speedWeight = config.speedWeight;
+        params.frameWeight = 1.0f - config.speedWeight;
+        params.minSpeedRatio = config.minSpeedRatio;
+        params.maxSpeedRatio = config.maxSpeedRatio;
+        params.invMinSpeedRatio = 1.0f / config.minSpeedRatio;
+        params.invMaxSpeedRatio = 1.0f / config.maxSpeedRatio;
+        params.minSpeedPenalty = config.minSpeedPenalty;
+        params.speedPenaltyRange = 1.0f - config.minSpeedPenalty;
+
+        params.dtwBandwidthRatio = config.dtwBandwidthRatio;
+        params.sequenceStride = 1;
+        params.dtwSchedule = DtwSchedule::Auto;
+        params.similarityThreshold = config.similarityThreshold;
+        params.fastMath = config.fastMath;
+
+        const float factor = (config.difficulty - 3) * 0.1f;
+        params.difficulty = config.difficulty;
+        params.difficultyFactor = factor;
+        params.basePunishment = 0.4f * (1.0f + factor);     // 基础惩罚随难度调整
+        params.stretchFactor = 1.3f * (1.0f - factor);      // 拉伸系数随难度调整
+        params.mappingRange = 4.5f * (1.0f - factor);       // 映射范围随难度调整
+        params.finalPower = 1.2f * (1.0f + factor);         // 最终幂次随难度调整
+        params.lowSegmentScale = 0.45f * (1.0f + factor);   // 低分段惩罚随难度增加
+        params.midSegmentScale = 0.8f * (1.0f - factor);    // 中等分段惩罚随难度增加
+        params.highSegmentScale = 0.75f * (1.0f - factor);  // 高分段奖励随难度减少
+
+        params.repThreshold = config.repThreshold;
+        params.repMinLengthRatio = config.repMinLengthRatio;
+        params.filterSmoothing = config.filterSmoothing;
+
+        params.activityGating = config.activityGating;
+        params.activityOnsetEnergy = config.activityOnsetEnergy;
+        params.activityOffsetEnergy = config.activityOffsetEnergy;
+        params.idleCompareInterval = static_cast<int64_t>(10000000.0 / config.idleCompareFPS);
+
+        params.governorBudget = config.getGovernorBudget();
+        return params;
+    }
+
+} // namespace kfc
@@ -0,0 +1,76 @@
+#include <chrono>
+
+#include "config/watcher.h"
+#include "config/config.h"
+#include "log/logger.h"
+
+namespace kfc {
+
+    static constexpr auto kPollInterval = std::chrono::seconds(1);
+
+    ConfigWatcher& ConfigWatcher::getInstance() {
+        static ConfigWatcher instance;
+        return instance;
+    }
+
+    ConfigWatcher::ConfigWatcher() :
+        _running(false) {}
+
+    ConfigWatcher::~ConfigWatcher() {
+        stop();
+    }
+
+    void ConfigWatcher::start(const std::string& path) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_running) {
+            return;
+        }
+
+        std::error_code ec;
+        _path = path;
+        _lastWrite = std::filesystem::last_write_time(path, ec);
+        if (ec) {
+            LOG_W("Config watcher: cannot stat {}: {}", path, ec.message());
+        }
+
+        _running = true;
+        _thread = std::thread(&ConfigWatcher::run, this);
+    }
+
+    void ConfigWatcher::stop() {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (!_running) {
+                return;
+            }
+            _running = false;
+        }
+        _wake.notify_all();
+        if (_thread.joinable()) {
+            _thread.join();
+        }
+    }
+
+    void ConfigWatcher::run() {
+        std::unique_lock<std::mutex> lock(_mutex);
+        while (_running) {
+            _wake.wait_for(lock, kPollInterval, [this]() { return !_running; });
+            if (!_running) {
+                break;
+            }
+
+            std::error_code ec;
+            const auto lastWrite = std::filesystem::last_write_time(_path, ec);
+            if (ec || lastWrite == _lastWrite) {
+                continue;
+            }
+            _lastWrite = lastWrite;
+
+            // 编辑器保存时文件可能尚未写完，解析失败的值会被忽略并在下次保存时重试
+            lock.unlock();
+            Config::Reload(_path);
+            lock.lock();
+        }
+    }
+
+} // namespace kfc
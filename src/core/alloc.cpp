@@ -0,0 +1,84 @@
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "core/alloc.h"
+
+namespace kfc {
+
+    static std::atomic<bool> g_countingEnabled{ false };
+    static std::atomic<uint64_t> g_allocationCount{ 0 };
+    static std::atomic<uint64_t> g_allocationBytes{ 0 };
+
+    void SetAllocationCounting(bool enabled) {
+        if (enabled) {
+            g_allocationCount.store(0, std::memory_order_relaxed);
+            g_allocationBytes.store(0, std::memory_order_relaxed);
+        }
+        g_countingEnabled.store(enabled, std::memory_order_release);
+    }
+
+    AllocationCount GetAllocationCount() {
+        return AllocationCount{ g_allocationCount.load(std::memory_order_relaxed),
+                                g_allocationBytes.load(std::memory_order_relaxed) };
+    }
+
+#if KF_ALLOC_HOOKS
+    static void* Allocate(std::size_t size) noexcept {
+        if (g_countingEnabled.load(std::memory_order_relaxed)) {
+            g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+            g_allocationBytes.fetch_add(size, std::memory_order_relaxed);
+        }
+        return std::malloc(size > 0 ? size : 1);
+    }
+#endif
+
+} // namespace kfc
+
+#if KF_ALLOC_HOOKS
+
+void* operator new(std::size_t size) {
+    void* p = kfc::Allocate(size);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return kfc::Allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return kfc::Allocate(size);
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+    std::free(p);
+}
+
+#endif // KF_ALLOC_HOOKS
@@ -21,7 +21,6 @@ Application::Application() :
     m_nNextStatusTime(0LL),
     m_pKinectSensor(NULL),
     m_pCoordinateMapper(NULL),
-    m_pBodyFrameReader(NULL),
     m_pD2DFactory(NULL),
     m_pRenderTarget(NULL),
     m_pBrushJointTracked(NULL),
@@ -45,14 +44,17 @@ Application::Application() :
     m_pBrushBoneTemplate(nullptr),
     c_BoneThickness(4.0f),
     m_fCurrentSimilarity(0.0f),
-    m_fTotalSimilarity(0.0f),
-    m_nSimilarityCount(0),
-    m_similarityHistory(kfc::Config::getInstance().similarityHistorySize > 0 ? 
-                       kfc::Config::getInstance().similarityHistorySize : 100),  // 如果配置小于等于0，设置一个初始容量
-    m_historyIndex(0),
     m_similarityMutex(),
     m_similarityCV(),
-    m_similarityUpdated(false)
+    m_similarityUpdated(false),
+    m_nRepCount(0),
+    m_fLastRepScore(0.0f),
+    m_fTemplatePhase(-1.0f),
+    m_pBodyRing(std::make_unique<kfc::BodyFrameRing>()),
+    m_pRenderCursor(nullptr),
+    m_pRecordCursor(nullptr),
+    m_bRecorderRunning(false),
+    m_latestBodies()
 {
     LARGE_INTEGER qpf = {0};
     if (QueryPerformanceFrequency(&qpf)) {
@@ -61,6 +63,13 @@ Application::Application() :
 
     // 分配颜色帧缓冲区
     m_pColorRGBX = new RGBQUAD[cColorWidth * cColorHeight];
+
+    // 注册骨骼帧消费者
+    m_pRenderCursor = m_pBodyRing->subscribe(kfc::RingPolicy::Overwrite);
+    m_pRecordCursor = m_pBodyRing->subscribe(kfc::RingPolicy::Overwrite);
+    m_pPipeline = std::make_unique<kfc::Pipeline>(*m_pBodyRing, kfc::RingPolicy::Overwrite,
+        [this](const kfc::PipelineResult& result) { OnPipelineResult(result); });
+    m_pPipeline->setActive(false);
 }
   
 
@@ -69,13 +78,25 @@ Application::Application() :
 /// </summary>
 Application::~Application()
 {
+    // 先停止采集，再排空评分流水线
+    m_bodySource.stop();
+    m_pPipeline->stop();
+
+    // 停止录制线程
+    m_bRecorderRunning.store(false, std::memory_order_release);
+    if (m_recordThread.joinable()) {
+        m_recordThread.join();
+    }
+    m_pBodyRing->unsubscribe(*m_pRecordCursor);
+    m_pBodyRing->unsubscribe(*m_pRenderCursor);
+
     DiscardDirect2DResources();
 
     // clean up Direct2D
     SafeRelease(m_pD2DFactory);
 
     // done with body frame reader
-    SafeRelease(m_pBodyFrameReader);
+    m_bodySource.close();
 
     // done with coordinate mapper
     SafeRelease(m_pCoordinateMapper);
@@ -104,7 +125,7 @@ Application::~Application()
 
 void Application::HandlePaint()
 {
-    if (!m_pBodyFrameReader || !m_hWnd) {
+    if (!m_bodySource.isOpen() || !m_hWnd) {
         return;
     }
     HRESULT hr = EnsureDirect2DResources();
@@ -120,6 +141,8 @@ void Application::HandlePaint()
     if (deltaTime < targetFrameTime) {
         return;
     }
+    kfc::ScopedLatency renderTimer(kfc::Metric_Render);
+    KF_TRACE_SCOPE("HandlePaint");
 
     // 获取视频区域的位置和大小
     RECT rc;
@@ -197,14 +220,28 @@ void Application::HandlePaint()
                 WCHAR similarityText[64];
                 swprintf_s(similarityText, L"Similarity: %.1f%%", displayedSimilarity * 100.0f);
                 
-                // 获取总准确率
-                float totalSimilarity = m_fTotalSimilarity.load(std::memory_order_relaxed);
-                int similarityCount = m_nSimilarityCount.load(std::memory_order_relaxed);
-                float averageSimilarity = similarityCount > 0 ? (totalSimilarity / similarityCount) : 0.0f;
+                // 获取总准确率（同一快照中的窗口均值与标准差）
+                const auto stats = m_pPipeline->getSessionStats();
                 
                 // 准备总准确率文本
                 WCHAR averageText[64];
-                swprintf_s(averageText, L"Average: %.1f%%", averageSimilarity * 100.0f);
+                swprintf_s(averageText, L"Average: %.1f%% (\u00B1%.1f)",
+                    stats->windowMean * 100.0f, stats->windowStdDev * 100.0f);
+
+                // 准备重复计数文本
+                WCHAR repText[64];
+                swprintf_s(repText, L"Reps: %d (last %.1f%%)",
+                    m_nRepCount.load(std::memory_order_relaxed),
+                    m_fLastRepScore.load(std::memory_order_relaxed) * 100.0f);
+
+                // 准备动作阶段文本（姿态索引估计，无可信匹配时不显示数值）
+                WCHAR phaseText[64];
+                const float phase = m_fTemplatePhase.load(std::memory_order_relaxed);
+                if (phase >= 0.0f) {
+                    swprintf_s(phaseText, L"Phase: %.0f%%", phase * 100.0f);
+                } else {
+                    swprintf_s(phaseText, L"Phase: --");
+                }
                 
                 // 创建半透明黑色背景
                 ID2D1SolidColorBrush* pBackgroundBrush = nullptr;
@@ -216,7 +253,7 @@ void Application::HandlePaint()
                 if (SUCCEEDED(hr) && pBackgroundBrush) {
                     // 绘制相似度和总准确率背景
                     m_pRenderTarget->FillRectangle(
-                        D2D1::RectF(5.0f, 45.0f, 305.0f, 125.0f),  // 增加高度以容纳两行文本
+                        D2D1::RectF(5.0f, 45.0f, 365.0f, 205.0f),  // 增加高度以容纳四行文本
                         pBackgroundBrush
                     );
                     // 绘制相似度文本
@@ -233,6 +270,20 @@ void Application::HandlePaint()
                         D2D1::RectF(10.0f, 90.0f, 300.0f, 130.0f),
                         m_pBrush
                     );
+                    // 绘制重复计数文本
+                    m_pRenderTarget->DrawText(
+                        repText, wcslen(repText),
+                        pTextFormat,
+                        D2D1::RectF(10.0f, 130.0f, 360.0f, 170.0f),
+                        m_pBrush
+                    );
+                    // 绘制动作阶段文本
+                    m_pRenderTarget->DrawText(
+                        phaseText, wcslen(phaseText),
+                        pTextFormat,
+                        D2D1::RectF(10.0f, 170.0f, 360.0f, 210.0f),
+                        m_pBrush
+                    );
                     SafeRelease(pBackgroundBrush);
                 }
             }
@@ -261,6 +312,7 @@ void Application::HandlePaint()
 /// <param name="nCmdShow">whether to display minimized, maximized, or normally</param>
 int Application::Run(HINSTANCE hInstance, int nCmdShow)
 {
+    kfc::Tracer::getInstance().setThreadName("ui");
     MSG msg = {0};
     WNDCLASS wc;
 
@@ -354,6 +406,14 @@ int Application::Run(HINSTANCE hInstance, int nCmdShow)
         SWP_NOMOVE | SWP_NOZORDER
     );
 
+    // 启动录制线程，磁盘写入不再占用界面线程
+    m_bRecorderRunning.store(true, std::memory_order_release);
+    m_recordThread = std::thread(&Application::RecordLoop, this);
+
+    // 启动评分流水线与骨骼采集线程，评分节奏与界面消息循环无关
+    m_pPipeline->start();
+    m_bodySource.start(*m_pBodyRing, [this]() { m_pPipeline->notify(); });
+
     // 显示窗口
     ShowWindow(hWndApp, nCmdShow);
     UpdateWindow(hWndApp);
@@ -404,7 +464,8 @@ int Application::Run(HINSTANCE hInstance, int nCmdShow)
 /// </summary>
 void Application::Update()
 {
-    if (!m_pColorFrameReader || !m_pBodyFrameReader) {
+    KF_TRACE_SCOPE("Update");
+    if (!m_pColorFrameReader || !m_bodySource.isOpen()) {
         LOG_E("Update return");
         return;
     }
@@ -441,16 +502,46 @@ void Application::Update()
         }
 
         if (SUCCEEDED(hr)) {
-            if (imageFormat == ColorImageFormat_Bgra) {
-                hr = pColorFrame->AccessRawUnderlyingBuffer(&nBufferSize, reinterpret_cast<BYTE**>(&pBuffer));
+            // 转换的同时缩放到显示区域大小，只上传显示所需的像素
+            int viewWidth = nWidth;
+            int viewHeight = nHeight;
+            if (m_pRenderTarget) {
+                D2D1_SIZE_U targetSize = m_pRenderTarget->GetPixelSize();
+                kfc::FitColorSize(nWidth, nHeight, targetSize.width, targetSize.height, viewWidth, viewHeight);
+            }
+            m_colorConverter.configure(nWidth, nHeight, viewWidth, viewHeight);
+            m_colorView.resize(static_cast<size_t>(m_colorConverter.getWidth()) * m_colorConverter.getHeight());
+            uint32_t* pView = reinterpret_cast<uint32_t*>(m_colorView.data());
+
+            BYTE* pRaw = NULL;
+            if (imageFormat == ColorImageFormat_Yuy2) {
+                hr = pColorFrame->AccessRawUnderlyingBuffer(&nBufferSize, &pRaw);
+                if (SUCCEEDED(hr) && nBufferSize >= static_cast<UINT>(nWidth * nHeight * 2)) {
+                    m_colorConverter.convertYUY2(pRaw, pView);
+                } else {
+                    hr = E_FAIL;
+                }
+            } else if (imageFormat == ColorImageFormat_Bgra) {
+                hr = pColorFrame->AccessRawUnderlyingBuffer(&nBufferSize, &pRaw);
+                if (SUCCEEDED(hr) && nBufferSize >= static_cast<UINT>(nWidth * nHeight * sizeof(RGBQUAD))) {
+                    m_colorConverter.convertBGRA(reinterpret_cast<const uint32_t*>(pRaw), pView);
+                } else {
+                    hr = E_FAIL;
+                }
             } else {
                 hr = pColorFrame->CopyConvertedFrameDataToArray(
                     cColorWidth * cColorHeight * sizeof(RGBQUAD),
                     reinterpret_cast<BYTE*>(m_pColorRGBX),
                     ColorImageFormat_Bgra
                 );
-                pBuffer = m_pColorRGBX;
+                if (SUCCEEDED(hr)) {
+                    m_colorConverter.convertBGRA(reinterpret_cast<const uint32_t*>(m_pColorRGBX), pView);
+                }
             }
+
+            pBuffer = m_colorView.data();
+            nWidth = m_colorConverter.getWidth();
+            nHeight = m_colorConverter.getHeight();
         }
         if (SUCCEEDED(hr)) {
             // 先绘制颜色帧
@@ -460,27 +551,8 @@ void Application::Update()
     }
     SafeRelease(pColorFrame);
 
-    // 然后处理骨骼帧
-    IBodyFrame* pBodyFrame = NULL;
-    hr = m_pBodyFrameReader->AcquireLatestFrame(&pBodyFrame);
-    if (SUCCEEDED(hr)) {
-        INT64 nTime = 0;
-        hr = pBodyFrame->get_RelativeTime(&nTime);
-        IBody* ppBodies[BODY_COUNT] = {0};
-
-        if (SUCCEEDED(hr)) {
-            hr = pBodyFrame->GetAndRefreshBodyData(_countof(ppBodies), ppBodies);
-        }
-
-        if (SUCCEEDED(hr)) {
-            ProcessBody(nTime, BODY_COUNT, ppBodies);
-        }
-
-        for (int i = 0; i < _countof(ppBodies); ++i) {
-            SafeRelease(ppBodies[i]);
-        }
-    }
-    SafeRelease(pBodyFrame);
+    // 然后绘制骨骼帧（由采集线程写入环形缓冲）
+    ProcessBody(m_bodySource.getLastFrameTime());
 }
 
 /// <summary>
@@ -596,7 +668,7 @@ LRESULT CALLBACK Application::DlgProc(HWND hWnd, UINT message, WPARAM wParam, LP
         case WM_TIMER:
             if (wParam == 1)  // 我们的更新定时器
             {
-                if (m_pBodyFrameReader)
+                if (m_bodySource.isOpen())
                 {
                     HandlePaint();
                 }
@@ -668,12 +740,7 @@ HRESULT Application::InitializeDefaultSensor()
 
         // 初始化骨骼帧源
         if (SUCCEEDED(hr)) {
-            IBodyFrameSource* pBodyFrameSource = NULL;
-            hr = m_pKinectSensor->get_BodyFrameSource(&pBodyFrameSource);
-            if (SUCCEEDED(hr)) {
-                hr = pBodyFrameSource->OpenReader(&m_pBodyFrameReader);
-            }
-            SafeRelease(pBodyFrameSource);
+            hr = m_bodySource.open(m_pKinectSensor);
         }
 
         // 初始化颜色帧源
@@ -696,13 +763,15 @@ HRESULT Application::InitializeDefaultSensor()
 }
 
 /// <summary>
-/// Handle new body data
-/// <param name="nTime">timestamp of frame</param>
-/// <param name="nBodyCount">body data count</param>
-/// <param name="ppBodies">body data in frame</param>
+/// Draw template and the latest bodies read from the ring
+/// <param name="nTime">timestamp of the latest body frame</param>
 /// </summary>
-void Application::ProcessBody(INT64 nTime, int nBodyCount, IBody** ppBodies) {
+void Application::ProcessBody(INT64 nTime) {
+    KF_TRACE_SCOPE("ProcessBody");
+    // 不计算时也要推进游标，避免重新开始时处理过期帧
     if (!m_pRenderTarget || !m_isCalcing) {
+        kfc::BodyFrame body;
+        while (m_pBodyRing->pop(*m_pRenderCursor, body)) {}
         return;
     }
 
@@ -712,35 +781,22 @@ void Application::ProcessBody(INT64 nTime, int nBodyCount, IBody** ppBodies) {
     int width = rct.right;
     int height = rct.bottom;
 
-    static kfc::ActionBuffer actionBuffer(kfc::Config::getInstance().actionBufferSize);  // 缓冲区
-    static std::future<float> similarityFuture;                // 异步计算相似度任务
-    static std::vector<std::future<void>> saveFutures;         // 保存帧的future列表
-    static INT64 lastRecordedTime = 0;                        // 上次记录时间戳
-    static std::mutex recordMutex;                            // 记录互斥锁
-    static INT64 lastCompareTime = 0;                         // 上次比较时间戳
-    static bool needsUpdate = false;                          // 是否需要更新显示
-
-    // 清理已完成的保存任务
-    saveFutures.erase(
-        std::remove_if(
-            saveFutures.begin(),
-            saveFutures.end(),
-            [](std::future<void>& f) {
-                return f.wait_for(std::chrono::milliseconds(0)) == std::future_status::ready;
-            }
-        ),
-        saveFutures.end()
-    );
-
     // 首先绘制标准动作（如果正在计算相似度）
     if (m_isCalcing) {
         if (!kfc::g_actionTemplate) {
             LOG_E("no actionTemplate");
             return;
         }
-        std::lock_guard<std::mutex> lock(kfc::templateMutex);
+        auto lock = kfc::LockTraced(kfc::templateMutex, "templateMutex.wait");
         const auto& frames = kfc::g_actionTemplate->getFrames();
 
+        // 估计用户当前处于动作的哪个阶段，单独显示，不影响标准动作的播放
+        kfc::PoseMatch match;
+        const size_t resampledCount = kfc::g_actionTemplate->getResampledFrames().size();
+        const bool matched = resampledCount > 1 && EstimateTemplatePhase(nTime, match) && match.frame < resampledCount;
+        m_fTemplatePhase.store(matched ? static_cast<float>(match.frame) / (resampledCount - 1) : -1.0f,
+                               std::memory_order_relaxed);
+
         // 只有在播放状态时才显示标准动作
         if (!frames.empty() && m_isPlayingTemplate) {
             // 初始化播放起点时间
@@ -777,126 +833,147 @@ void Application::ProcessBody(INT64 nTime, int nBodyCount, IBody** ppBodies) {
         }
     }
 
-    if (m_isRecording) {
-        // 创建录制文件名
-        if (m_recordFilePath.empty()) {
-            m_recordFilePath = kfc::generateRecordingPath();
-            LOG_I("Started recording to file: {}", m_recordFilePath);
+    RenderBodies(width, height, nTime);
+}
+
+void Application::OnPipelineResult(const kfc::PipelineResult& result) {
+    if (result.kind == kfc::PipelineResult::Kind::Repetition) {
+        m_nRepCount.store(static_cast<int>(result.rep.index), std::memory_order_relaxed);
+        m_fLastRepScore.store(result.rep.score, std::memory_order_relaxed);
+        LOG_I("Repetition {} completed: {} frames, score {:.1f}%",
+              result.rep.index, result.rep.frameCount, result.rep.score * 100.0f);
+        return;
+    }
+
+    // 会话统计由流水线的评分会话维护
+    m_fCurrentSimilarity.store(result.similarity, std::memory_order_release);
+}
+
+void Application::RenderBodies(int width, int height, INT64 nTime) {
+    // 只保留每个身体槽位的最新一帧，落后的帧直接跳过
+    kfc::BodyFrame body;
+    while (m_pBodyRing->pop(*m_pRenderCursor, body)) {
+        if (body.bodyIndex >= 0 && body.bodyIndex < BODY_COUNT) {
+            m_latestBodies[body.bodyIndex] = body;
         }
     }
 
-    // 遍历每个捕捉到的身体
-    for (int i = 0; i < nBodyCount; ++i) {
-        IBody* pBody = ppBodies[i];
-        if (pBody) {
-            BOOLEAN bTracked = false;
-            HRESULT hr = pBody->get_IsTracked(&bTracked);
+    // 绘制属于最近一次骨骼帧的身体；传感器 30Hz、绘制 60Hz 时重复绘制同一帧
+    for (const auto& latest : m_latestBodies) {
+        if (latest.timestamp != nTime || nTime == 0) {
+            continue;
+        }
 
-            if (SUCCEEDED(hr) && bTracked) {
-                Joint joints[JointType_Count];
-                D2D1_POINT_2F jointPoints[JointType_Count] = {};
-                HandState leftHandState = HandState_Unknown;
-                HandState rightHandState = HandState_Unknown;
+        Joint joints[JointType_Count];
+        D2D1_POINT_2F jointPoints[JointType_Count] = {};
+        for (int j = 0; j < JointType_Count; ++j) {
+            joints[j].JointType = latest.joints[j].type;
+            joints[j].Position = latest.joints[j].position;
+            joints[j].TrackingState = latest.joints[j].trackingState;
+            jointPoints[j] = BodyToScreen(joints[j].Position, width, height);
+        }
 
-                pBody->get_HandLeftState(&leftHandState);
-                pBody->get_HandRightState(&rightHandState);
+        // 绘制骨骼和手部状态
+        DrawBody(joints, jointPoints);
+        DrawHand(latest.leftHandState, jointPoints[JointType_HandLeft]);
+        DrawHand(latest.rightHandState, jointPoints[JointType_HandRight]);
+    }
+}
 
-                hr = pBody->GetJoints(_countof(joints), joints);
-                if (SUCCEEDED(hr)) {
-                    // 转换为 FrameData 并添加到缓冲区
-                    kfc::FrameData frameData;
-                    frameData.timestamp = nTime;
-
-                    for (int j = 0; j < _countof(joints); ++j) {
-                        kfc::JointData data;
-                        data.type = joints[j].JointType;
-                        data.position = joints[j].Position;
-                        data.trackingState = joints[j].TrackingState;
-                        frameData.joints.push_back(data);
-                        jointPoints[j] = BodyToScreen(joints[j].Position, width, height);
-                    }
+bool Application::EstimateTemplatePhase(INT64 nTime, kfc::PoseMatch& match) {
+    const auto& index = kfc::g_actionTemplate->getPoseIndex();
+    if (!index.isBuilt()) {
+        return false;
+    }
 
-                    actionBuffer.addFrame(frameData); // 添加到动作缓冲区
-
-                    // 定期计算相似度
-                    if (nTime - lastCompareTime >= kfc::Config::getInstance().getCompareInterval()) {
-                        lastCompareTime = nTime;
-                        if (kfc::g_actionTemplate) {
-                            // 检查上一次的计算是否完成
-                            if (!similarityFuture.valid() ||
-                                similarityFuture.wait_for(std::chrono::milliseconds(0)) == std::future_status::ready) {
-                                // 如果有上一次的结果，先获取它
-                                if (similarityFuture.valid()) {
-                                    float lastSimilarity = similarityFuture.get();
-                                    m_fCurrentSimilarity.store(lastSimilarity, std::memory_order_release);
-                                    // 更新相似度历史记录
-                                    {
-                                        std::lock_guard<std::mutex> lock(m_historyMutex);
-                                        const int historySize = kfc::Config::getInstance().similarityHistorySize;
-                                        
-                                        if (historySize <= 0) {
-                                            // 无限累加模式
-                                            m_similarityHistory.push_back(lastSimilarity);
-                                            m_historyIndex = m_similarityHistory.size() - 1;
-                                        } else {
-                                            // 固定大小模式
-                                            m_similarityHistory[m_historyIndex] = lastSimilarity;
-                                            m_historyIndex = (m_historyIndex + 1) % historySize;
-                                        }
-                                        // 计算平均值
-                                        float total = 0.0f;
-                                        int count = 0;
-                                        for (float value : m_similarityHistory) {
-                                            if (value > 0.0f) {  // 只计算有效值
-                                                total += value;
-                                                count++;
-                                            }
-                                        }
-                                        
-                                        if (count > 0) {
-                                            m_fTotalSimilarity.store(total, std::memory_order_relaxed);
-                                            m_nSimilarityCount.store(count, std::memory_order_relaxed);
-                                        }
-                                    }
-                                }
-
-                                // 启动新的异步计算
-                                auto bufferCopy = actionBuffer;  // 创建缓冲区的副本
-                                similarityFuture = std::async(
-                                    std::launch::async,
-                                    [](const kfc::ActionBuffer& buffer) {
-                                        auto future = kfc::compareActionAsync(buffer);
-                                        return future.get();  // 等待并返回结果
-                                    },
-                                    std::move(bufferCopy)
-                                );
-                            }
-                        }
-                    }
+    // 取最近一次骨骼帧中的第一个身体
+    const kfc::BodyFrame* latest = nullptr;
+    for (const auto& body : m_latestBodies) {
+        if (body.timestamp != 0 && (!latest || body.timestamp > latest->timestamp)) {
+            latest = &body;
+        }
+    }
+    // 超过半秒没有新骨骼（用户离开画面）时不再估计
+    if (!latest || nTime - latest->timestamp > 5000000) {
+        return false;
+    }
 
-                    // 绘制骨骼和手部状态
-                    DrawBody(joints, jointPoints);
-                    DrawHand(leftHandState, jointPoints[JointType_HandLeft]);
-                    DrawHand(rightHandState, jointPoints[JointType_HandRight]);
-
-                    // 序列化当前帧（异步）
-                    if (m_isRecording && !m_recordFilePath.empty() &&
-                        (nTime - lastRecordedTime >= kfc::Config::getInstance().getRecordInterval())) {
-                        lastRecordedTime = nTime;  // 更新上次记录时间
-
-                        // 限制并发保存任务的数量
-                        if (saveFutures.size() < 5) {  // 最多5个并发保存任务
-                            saveFutures.push_back(
-                                std::async(std::launch::async, [this, frameData]() {
-                                    std::lock_guard<std::mutex> lock(recordMutex);
-                                    kfc::SaveFrame(m_recordFilePath, frameData, true);
-                                    })
-                            );
-                        }
-                    }
+    latest->toFrameData(m_poseFrame);
+    const kfc::FrameFeature feature = kfc::extractFeature(m_poseFrame);
+    if (feature.boneMask == 0) {
+        return false;
+    }
+
+    return index.nearest(kfc::makePoseDescriptor(feature), 1, &match) == 1 &&
+           match.distance < kfc::kPoseMatchDistance;
+}
+
+void Application::RecordLoop() {
+    kfc::Tracer::getInstance().setThreadName("recorder");
+    kfc::BodyFrame body;
+    kfc::FrameData frameData;
+    std::ofstream file;
+    std::string openPath;               // 当前打开的文件
+    INT64 lastRecordedTime = 0;         // 上次记录时间戳
+    uint64_t lastDropped = 0;           // 已报告的落后跳帧数
+
+    while (m_bRecorderRunning.load(std::memory_order_acquire)) {
+        const bool popped = m_pBodyRing->pop(*m_pRecordCursor, body);
+
+        // 磁盘写入跟不上时只有录制跳过旧帧，不影响渲染与评分
+        const uint64_t dropped = m_pRecordCursor->dropped.load(std::memory_order_relaxed);
+        if (dropped != lastDropped) {
+            KF_LOG_EVERY_MS(1000, LOG_W, "Recorder fell behind, {} frames skipped in total", dropped);
+            lastDropped = dropped;
+        }
+
+        if (!popped) {
+            // 空闲时落盘，停止录制后关闭文件
+            if (file.is_open()) {
+                file.flush();
+                if (!m_isRecording.load(std::memory_order_acquire)) {
+                    file.close();
+                    openPath.clear();
                 }
             }
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            continue;
+        }
+
+        if (!m_isRecording.load(std::memory_order_acquire) ||
+            body.timestamp - lastRecordedTime < kfc::Config::getInstance().getRecordInterval()) {
+            continue;
+        }
+
+        // 创建录制文件名
+        std::string path;
+        {
+            std::lock_guard<std::mutex> lock(m_recordMutex);
+            if (m_recordFilePath.empty()) {
+                m_recordFilePath = kfc::generateRecordingPath();
+                LOG_I("Started recording to file: {}", m_recordFilePath);
+            }
+            path = m_recordFilePath;
         }
+
+        if (path != openPath) {
+            if (file.is_open()) {
+                file.close();
+            }
+            file.open(path, std::ios::binary | std::ios::app);
+            if (!file) {
+                LOG_E("Failed to open recording file: {}", path);
+                openPath.clear();
+                continue;
+            }
+            openPath = path;
+        }
+
+        lastRecordedTime = body.timestamp;  // 更新上次记录时间
+        kfc::ScopedLatency writeTimer(kfc::Metric_RecordWrite);
+        KF_TRACE_SCOPE("RecordFrame");
+        body.toFrameData(frameData);
+        frameData.serialize(file);
     }
 }
 
@@ -0,0 +1,1020 @@
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <charconv>
+#include <cmath>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <thread>
+#include <filesystem>
+
+#include "core/cli.h"
+#include "core/replay.h"
+#include "core/sensor.h"
+#include "core/pipeline.h"
+#include "core/metrics.h"
+#include "core/color.h"
+#include "core/server.h"
+#include "core/client.h"
+#include "core/shm.h"
+#include "core/golden.h"
+#include "core/alloc.h"
+#include "core/scheduler.h"
+#include "core/utils.h"
+#include "calc/repcount.h"
+#include "calc/stats.h"
+#include "calc/poseindex.h"
+#include "config/config.h"
+#include "log/logger.h"
+
+namespace kfc {
+
+    // 解析整个字符串为数值，格式错误或超出类型范围时返回 false
+    template<typename T>
+    static bool ParseNumber(const char* text, T& value) {
+        const char* end = text + std::strlen(text);
+        const auto result = std::from_chars(text, end, value);
+        return result.ec == std::errc() && result.ptr == end;
+    }
+
+    // 解析第 index 个可选数值参数（缺省时保留 value 原值），不合法时打印用法
+    template<typename T>
+    static bool ParseOptional(int argc, char** argv, int index, T& value, const char* usage) {
+        if (argc <= index || ParseNumber(argv[index], value)) {
+            return true;
+        }
+        LOG_E("Invalid argument '{}'", argv[index]);
+        LOG_E("Usage: {}", usage);
+        return false;
+    }
+
+    // 对录制文件离线计数重复动作
+    static int RunRepCount(const std::string& filename) {
+        if (!g_actionTemplate) {
+            LOG_E("No action template loaded");
+            return 1;
+        }
+
+        std::vector<FrameData> frames;
+        if (!LoadFrames(filename, frames)) {
+            return 1;
+        }
+
+        auto events = countRepetitions(frames, *g_actionTemplate, *Config::getInstance().getScoringParams());
+        for (const auto& event : events) {
+            LOG_I("Rep {}: {:.2f}s - {:.2f}s, {} frames, score {:.1f}%",
+                  event.index, event.startTime / 10000000.0, event.endTime / 10000000.0,
+                  event.frameCount, event.score * 100.0f);
+        }
+        LOG_I("Total repetitions: {}", events.size());
+        return 0;
+    }
+
+    // 姿态索引校验：对录制文件的每一帧查询最接近的模板帧，与线性扫描比较结果并统计查询耗时
+    static int RunPoseIndex(const std::string& filename, size_t k) {
+        if (!g_actionTemplate) {
+            LOG_E("No action template loaded");
+            return 1;
+        }
+
+        std::vector<FrameData> frames;
+        if (!LoadFrames(filename, frames)) {
+            return 1;
+        }
+        const auto resampled = resampleFrames(frames, static_cast<float>(Config::getInstance().resampleFPS));
+        const auto features = extractFeatures(resampled);
+
+        const auto& index = g_actionTemplate->getPoseIndex();
+        std::vector<PoseMatch> tree(k);
+        std::vector<PoseMatch> linear(k);
+        LatencyHistogram treeLatency;
+        LatencyHistogram linearLatency;
+        size_t mismatches = 0;
+        size_t confident = 0;
+
+        for (const auto& feature : features) {
+            const PoseDescriptor query = makePoseDescriptor(feature);
+
+            INT64 start = QueryTicks();
+            const size_t found = index.nearest(query, k, tree.data());
+            treeLatency.record(TicksToMicroseconds(QueryTicks() - start));
+
+            start = QueryTicks();
+            const size_t expected = index.nearestBruteForce(query, k, linear.data());
+            linearLatency.record(TicksToMicroseconds(QueryTicks() - start));
+
+            // 距离相等的帧可能以不同顺序返回，只比较距离
+            bool same = found == expected;
+            for (size_t i = 0; same && i < found; ++i) {
+                same = std::abs(tree[i].distance - linear[i].distance) <= 1e-5f;
+            }
+            mismatches += same ? 0 : 1;
+
+            if (found > 0 && tree[0].distance < kPoseMatchDistance) {
+                ++confident;
+                LOG_D("{:.2f}s phase {:.2f} (template frame {}, distance {:.3f})",
+                      feature.timestamp / 10000000.0, tree[0].phase, tree[0].frame, tree[0].distance);
+            } else {
+                LOG_D("{:.2f}s no confident match", feature.timestamp / 10000000.0);
+            }
+        }
+
+        const auto treeStats = treeLatency.snapshot();
+        const auto linearStats = linearLatency.snapshot();
+        LOG_I("Pose index: {} template frames, {} queries (k={}), {} confident, {} mismatches against linear scan",
+              index.size(), features.size(), k, confident, mismatches);
+        LOG_I("  vp-tree: mean={:.2f}us p50={:.2f}us p99={:.2f}us", treeStats.mean, treeStats.p50, treeStats.p99);
+        LOG_I("  linear:  mean={:.2f}us p50={:.2f}us p99={:.2f}us", linearStats.mean, linearStats.p50, linearStats.p99);
+        return mismatches == 0 ? 0 : 1;
+    }
+
+    // 序列重复 repeat 次，构造离线分析用的长序列
+    static std::vector<FrameFeature> RepeatFeatures(const std::vector<FrameFeature>& features, size_t repeat) {
+        std::vector<FrameFeature> out;
+        out.reserve(features.size() * repeat);
+        for (size_t r = 0; r < repeat; ++r) {
+            out.insert(out.end(), features.begin(), features.end());
+        }
+        return out;
+    }
+
+    // 波前 DTW 验证：把录制与模板的特征各重复 repeat 次构成长序列，分别用逐行与波前调度计算 DTW，
+    // 要求得分与整个累计代价矩阵逐位一致，并报告两者耗时；不一致时返回 1
+    static int RunWavefrontValidation(const std::string& filename, size_t repeat) {
+        if (!g_actionTemplate) {
+            LOG_E("No action template loaded");
+            return 1;
+        }
+
+        std::vector<FrameData> frames;
+        if (!LoadFrames(filename, frames)) {
+            return 1;
+        }
+        const auto resampled = resampleFrames(frames, static_cast<float>(Config::getInstance().resampleFPS));
+        const auto real = RepeatFeatures(extractFeatures(resampled), repeat);
+        const auto reference = RepeatFeatures(g_actionTemplate->getFeatures(), repeat);
+        if (real.empty() || reference.empty()) {
+            LOG_E("No features to compare");
+            return 1;
+        }
+        const float realSpeed = KinematicsProfile(resampled).averageSpeed();
+        const float referenceSpeed = g_actionTemplate->getKinematics().averageSpeed();
+
+        auto base = *Config::getInstance().getScoringParams();
+        base.fastMath = false;
+        ScoringParams sequential = base;
+        sequential.dtwSchedule = DtwSchedule::Sequential;
+        ScoringParams wavefront = base;
+        wavefront.dtwSchedule = DtwSchedule::Wavefront;
+
+        // 两次共用一个工作区，只另存逐行调度的累计代价，最后逐格对比走廊内的代价
+        DtwWorkspace workspace;
+        auto run = [&](const ScoringParams& params, float& result) {
+            const INT64 start = QueryTicks();
+            result = compareSequences(real, reference, realSpeed, referenceSpeed, params, workspace);
+            return TicksToMicroseconds(QueryTicks() - start) / 1000.0;
+        };
+
+        float sequentialResult = 0.0f;
+        float wavefrontResult = 0.0f;
+        const double sequentialMs = run(sequential, sequentialResult);
+        const std::vector<float> sequentialCost = workspace.cost;
+        const double wavefrontMs = run(wavefront, wavefrontResult);
+
+        const bool identical = sequentialResult == wavefrontResult && sequentialCost == workspace.cost;
+        LOG_I("Wavefront DTW on {} x {} frames ({} corridor cells): result {:.6f} / {:.6f}, cost matrix {}",
+              real.size(), reference.size(), workspace.corridor.cells(),
+              sequentialResult, wavefrontResult, identical ? "identical" : "DIFFERS");
+        LOG_I("  sequential: {:.2f} ms", sequentialMs);
+        LOG_I("  wavefront:  {:.2f} ms ({:.2f}x, {} workers)", wavefrontMs,
+              wavefrontMs > 0.0 ? sequentialMs / wavefrontMs : 0.0, TaskScheduler::getInstance().getWorkerCount());
+
+        if (!identical) {
+            LOG_E("Wavefront DTW is not bit-identical to the sequential schedule");
+        }
+        return identical ? 0 : 1;
+    }
+
+    // 快速数学模式验证：对一组录制文件按流水线的窗口与节奏分别用精确与快速模式评分，
+    // 报告得分的最大/平均偏差与耗时；偏差超过 1 个百分点或重复次数不一致时返回 1
+    static int RunFastMathValidation(const std::vector<std::string>& inputs) {
+        if (!g_actionTemplate) {
+            LOG_E("No action template loaded");
+            return 1;
+        }
+
+        // 目录展开为其中的 .dat 文件
+        std::vector<std::string> files;
+        for (const auto& input : inputs) {
+            std::error_code ec;
+            if (std::filesystem::is_directory(input, ec)) {
+                for (const auto& entry : std::filesystem::directory_iterator(input, ec)) {
+                    if (entry.path().extension() == ".dat") {
+                        files.push_back(entry.path().string());
+                    }
+                }
+            } else {
+                files.push_back(input);
+            }
+        }
+        std::sort(files.begin(), files.end());
+        if (files.empty()) {
+            LOG_E("No recordings to validate");
+            return 1;
+        }
+
+        const auto base = *Config::getInstance().getScoringParams();
+        const ScoringParams precise = MakeVariantParams(base, ScoringVariant::Reference);
+        const ScoringParams fast = MakeVariantParams(base, ScoringVariant::FastMath);
+        constexpr float kTolerance = 0.01f;
+
+        size_t totalWindows = 0;
+        float maxDeviation = 0.0f;
+        double sumDeviation = 0.0;
+        float maxRawDeviation = 0.0f;
+        double preciseMs = 0.0;
+        double fastMs = 0.0;
+        bool repsMatch = true;
+
+        OfflineScorer scorer;
+        for (const auto& file : files) {
+            if (!scorer.load(file)) {
+                LOG_W("Skipping {}", file);
+                continue;
+            }
+
+            const auto preciseScores = scorer.score(*g_actionTemplate, precise, &preciseMs);
+            const auto fastScores = scorer.score(*g_actionTemplate, fast, &fastMs);
+            const size_t windows = preciseScores.size();
+            float fileMax = 0.0f;
+            double fileSum = 0.0;
+            for (size_t i = 0; i < windows; ++i) {
+                const float deviation = std::abs(fastScores[i].score - preciseScores[i].score);
+                fileMax = std::max(fileMax, deviation);
+                fileSum += deviation;
+                maxRawDeviation = std::max(maxRawDeviation, std::abs(fastScores[i].raw - preciseScores[i].raw));
+            }
+
+            const size_t repsPrecise = scorer.countReps(*g_actionTemplate, precise);
+            const size_t repsFast = scorer.countReps(*g_actionTemplate, fast);
+            repsMatch = repsMatch && repsPrecise == repsFast;
+
+            LOG_I("{}: {} windows, score deviation max {:.4f}% mean {:.4f}%, reps {} / {}",
+                  file, windows, fileMax * 100.0f, windows > 0 ? fileSum / windows * 100.0 : 0.0, repsPrecise, repsFast);
+            totalWindows += windows;
+            maxDeviation = std::max(maxDeviation, fileMax);
+            sumDeviation += fileSum;
+        }
+
+        if (totalWindows == 0) {
+            LOG_E("No scoring windows in the given recordings");
+            return 1;
+        }
+
+        LOG_I("Fast math over {} windows: score deviation max {:.4f}% mean {:.4f}%, raw max {:.5f}, reps {}",
+              totalWindows, maxDeviation * 100.0f, sumDeviation / totalWindows * 100.0, maxRawDeviation,
+              repsMatch ? "identical" : "DIFFER");
+        LOG_I("  precise: {:.3f} ms/score", preciseMs / totalWindows);
+        LOG_I("  fast:    {:.3f} ms/score ({:.2f}x)", fastMs / totalWindows, fastMs > 0.0 ? preciseMs / fastMs : 0.0);
+
+        const bool passed = maxDeviation <= kTolerance && repsMatch;
+        if (!passed) {
+            LOG_E("Fast math exceeds the {:.1f}% tolerance", kTolerance * 100.0f);
+        }
+        return passed ? 0 : 1;
+    }
+
+    // 打印流水线结果，会话统计由流水线维护
+    struct ResultLogger {
+        size_t repCount = 0;
+
+        void operator()(const PipelineResult& result) {
+            if (result.kind == PipelineResult::Kind::Repetition) {
+                repCount = result.rep.index;
+                LOG_I("Rep {}: {} frames, score {:.1f}%",
+                      result.rep.index, result.rep.frameCount, result.rep.score * 100.0f);
+            } else {
+                LOG_D("{:.2f}s similarity {:.1f}%",
+                      result.stamps.sensorTime / 10000000.0, result.similarity * 100.0f);
+            }
+        }
+
+        void summary(const Pipeline& pipeline) const {
+            logSessionSummary(*pipeline.getSessionStats());
+            LOG_I("Repetitions: {}", repCount);
+        }
+    };
+
+    // 无窗口回放：回放源作为采集端写入环形缓冲，评分流水线从自己的游标读取
+    static int RunReplay(const std::string& filename, float speed) {
+        if (!g_actionTemplate) {
+            LOG_E("No action template loaded");
+            return 1;
+        }
+
+        ReplaySource source(speed);
+        if (!source.open(filename)) {
+            return 1;
+        }
+
+        auto ring = std::make_unique<BodyFrameRing>();
+        ResultLogger logger;
+        Pipeline pipeline(*ring, RingPolicy::Backpressure, std::ref(logger));
+        pipeline.start();
+
+        std::atomic<bool> stop{ false };
+        size_t pushed = source.run(*ring, stop, [&pipeline]() { pipeline.notify(); });
+        pipeline.stop();
+
+        LOG_I("Replayed {} frames (ring written {}, rejected {})", pushed, ring->getWritten(), ring->getRejected());
+        pipeline.logTimings();
+        Metrics::getInstance().log();
+        logger.summary(pipeline);
+        return 0;
+    }
+
+    static std::atomic<bool> g_stopRequested{ false };
+
+    static BOOL WINAPI OnConsoleCtrl(DWORD ctrlType) {
+        g_stopRequested.store(true, std::memory_order_release);
+        return TRUE;
+    }
+
+    // 热路径分配检查：回放录制文件驱动评分流水线，预热后开启全局分配计数，
+    // 稳态期间（采集 → 过滤 → 缓冲 → 评分 → 发布）出现任何堆分配即失败
+    static int RunAllocationCheck(const std::string& filename, float speed) {
+        if (!IsAllocationCountingAvailable()) {
+            LOG_E("Allocation counting is not available in this build, rebuild with KF_ALLOC_HOOKS=1");
+            return 1;
+        }
+        if (!g_actionTemplate) {
+            LOG_E("No action template loaded");
+            return 1;
+        }
+
+        ReplaySource source(speed);
+        if (!source.open(filename)) {
+            return 1;
+        }
+
+        // 预热：特征缓冲填满后再多跑一秒，保证各级缓冲与评分工作区都已达到稳态容量
+        const auto& config = Config::getInstance();
+        const INT64 warmupTime = static_cast<INT64>(
+            (static_cast<double>(config.getFeatureBufferSize()) / std::max(1, config.resampleFPS) + 1.0) * 10000000.0);
+        constexpr auto kSettleTime = std::chrono::milliseconds(300);   // 等待流水线处理完已写入的帧
+
+        auto ring = std::make_unique<BodyFrameRing>();
+        std::atomic<uint64_t> published{ 0 };
+        Pipeline pipeline(*ring, RingPolicy::Backpressure,
+                          [&published](const PipelineResult&) { published.fetch_add(1, std::memory_order_relaxed); });
+        pipeline.start();
+
+        SetConsoleCtrlHandler(OnConsoleCtrl, TRUE);
+        auto* logger = Logger::GetLoggerInstance();
+        const auto logLevel = logger->level();
+        INT64 startTime = 0;
+        bool measuring = false;
+        size_t measuredFrames = 0;
+        uint64_t publishedBefore = 0;
+
+        source.run(g_stopRequested, [&](const BodyFrame& body) {
+            if (startTime == 0) {
+                startTime = body.timestamp;
+            }
+            if (!measuring && body.timestamp - startTime >= warmupTime) {
+                std::this_thread::sleep_for(kSettleTime);
+                // 稳态期间不输出调试日志，日志格式化本身会分配内存
+                logger->set_level(spdlog::level::warn);
+                publishedBefore = published.load(std::memory_order_relaxed);
+                SetAllocationCounting(true);
+                measuring = true;
+            }
+
+            // Backpressure：等待流水线追上，保证每一帧都被处理
+            while (!ring->push(body)) {
+                if (g_stopRequested.load(std::memory_order_acquire)) {
+                    return false;
+                }
+                pipeline.notify();
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            pipeline.notify();
+            measuredFrames += measuring ? 1 : 0;
+            return true;
+        });
+
+        std::this_thread::sleep_for(kSettleTime);
+        const AllocationCount allocations = GetAllocationCount();
+        SetAllocationCounting(false);
+        const uint64_t measuredResults = published.load(std::memory_order_relaxed) - publishedBefore;
+        logger->set_level(logLevel);
+        pipeline.stop();
+        SetConsoleCtrlHandler(OnConsoleCtrl, FALSE);
+
+        if (!measuring || measuredFrames == 0) {
+            LOG_E("Recording is too short: warm-up needs {:.1f} s of frames", warmupTime / 10000000.0);
+            return 1;
+        }
+
+        LOG_I("Steady state: {} frames, {} results published, {} allocations ({} bytes)",
+              measuredFrames, measuredResults, allocations.count, allocations.bytes);
+        if (allocations.count > 0) {
+            LOG_E("Hot path allocated {} times after warm-up", allocations.count);
+            return 1;
+        }
+        LOG_I("No heap allocations on the hot path after warm-up");
+        return 0;
+    }
+
+    // 无窗口实时评分：Kinect 采集线程 + 评分流水线，Ctrl+C 结束
+    static int RunHeadless() {
+        if (!g_actionTemplate) {
+            LOG_E("No action template loaded");
+            return 1;
+        }
+
+        IKinectSensor* pSensor = nullptr;
+        HRESULT hr = GetDefaultKinectSensor(&pSensor);
+        if (SUCCEEDED(hr) && pSensor) {
+            hr = pSensor->Open();
+        }
+
+        auto ring = std::make_unique<BodyFrameRing>();
+        KinectBodySource source;
+        if (SUCCEEDED(hr) && pSensor) {
+            hr = source.open(pSensor);
+        }
+        if (FAILED(hr) || !pSensor) {
+            LOG_E("No ready Kinect found!");
+            if (pSensor) {
+                pSensor->Close();
+            }
+            SafeRelease(pSensor);
+            return 1;
+        }
+
+        ResultLogger logger;
+        Pipeline pipeline(*ring, RingPolicy::Overwrite, std::ref(logger));
+        pipeline.start();
+        source.start(*ring, [&pipeline]() { pipeline.notify(); });
+
+        SetConsoleCtrlHandler(OnConsoleCtrl, TRUE);
+        LOG_I("Headless scoring running, press Ctrl+C to stop");
+        while (!g_stopRequested.load(std::memory_order_acquire)) {
+            Sleep(100);
+        }
+        SetConsoleCtrlHandler(OnConsoleCtrl, FALSE);
+
+        source.stop();
+        pipeline.stop();
+        source.close();
+        pSensor->Close();
+        SafeRelease(pSensor);
+
+        pipeline.logTimings();
+        Metrics::getInstance().log();
+        logger.summary(pipeline);
+        return 0;
+    }
+
+    // 评分服务：接受多个采集站的连接，Ctrl+C 结束
+    static int RunServe(int port, const std::string& host) {
+        const auto& config = Config::getInstance();
+        ScoringServer server;
+        if (!server.start(host.empty() ? config.serverHost : host,
+                          static_cast<uint16_t>(port > 0 ? port : config.serverPort),
+                          static_cast<size_t>(config.serverWorkers))) {
+            return 1;
+        }
+
+        SetConsoleCtrlHandler(OnConsoleCtrl, TRUE);
+        LOG_I("Scoring service running, press Ctrl+C to stop");
+        while (!g_stopRequested.load(std::memory_order_acquire)) {
+            Sleep(100);
+        }
+        SetConsoleCtrlHandler(OnConsoleCtrl, FALSE);
+
+        server.stop();
+        Metrics::getInstance().log();
+        return 0;
+    }
+
+    // 用回放源模拟多个采集站，并发连接评分服务，结束后输出每个会话的统计
+    static int RunReplayClients(const std::string& filename, int clients, float speed,
+                                const std::string& host, int port) {
+        ReplaySource source(speed);
+        if (!source.open(filename)) {
+            return 1;
+        }
+
+        struct ClientResult {
+            uint32_t sessionId = 0;
+            size_t framesSent = 0;
+            bool finished = false;
+            WireStats stats = {};
+            HistogramSnapshot latency;
+        };
+
+        const uint16_t serverPort = static_cast<uint16_t>(port > 0 ? port : Config::getInstance().serverPort);
+        std::vector<ClientResult> results(static_cast<size_t>(clients));
+        std::vector<std::thread> threads;
+        for (int i = 0; i < clients; ++i) {
+            threads.emplace_back([&source, &results, &host, serverPort, i]() {
+                ScoringClient client;
+                if (!client.connect(host, serverPort, "replay-" + std::to_string(i))) {
+                    return;
+                }
+
+                ClientResult& result = results[i];
+                result.sessionId = client.getSessionId();
+                std::atomic<bool> stop{ false };
+                result.framesSent = source.run(stop, [&client](const BodyFrame& body) {
+                    return client.sendFrame(body);
+                });
+                result.finished = client.finish(result.stats);
+                result.latency = client.getServerLatency();
+                client.close();
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        int failed = 0;
+        for (const auto& result : results) {
+            if (!result.finished) {
+                LOG_E("Session {}: no statistics received ({} frames sent)", result.sessionId, result.framesSent);
+                ++failed;
+                continue;
+            }
+            LOG_I("Session {}: sent {}, server received {}, {} scores ({} skipped), {} reps, mean {:.1f}%, "
+                  "latency p50={:.0f}us p99={:.0f}us max={:.0f}us",
+                  result.sessionId, result.framesSent, result.stats.frames, result.stats.scores,
+                  result.stats.scoresSkipped, result.stats.repetitions, result.stats.meanSimilarity * 100.0f,
+                  result.latency.p50, result.latency.p99, result.latency.max);
+        }
+        return failed == 0 ? 0 : 1;
+    }
+
+    // 采集进程：Kinect 骨骼帧发布到共享内存，评分进程崩溃或重启不影响采集，Ctrl+C 结束
+    static int RunCaptureShared(const std::string& name) {
+        IKinectSensor* pSensor = nullptr;
+        HRESULT hr = GetDefaultKinectSensor(&pSensor);
+        if (SUCCEEDED(hr) && pSensor) {
+            hr = pSensor->Open();
+        }
+
+        KinectBodySource source;
+        if (SUCCEEDED(hr) && pSensor) {
+            hr = source.open(pSensor);
+        }
+        if (FAILED(hr) || !pSensor) {
+            LOG_E("No ready Kinect found!");
+            if (pSensor) {
+                pSensor->Close();
+            }
+            SafeRelease(pSensor);
+            return 1;
+        }
+
+        SharedBodyRingWriter writer;
+        if (!writer.create(name)) {
+            source.close();
+            pSensor->Close();
+            SafeRelease(pSensor);
+            return 1;
+        }
+        source.start([&writer](INT64 timestamp, const BodyFrame* bodies, int count) {
+            writer.publish(timestamp, bodies, count);
+        });
+
+        SetConsoleCtrlHandler(OnConsoleCtrl, TRUE);
+        LOG_I("Publishing skeletons to shared ring {}, press Ctrl+C to stop", name);
+        while (!g_stopRequested.load(std::memory_order_acquire)) {
+            Sleep(100);
+        }
+        SetConsoleCtrlHandler(OnConsoleCtrl, FALSE);
+
+        source.stop();
+        source.close();
+        pSensor->Close();
+        SafeRelease(pSensor);
+
+        LOG_I("Published {} frames", writer.getPublished());
+        writer.close();
+        return 0;
+    }
+
+    // 回放发布端：用录制文件代替 Kinect 驱动共享内存，用于无设备测试评分进程
+    static int RunReplayShared(const std::string& filename, float speed, const std::string& name) {
+        ReplaySource source(speed);
+        if (!source.open(filename)) {
+            return 1;
+        }
+
+        SharedBodyRingWriter writer;
+        if (!writer.create(name)) {
+            return 1;
+        }
+
+        SetConsoleCtrlHandler(OnConsoleCtrl, TRUE);
+        size_t published = source.run(g_stopRequested, [&writer](const BodyFrame& body) {
+            writer.publish(body.timestamp, &body, 1);
+            return true;
+        });
+        SetConsoleCtrlHandler(OnConsoleCtrl, FALSE);
+
+        LOG_I("Published {} frames to shared ring {}", published, name);
+        writer.close();
+        return 0;
+    }
+
+    // 评分进程：从共享内存读取采集进程发布的骨骼帧送入评分流水线，采集进程退出后等待其重启，Ctrl+C 结束
+    static int RunScoreShared(const std::string& name) {
+        if (!g_actionTemplate) {
+            LOG_E("No action template loaded");
+            return 1;
+        }
+
+        SetConsoleCtrlHandler(OnConsoleCtrl, TRUE);
+        SharedBodyRingReader reader;
+        bool waiting = false;
+        while (!reader.open(name)) {
+            if (!waiting) {
+                LOG_I("Waiting for a capture process on shared ring {}...", name);
+                waiting = true;
+            }
+            if (g_stopRequested.load(std::memory_order_acquire)) {
+                SetConsoleCtrlHandler(OnConsoleCtrl, FALSE);
+                return 0;
+            }
+            Sleep(500);
+        }
+
+        auto ring = std::make_unique<BodyFrameRing>();
+        ResultLogger logger;
+        Pipeline pipeline(*ring, RingPolicy::Overwrite, std::ref(logger));
+        pipeline.start();
+
+        LOG_I("Scoring from shared ring {}, press Ctrl+C to stop", name);
+        size_t received = 0;
+        bool stalled = false;
+        BodyFrame bodies[BODY_COUNT];
+        while (!g_stopRequested.load(std::memory_order_acquire)) {
+            if (!reader.wait(100)) {
+                // 采集进程卡住或退出：记录一次，重新发布后自动恢复
+                if (!stalled && reader.getPublisherIdleMs() > 1000.0) {
+                    LOG_W("Capture process {} (idle {:.0f} ms), waiting for it to resume",
+                          reader.isPublisherAlive() ? "stalled" : "exited", reader.getPublisherIdleMs());
+                    stalled = true;
+                }
+                continue;
+            }
+            if (stalled) {
+                LOG_I("Capture process resumed");
+                stalled = false;
+            }
+
+            while (const SharedBodySlot* slot = reader.peek()) {
+                // 槽位在共享内存中原地读取，只有校验通过的身体才写入本地环形缓冲
+                const int count = static_cast<int>(std::min<uint32_t>(slot->bodyCount, BODY_COUNT));
+                std::copy(slot->bodies, slot->bodies + count, bodies);
+                if (!reader.release()) {
+                    continue;
+                }
+                for (int i = 0; i < count; ++i) {
+                    if (ring->push(bodies[i])) {
+                        pipeline.notify();
+                    }
+                }
+                ++received;
+            }
+        }
+        SetConsoleCtrlHandler(OnConsoleCtrl, FALSE);
+
+        pipeline.stop();
+        LOG_I("Received {} frames from shared ring ({} dropped)", received, reader.getDropped());
+        reader.close();
+
+        pipeline.logTimings();
+        Metrics::getInstance().log();
+        logger.summary(pipeline);
+        return 0;
+    }
+
+    // 从 Kinect 抓取一帧原始彩色数据（通常为 1920x1080 YUY2）保存到文件，供 --bench-color 使用
+    static int RunCaptureColor(const std::string& filename) {
+        IKinectSensor* pSensor = nullptr;
+        IColorFrameSource* pSource = nullptr;
+        IColorFrameReader* pReader = nullptr;
+
+        HRESULT hr = GetDefaultKinectSensor(&pSensor);
+        if (SUCCEEDED(hr) && pSensor) {
+            hr = pSensor->Open();
+        }
+        if (SUCCEEDED(hr) && pSensor) {
+            hr = pSensor->get_ColorFrameSource(&pSource);
+        }
+        if (SUCCEEDED(hr) && pSource) {
+            hr = pSource->OpenReader(&pReader);
+        }
+
+        bool saved = false;
+        for (int attempt = 0; SUCCEEDED(hr) && pReader && attempt < 100 && !saved; ++attempt) {
+            IColorFrame* pFrame = nullptr;
+            if (FAILED(pReader->AcquireLatestFrame(&pFrame))) {
+                Sleep(50);  // 传感器启动需要一段时间
+                continue;
+            }
+
+            IFrameDescription* pDescription = nullptr;
+            int width = 0;
+            int height = 0;
+            ColorImageFormat format = ColorImageFormat_None;
+            UINT size = 0;
+            BYTE* pRaw = nullptr;
+
+            HRESULT frameHr = pFrame->get_FrameDescription(&pDescription);
+            if (SUCCEEDED(frameHr)) frameHr = pDescription->get_Width(&width);
+            if (SUCCEEDED(frameHr)) frameHr = pDescription->get_Height(&height);
+            if (SUCCEEDED(frameHr)) frameHr = pFrame->get_RawColorImageFormat(&format);
+            if (SUCCEEDED(frameHr)) frameHr = pFrame->AccessRawUnderlyingBuffer(&size, &pRaw);
+
+            if (SUCCEEDED(frameHr) && format == ColorImageFormat_Yuy2) {
+                std::ofstream out(filename, std::ios::binary);
+                out.write(reinterpret_cast<const char*>(pRaw), size);
+                saved = static_cast<bool>(out);
+                LOG_I("Captured {}x{} YUY2 frame ({} bytes) to {}", width, height, size, filename);
+            } else if (SUCCEEDED(frameHr)) {
+                LOG_E("Unsupported raw color format: {}", static_cast<int>(format));
+                hr = E_FAIL;
+            }
+
+            SafeRelease(pDescription);
+            SafeRelease(pFrame);
+        }
+
+        SafeRelease(pReader);
+        SafeRelease(pSource);
+        if (pSensor) {
+            pSensor->Close();
+        }
+        SafeRelease(pSensor);
+
+        if (!saved) {
+            LOG_E("Failed to capture color frame");
+            return 1;
+        }
+        return 0;
+    }
+
+    // 彩色转换基准：SIMD 与标量内核对比，输入为 --capture-color 抓取的原始帧，缺省时生成测试图
+    static int RunColorBenchmark(const std::string& filename, int iterations) {
+        const int srcWidth = 1920;
+        const int srcHeight = 1080;
+        std::vector<uint8_t> frame(static_cast<size_t>(srcWidth) * srcHeight * 2);
+
+        if (!filename.empty()) {
+            std::ifstream in(filename, std::ios::binary);
+            if (!in.read(reinterpret_cast<char*>(frame.data()), frame.size())) {
+                LOG_E("Expected a {}x{} YUY2 frame ({} bytes) in {}", srcWidth, srcHeight, frame.size(), filename);
+                return 1;
+            }
+        } else {
+            FillTestPatternYUY2(frame.data(), srcWidth, srcHeight);
+        }
+
+        const auto& config = Config::getInstance();
+        int viewWidth = 0;
+        int viewHeight = 0;
+        FitColorSize(srcWidth, srcHeight, config.windowWidth, config.windowHeight, viewWidth, viewHeight);
+
+        ColorConverter converter;
+        converter.configure(srcWidth, srcHeight, viewWidth, viewHeight);
+        const size_t pixels = static_cast<size_t>(converter.getWidth()) * converter.getHeight();
+        std::vector<uint32_t> simd(pixels);
+        std::vector<uint32_t> scalar(pixels);
+
+        auto timeIt = [iterations](const std::function<void()>& fn) {
+            fn();  // 预热
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < iterations; ++i) {
+                fn();
+            }
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / iterations;
+        };
+
+        double simdMs = timeIt([&]() { converter.convertYUY2(frame.data(), simd.data()); });
+        double scalarMs = timeIt([&]() { converter.convertYUY2Scalar(frame.data(), scalar.data()); });
+
+        const int maxDiff = MaxChannelDifference(simd.data(), scalar.data(), pixels);
+
+        LOG_I("Color {}x{} YUY2 -> {}x{} BGRA, kernel {}", srcWidth, srcHeight,
+              converter.getWidth(), converter.getHeight(), GetColorKernelName());
+        LOG_I("  simd:   {:.3f} ms/frame", simdMs);
+        LOG_I("  scalar: {:.3f} ms/frame ({:.1f}x)", scalarMs, simdMs > 0.0 ? scalarMs / simdMs : 0.0);
+        LOG_I("  upload: {:.2f} MB/frame (full resolution {:.2f} MB), max channel diff {}",
+              pixels * 4 / 1048576.0, srcWidth * srcHeight * 4 / 1048576.0, maxDiff);
+        return maxDiff <= 1 ? 0 : 1;
+    }
+
+    bool TryRunCommand(int argc, char** argv, int& exitCode) {
+        if (argc < 2) {
+            return false;
+        }
+
+        const std::string command = argv[1];
+        if (command == "--reps") {
+            if (argc < 3) {
+                LOG_E("Usage: --reps <file.dat>");
+                exitCode = 1;
+                return true;
+            }
+            exitCode = RunRepCount(argv[2]);
+            return true;
+        }
+
+        if (command == "--pose-index") {
+            if (argc < 3) {
+                LOG_E("Usage: --pose-index <file.dat> [k]");
+                exitCode = 1;
+                return true;
+            }
+            size_t k = 1;
+            if (!ParseOptional(argc, argv, 3, k, "--pose-index <file.dat> [k]")) {
+                exitCode = 1;
+                return true;
+            }
+            k = std::max<size_t>(1, k);
+            exitCode = RunPoseIndex(argv[2], k);
+            return true;
+        }
+
+        if (command == "--alloc-check") {
+            if (argc < 3) {
+                LOG_E("Usage: --alloc-check <file.dat> [speed]");
+                exitCode = 1;
+                return true;
+            }
+            float speed = 0.0f;
+            if (!ParseOptional(argc, argv, 3, speed, "--alloc-check <file.dat> [speed]")) {
+                exitCode = 1;
+                return true;
+            }
+            exitCode = RunAllocationCheck(argv[2], speed);
+            return true;
+        }
+
+        if (command == "--golden-record") {
+            if (argc < 4) {
+                LOG_E("Usage: --golden-record <corpus.txt> <golden.txt>");
+                exitCode = 1;
+                return true;
+            }
+            exitCode = RecordGoldenScores(argv[2], argv[3]);
+            return true;
+        }
+
+        if (command == "--golden-check") {
+            if (argc < 3) {
+                LOG_E("Usage: --golden-check <golden.txt>");
+                exitCode = 1;
+                return true;
+            }
+            exitCode = CheckGoldenScores(argv[2]);
+            return true;
+        }
+
+        if (command == "--validate-fastmath") {
+            if (argc < 3) {
+                LOG_E("Usage: --validate-fastmath <file.dat|dir> [...]");
+                exitCode = 1;
+                return true;
+            }
+            exitCode = RunFastMathValidation(std::vector<std::string>(argv + 2, argv + argc));
+            return true;
+        }
+
+        if (command == "--validate-wavefront") {
+            if (argc < 3) {
+                LOG_E("Usage: --validate-wavefront <file.dat> [repeat]");
+                exitCode = 1;
+                return true;
+            }
+            size_t repeat = 25;
+            if (!ParseOptional(argc, argv, 3, repeat, "--validate-wavefront <file.dat> [repeat]")) {
+                exitCode = 1;
+                return true;
+            }
+            repeat = std::max<size_t>(1, repeat);
+            exitCode = RunWavefrontValidation(argv[2], repeat);
+            return true;
+        }
+
+        if (command == "--replay") {
+            if (argc < 3) {
+                LOG_E("Usage: --replay <file.dat> [speed]");
+                exitCode = 1;
+                return true;
+            }
+            float speed = 0.0f;
+            if (!ParseOptional(argc, argv, 3, speed, "--replay <file.dat> [speed]")) {
+                exitCode = 1;
+                return true;
+            }
+            exitCode = RunReplay(argv[2], speed);
+            return true;
+        }
+
+        if (command == "--capture-color") {
+            if (argc < 3) {
+                LOG_E("Usage: --capture-color <out.yuy2>");
+                exitCode = 1;
+                return true;
+            }
+            exitCode = RunCaptureColor(argv[2]);
+            return true;
+        }
+
+        if (command == "--bench-color") {
+            std::string filename = argc >= 3 ? argv[2] : "";
+            int iterations = 100;
+            if (!ParseOptional(argc, argv, 3, iterations, "--bench-color [raw.yuy2] [n]")) {
+                exitCode = 1;
+                return true;
+            }
+            iterations = std::max(1, iterations);
+            exitCode = RunColorBenchmark(filename, iterations);
+            return true;
+        }
+
+        if (command == "--headless") {
+            exitCode = RunHeadless();
+            return true;
+        }
+
+        if (command == "--serve") {
+            uint16_t port = 0;   // 超出端口范围同样视为不合法
+            if (!ParseOptional(argc, argv, 2, port, "--serve [port] [host]")) {
+                exitCode = 1;
+                return true;
+            }
+            exitCode = RunServe(port, argc >= 4 ? argv[3] : "");
+            return true;
+        }
+
+        if (command == "--replay-clients") {
+            if (argc < 3) {
+                LOG_E("Usage: --replay-clients <file.dat> [clients] [speed] [host] [port]");
+                exitCode = 1;
+                return true;
+            }
+            const char* usage = "--replay-clients <file.dat> [clients] [speed] [host] [port]";
+            int clients = 4;
+            float speed = 1.0f;
+            uint16_t port = 0;
+            if (!ParseOptional(argc, argv, 3, clients, usage) || !ParseOptional(argc, argv, 4, speed, usage) ||
+                !ParseOptional(argc, argv, 6, port, usage)) {
+                exitCode = 1;
+                return true;
+            }
+            clients = std::max(1, clients);
+            std::string host = argc >= 6 ? argv[5] : "127.0.0.1";
+            exitCode = RunReplayClients(argv[2], clients, speed, host, port);
+            return true;
+        }
+
+        if (command == "--capture-shm") {
+            exitCode = RunCaptureShared(argc >= 3 ? argv[2] : kDefaultSharedRingName);
+            return true;
+        }
+
+        if (command == "--replay-shm") {
+            if (argc < 3) {
+                LOG_E("Usage: --replay-shm <file.dat> [speed] [name]");
+                exitCode = 1;
+                return true;
+            }
+            float speed = 1.0f;
+            if (!ParseOptional(argc, argv, 3, speed, "--replay-shm <file.dat> [speed] [name]")) {
+                exitCode = 1;
+                return true;
+            }
+            exitCode = RunReplayShared(argv[2], speed, argc >= 5 ? argv[4] : kDefaultSharedRingName);
+            return true;
+        }
+
+        if (command == "--score-shm") {
+            exitCode = RunScoreShared(argc >= 3 ? argv[2] : kDefaultSharedRingName);
+            return true;
+        }
+
+        return false;
+    }
+
+} // namespace kfc
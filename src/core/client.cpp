@@ -0,0 +1,157 @@
+#define NOMINMAX
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <chrono>
+#include <vector>
+
+#include "core/client.h"
+#include "log/logger.h"
+
+namespace kfc {
+
+    ScoringClient::ScoringClient() :
+        _socket(static_cast<uintptr_t>(INVALID_SOCKET)),
+        _sessionId(0),
+        _scores(0),
+        _repetitions(0),
+        _lastSimilarity(0.0f),
+        _stats(),
+        _hasStats(false),
+        _disconnected(false) {}
+
+    ScoringClient::~ScoringClient() {
+        close();
+    }
+
+    bool ScoringClient::connect(const std::string& host, uint16_t port, const std::string& name) {
+        if (!InitSockets()) {
+            return false;
+        }
+
+        addrinfo hints = {};
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_STREAM;
+        hints.ai_protocol = IPPROTO_TCP;
+        addrinfo* result = nullptr;
+        const std::string service = std::to_string(port);
+        if (getaddrinfo(host.c_str(), service.c_str(), &hints, &result) != 0 || !result) {
+            LOG_E("Cannot resolve {}:{}", host, port);
+            return false;
+        }
+
+        SOCKET sock = socket(result->ai_family, result->ai_socktype, result->ai_protocol);
+        if (sock != INVALID_SOCKET &&
+            ::connect(sock, result->ai_addr, static_cast<int>(result->ai_addrlen)) == SOCKET_ERROR) {
+            closesocket(sock);
+            sock = INVALID_SOCKET;
+        }
+        freeaddrinfo(result);
+        if (sock == INVALID_SOCKET) {
+            LOG_E("Cannot connect to scoring server {}:{}", host, port);
+            return false;
+        }
+
+        const int noDelay = 1;
+        setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
+        _socket = static_cast<uintptr_t>(sock);
+
+        // 握手在当前线程完成，之后的消息由接收线程处理
+        WireHello hello = {};
+        hello.magic = kProtocolMagic;
+        hello.version = kProtocolVersion;
+        name.copy(hello.name, kClientNameSize);
+
+        MessageHeader header;
+        std::vector<char> payload;
+        WireWelcome welcome;
+        if (!SendPacket(_socket, MessageType::Hello, hello) ||
+            !ReceivePacket(_socket, header, payload) ||
+            header.type != static_cast<uint16_t>(MessageType::Welcome) ||
+            !ReadPayload(header, payload, welcome)) {
+            LOG_E("Handshake with scoring server failed");
+            CloseSocket(_socket);
+            _socket = static_cast<uintptr_t>(INVALID_SOCKET);
+            return false;
+        }
+
+        _sessionId = welcome.sessionId;
+        _receiver = std::thread(&ScoringClient::receiveLoop, this);
+        return true;
+    }
+
+    bool ScoringClient::sendFrame(const BodyFrame& body) {
+        return SendPacket(_socket, MessageType::Frame, EncodeFrame(body));
+    }
+
+    bool ScoringClient::sendReset() {
+        return SendPacket(_socket, MessageType::Reset);
+    }
+
+    bool ScoringClient::finish(WireStats& stats, int timeoutMs) {
+        if (!SendPacket(_socket, MessageType::Bye)) {
+            return false;
+        }
+
+        std::unique_lock<std::mutex> lock(_statsMutex);
+        _statsArrived.wait_for(lock, std::chrono::milliseconds(timeoutMs),
+            [this]() { return _hasStats || _disconnected; });
+        if (!_hasStats) {
+            return false;
+        }
+        stats = _stats;
+        return true;
+    }
+
+    void ScoringClient::close() {
+        if (static_cast<SOCKET>(_socket) == INVALID_SOCKET) {
+            return;
+        }
+        ShutdownSocket(_socket);
+        if (_receiver.joinable()) {
+            _receiver.join();
+        }
+        CloseSocket(_socket);
+        _socket = static_cast<uintptr_t>(INVALID_SOCKET);
+    }
+
+    void ScoringClient::receiveLoop() {
+        MessageHeader header;
+        std::vector<char> payload;
+        while (ReceivePacket(_socket, header, payload)) {
+            switch (static_cast<MessageType>(header.type)) {
+            case MessageType::Score: {
+                WireScore score;
+                if (ReadPayload(header, payload, score)) {
+                    _scores.fetch_add(1, std::memory_order_relaxed);
+                    _lastSimilarity.store(score.similarity, std::memory_order_relaxed);
+                    _serverLatency.record(score.latencyUs);
+                }
+                break;
+            }
+            case MessageType::Repetition: {
+                WireRepetition rep;
+                if (ReadPayload(header, payload, rep)) {
+                    _repetitions.store(rep.index, std::memory_order_relaxed);
+                    LOG_D("Session {}: rep {} ({} frames, score {:.1f}%)",
+                          _sessionId, rep.index, rep.frameCount, rep.score * 100.0f);
+                }
+                break;
+            }
+            case MessageType::Stats: {
+                std::lock_guard<std::mutex> lock(_statsMutex);
+                _hasStats = ReadPayload(header, payload, _stats);
+                _statsArrived.notify_all();
+                break;
+            }
+            default:
+                LOG_W("Session {}: unexpected message type {}", _sessionId, header.type);
+                break;
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(_statsMutex);
+        _disconnected = true;
+        _statsArrived.notify_all();
+    }
+
+} // namespace kfc
@@ -0,0 +1,309 @@
+#include <algorithm>
+#include <cstring>
+
+#include "core/color.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define KF_COLOR_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define KF_COLOR_SSE2 1
+#endif
+
+namespace kfc {
+
+    // BT.601 有限范围 YUV → RGB
+    static constexpr float kYScale = 1.164383f;
+    static constexpr float kVToR = 1.596027f;
+    static constexpr float kUToG = 0.391762f;
+    static constexpr float kVToG = 0.812968f;
+    static constexpr float kUToB = 2.017232f;
+
+    const char* GetColorKernelName() {
+#if defined(KF_COLOR_AVX2)
+        return "AVX2";
+#elif defined(KF_COLOR_SSE2)
+        return "SSE2";
+#else
+        return "scalar";
+#endif
+    }
+
+    void FitColorSize(int srcWidth, int srcHeight, int maxWidth, int maxHeight, int& outWidth, int& outHeight) {
+        outWidth = srcWidth;
+        outHeight = srcHeight;
+        if (srcWidth <= 0 || srcHeight <= 0 || maxWidth <= 0 || maxHeight <= 0) {
+            return;
+        }
+        if (maxWidth >= srcWidth && maxHeight >= srcHeight) {
+            return;
+        }
+
+        if (static_cast<int64_t>(maxWidth) * srcHeight <= static_cast<int64_t>(maxHeight) * srcWidth) {
+            outWidth = maxWidth;
+            outHeight = std::max(1, static_cast<int>(static_cast<int64_t>(maxWidth) * srcHeight / srcWidth));
+        } else {
+            outHeight = maxHeight;
+            outWidth = std::max(1, static_cast<int>(static_cast<int64_t>(maxHeight) * srcWidth / srcHeight));
+        }
+        outWidth &= ~1;  // 保持偶数宽度，与 YUY2 宏像素对齐
+        outWidth = std::max(2, outWidth);
+    }
+
+    void FillTestPatternYUY2(uint8_t* frame, int width, int height) {
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x + 1 < width; x += 2) {
+                uint8_t* m = &frame[(static_cast<size_t>(y) * width + x) * 2];
+                m[0] = static_cast<uint8_t>(16 + (x * 219) / width);
+                m[1] = static_cast<uint8_t>((y * 255) / height);
+                m[2] = static_cast<uint8_t>(16 + ((x + 1) * 219) / width);
+                m[3] = static_cast<uint8_t>(255 - (y * 255) / height);
+            }
+        }
+    }
+
+    int MaxChannelDifference(const uint32_t* a, const uint32_t* b, size_t count) {
+        int maxDiff = 0;
+        for (size_t i = 0; i < count; ++i) {
+            for (int shift = 0; shift < 24; shift += 8) {
+                const int diff = static_cast<int>((a[i] >> shift) & 0xFF) - static_cast<int>((b[i] >> shift) & 0xFF);
+                maxDiff = std::max(maxDiff, diff < 0 ? -diff : diff);
+            }
+        }
+        return maxDiff;
+    }
+
+    static inline uint32_t clampToByte(float value) {
+        value = std::min(255.0f, std::max(0.0f, value)) + 0.5f;
+        return std::min(255u, static_cast<uint32_t>(value));
+    }
+
+    void ConvertPackedYUY2Scalar(const uint32_t* packed, uint32_t* bgra, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            const uint32_t v = packed[i];
+            const float c = static_cast<float>((v & 0xFF) + ((v >> 16) & 0xFF)) * 0.5f - 16.0f;
+            const float d = static_cast<float>((v >> 8) & 0xFF) - 128.0f;
+            const float e = static_cast<float>(v >> 24) - 128.0f;
+
+            const float y = c * kYScale;
+            const uint32_t r = clampToByte(y + kVToR * e);
+            const uint32_t g = clampToByte(y - kUToG * d - kVToG * e);
+            const uint32_t b = clampToByte(y + kUToB * d);
+            bgra[i] = b | (g << 8) | (r << 16) | 0xFF000000u;
+        }
+    }
+
+    void ConvertPackedYUY2(const uint32_t* packed, uint32_t* bgra, size_t count) {
+        size_t i = 0;
+
+#if defined(KF_COLOR_AVX2)
+        const __m256i mask = _mm256_set1_epi32(0xFF);
+        const __m256i alpha = _mm256_set1_epi32(static_cast<int>(0xFF000000u));
+        const __m256 half = _mm256_set1_ps(0.5f);
+        const __m256 zero = _mm256_setzero_ps();
+        const __m256 max = _mm256_set1_ps(255.0f);
+        const __m256 lumaOffset = _mm256_set1_ps(16.0f);
+        const __m256 chromaOffset = _mm256_set1_ps(128.0f);
+
+        for (; i + 8 <= count; i += 8) {
+            const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(packed + i));
+            const __m256i y0 = _mm256_and_si256(v, mask);
+            const __m256i y1 = _mm256_and_si256(_mm256_srli_epi32(v, 16), mask);
+            const __m256i u = _mm256_and_si256(_mm256_srli_epi32(v, 8), mask);
+            const __m256i w = _mm256_srli_epi32(v, 24);
+
+            const __m256 c = _mm256_sub_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_add_epi32(y0, y1)), half), lumaOffset);
+            const __m256 d = _mm256_sub_ps(_mm256_cvtepi32_ps(u), chromaOffset);
+            const __m256 e = _mm256_sub_ps(_mm256_cvtepi32_ps(w), chromaOffset);
+            const __m256 y = _mm256_mul_ps(c, _mm256_set1_ps(kYScale));
+
+            __m256 r = _mm256_add_ps(y, _mm256_mul_ps(_mm256_set1_ps(kVToR), e));
+            __m256 g = _mm256_sub_ps(_mm256_sub_ps(y, _mm256_mul_ps(_mm256_set1_ps(kUToG), d)),
+                                     _mm256_mul_ps(_mm256_set1_ps(kVToG), e));
+            __m256 b = _mm256_add_ps(y, _mm256_mul_ps(_mm256_set1_ps(kUToB), d));
+
+            r = _mm256_add_ps(_mm256_min_ps(_mm256_max_ps(r, zero), max), half);
+            g = _mm256_add_ps(_mm256_min_ps(_mm256_max_ps(g, zero), max), half);
+            b = _mm256_add_ps(_mm256_min_ps(_mm256_max_ps(b, zero), max), half);
+
+            const __m256i ri = _mm256_and_si256(_mm256_cvttps_epi32(r), mask);
+            const __m256i gi = _mm256_and_si256(_mm256_cvttps_epi32(g), mask);
+            const __m256i bi = _mm256_and_si256(_mm256_cvttps_epi32(b), mask);
+
+            __m256i pixel = _mm256_or_si256(bi, _mm256_slli_epi32(gi, 8));
+            pixel = _mm256_or_si256(pixel, _mm256_slli_epi32(ri, 16));
+            pixel = _mm256_or_si256(pixel, alpha);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(bgra + i), pixel);
+        }
+#elif defined(KF_COLOR_SSE2)
+        const __m128i mask = _mm_set1_epi32(0xFF);
+        const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+        const __m128 half = _mm_set1_ps(0.5f);
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 max = _mm_set1_ps(255.0f);
+        const __m128 lumaOffset = _mm_set1_ps(16.0f);
+        const __m128 chromaOffset = _mm_set1_ps(128.0f);
+
+        for (; i + 4 <= count; i += 4) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(packed + i));
+            const __m128i y0 = _mm_and_si128(v, mask);
+            const __m128i y1 = _mm_and_si128(_mm_srli_epi32(v, 16), mask);
+            const __m128i u = _mm_and_si128(_mm_srli_epi32(v, 8), mask);
+            const __m128i w = _mm_srli_epi32(v, 24);
+
+            const __m128 c = _mm_sub_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_add_epi32(y0, y1)), half), lumaOffset);
+            const __m128 d = _mm_sub_ps(_mm_cvtepi32_ps(u), chromaOffset);
+            const __m128 e = _mm_sub_ps(_mm_cvtepi32_ps(w), chromaOffset);
+            const __m128 y = _mm_mul_ps(c, _mm_set1_ps(kYScale));
+
+            __m128 r = _mm_add_ps(y, _mm_mul_ps(_mm_set1_ps(kVToR), e));
+            __m128 g = _mm_sub_ps(_mm_sub_ps(y, _mm_mul_ps(_mm_set1_ps(kUToG), d)),
+                                  _mm_mul_ps(_mm_set1_ps(kVToG), e));
+            __m128 b = _mm_add_ps(y, _mm_mul_ps(_mm_set1_ps(kUToB), d));
+
+            // 夹到 [0, 255] 后 +0.5 截断，结果最大为 255
+            r = _mm_add_ps(_mm_min_ps(_mm_max_ps(r, zero), max), half);
+            g = _mm_add_ps(_mm_min_ps(_mm_max_ps(g, zero), max), half);
+            b = _mm_add_ps(_mm_min_ps(_mm_max_ps(b, zero), max), half);
+
+            const __m128i ri = _mm_and_si128(_mm_cvttps_epi32(r), mask);
+            const __m128i gi = _mm_and_si128(_mm_cvttps_epi32(g), mask);
+            const __m128i bi = _mm_and_si128(_mm_cvttps_epi32(b), mask);
+
+            __m128i pixel = _mm_or_si128(bi, _mm_slli_epi32(gi, 8));
+            pixel = _mm_or_si128(pixel, _mm_slli_epi32(ri, 16));
+            pixel = _mm_or_si128(pixel, alpha);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(bgra + i), pixel);
+        }
+#endif
+
+        ConvertPackedYUY2Scalar(packed + i, bgra + i, count - i);
+    }
+
+    // 两行逐字节取平均（向上取整，与 SIMD avg 指令一致）
+    static void averageRows(const uint8_t* a, const uint8_t* b, uint8_t* out, size_t bytes) {
+        size_t i = 0;
+#if defined(KF_COLOR_AVX2)
+        for (; i + 32 <= bytes; i += 32) {
+            const __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+            const __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_avg_epu8(va, vb));
+        }
+#elif defined(KF_COLOR_SSE2)
+        for (; i + 16 <= bytes; i += 16) {
+            const __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+            const __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_avg_epu8(va, vb));
+        }
+#endif
+        for (; i < bytes; ++i) {
+            out[i] = static_cast<uint8_t>((a[i] + b[i] + 1) >> 1);
+        }
+    }
+
+    void ColorConverter::configure(int srcWidth, int srcHeight, int dstWidth, int dstHeight) {
+        dstWidth = std::max(1, std::min(dstWidth, srcWidth));
+        dstHeight = std::max(1, std::min(dstHeight, srcHeight));
+        if (srcWidth == _srcWidth && srcHeight == _srcHeight && dstWidth == _dstWidth && dstHeight == _dstHeight) {
+            return;
+        }
+
+        _srcWidth = srcWidth;
+        _srcHeight = srcHeight;
+        _dstWidth = dstWidth;
+        _dstHeight = dstHeight;
+        _averageRows = srcHeight >= 2 * dstHeight;
+        _averageColumns = srcWidth >= 2 * dstWidth;
+
+        _rows.resize(dstHeight);
+        for (int y = 0; y < dstHeight; ++y) {
+            _rows[y] = static_cast<int>(static_cast<int64_t>(y) * srcHeight / dstHeight);
+        }
+        _columns.resize(dstWidth);
+        for (int x = 0; x < dstWidth; ++x) {
+            _columns[x] = static_cast<int>(static_cast<int64_t>(x) * srcWidth / dstWidth);
+        }
+
+        _rowBuffer.resize(static_cast<size_t>(srcWidth) * 4);
+        _packed.resize(dstWidth);
+        _packedNext.resize(dstWidth);
+    }
+
+    const uint8_t* ColorConverter::sampleRow(const uint8_t* src, size_t stride, int y) {
+        const int row = _rows[y];
+        const uint8_t* first = src + stride * row;
+        if (!_averageRows || row + 1 >= _srcHeight) {
+            return first;
+        }
+        averageRows(first, first + stride, _rowBuffer.data(), stride);
+        return _rowBuffer.data();
+    }
+
+    void ColorConverter::convertYUY2(const uint8_t* src, uint32_t* dst) {
+        const size_t stride = static_cast<size_t>(_srcWidth) * 2;
+        for (int y = 0; y < _dstHeight; ++y) {
+            const uint32_t* macro = reinterpret_cast<const uint32_t*>(sampleRow(src, stride, y));
+            for (int x = 0; x < _dstWidth; ++x) {
+                const int sx = _columns[x];
+                uint32_t v = macro[sx >> 1];
+                if (!_averageColumns) {
+                    // 缩放比小于 2：两个 Y 都取采样点自己的亮度
+                    const uint32_t luma = (sx & 1) ? ((v >> 16) & 0xFF) : (v & 0xFF);
+                    v = (v & 0xFF00FF00u) | luma | (luma << 16);
+                }
+                _packed[x] = v;
+            }
+            ConvertPackedYUY2(_packed.data(), dst + static_cast<size_t>(y) * _dstWidth, _dstWidth);
+        }
+    }
+
+    void ColorConverter::convertYUY2Scalar(const uint8_t* src, uint32_t* dst) {
+        const size_t stride = static_cast<size_t>(_srcWidth) * 2;
+        for (int y = 0; y < _dstHeight; ++y) {
+            const int row = _rows[y];
+            const uint8_t* first = src + stride * row;
+            const uint8_t* second = (_averageRows && row + 1 < _srcHeight) ? first + stride : first;
+            for (int x = 0; x < _dstWidth; ++x) {
+                const int sx = _columns[x];
+                const uint8_t* a = first + (sx >> 1) * 4;
+                const uint8_t* b = second + (sx >> 1) * 4;
+                uint8_t m[4];
+                for (int k = 0; k < 4; ++k) {
+                    m[k] = static_cast<uint8_t>((a[k] + b[k] + 1) >> 1);
+                }
+                if (!_averageColumns) {
+                    m[0] = m[2] = (sx & 1) ? m[2] : m[0];
+                }
+                _packed[x] = m[0] | (m[1] << 8) | (m[2] << 16) | (static_cast<uint32_t>(m[3]) << 24);
+            }
+            ConvertPackedYUY2Scalar(_packed.data(), dst + static_cast<size_t>(y) * _dstWidth, _dstWidth);
+        }
+    }
+
+    void ColorConverter::convertBGRA(const uint32_t* src, uint32_t* dst) {
+        const size_t stride = static_cast<size_t>(_srcWidth) * 4;
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(src);
+        for (int y = 0; y < _dstHeight; ++y) {
+            const uint32_t* row = reinterpret_cast<const uint32_t*>(sampleRow(bytes, stride, y));
+            uint32_t* out = dst + static_cast<size_t>(y) * _dstWidth;
+            if (!_averageColumns) {
+                for (int x = 0; x < _dstWidth; ++x) {
+                    out[x] = row[_columns[x]];
+                }
+                continue;
+            }
+
+            // 水平相邻两像素取平均
+            for (int x = 0; x < _dstWidth; ++x) {
+                const int sx = _columns[x];
+                _packed[x] = row[sx];
+                _packedNext[x] = row[std::min(sx + 1, _srcWidth - 1)];
+            }
+            averageRows(reinterpret_cast<const uint8_t*>(_packed.data()),
+                        reinterpret_cast<const uint8_t*>(_packedNext.data()),
+                        reinterpret_cast<uint8_t*>(out), static_cast<size_t>(_dstWidth) * 4);
+        }
+    }
+
+} // namespace kfc
@@ -0,0 +1,346 @@
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <iomanip>
+#include <limits>
+#include <memory>
+#include <sstream>
+
+#include "core/golden.h"
+#include "core/utils.h"
+#include "core/scheduler.h"
+#include "calc/compare.h"
+#include "calc/repcount.h"
+#include "calc/resample.h"
+#include "config/config.h"
+#include "log/logger.h"
+
+namespace kfc {
+
+    static constexpr int kGoldenVersion = 1;
+    static constexpr float kDefaultCaseTolerance = 0.01f;   // 近似变体的缺省容差（1 个百分点）
+    static constexpr float kReferenceTolerance = 1e-5f;     // 精确变体只允许舍入误差
+
+    const char* GetScoringVariantName(ScoringVariant variant) {
+        switch (variant) {
+        case ScoringVariant::Reference: return "reference";
+        case ScoringVariant::FastMath:  return "fast-math";
+        case ScoringVariant::Wavefront: return "wavefront";
+        default:                        return "unknown";
+        }
+    }
+
+    ScoringParams MakeVariantParams(const ScoringParams& base, ScoringVariant variant) {
+        ScoringParams params = base;
+        params.fastMath = variant == ScoringVariant::FastMath;
+        params.dtwSchedule = variant == ScoringVariant::Wavefront ? DtwSchedule::Wavefront : DtwSchedule::Sequential;
+        return params;
+    }
+
+    // ----------------------------------------------------------------------------------------------
+
+    OfflineScorer::OfflineScorer(size_t window, size_t step) {
+        const auto& config = Config::getInstance();
+        _window = window > 0 ? window : config.getFeatureBufferSize();
+        _step = step > 0 ? step : std::max<size_t>(1, static_cast<size_t>(
+            std::max(1, config.resampleFPS) / std::max(1, config.compareFPS)));
+    }
+
+    bool OfflineScorer::load(const std::string& recording) {
+        _frames.clear();
+        if (!LoadFrames(recording, _frames) || _frames.empty()) {
+            return false;
+        }
+        const auto resampled = resampleFrames(_frames, static_cast<float>(Config::getInstance().resampleFPS));
+        _features = extractFeatures(resampled);
+        _kinematics.build(resampled);
+        return true;
+    }
+
+    std::vector<WindowScore> OfflineScorer::score(const ActionTemplate& actionTemplate, const ScoringParams& params,
+                                                  double* elapsedMs) const {
+        std::vector<WindowScore> scores;
+        std::vector<FrameFeature> slice;
+        for (size_t end = std::min(_window, _features.size()); end > 0 && end <= _features.size(); end += _step) {
+            const size_t begin = end - std::min(_window, end);
+            slice.assign(_features.begin() + begin, _features.begin() + end);
+            const float avgSpeed = _kinematics.averageSpeed(end - std::min(end, kSpeedWindow), end);
+
+            WindowScore result = { end, 0.0f, 0.0f };
+            const INT64 start = QueryTicks();
+            result.score = compareFeatureSequence(slice, avgSpeed, actionTemplate, params, _workspace, &result.raw);
+            if (elapsedMs) {
+                *elapsedMs += TicksToMicroseconds(QueryTicks() - start) / 1000.0;
+            }
+            scores.push_back(result);
+        }
+        return scores;
+    }
+
+    size_t OfflineScorer::countReps(const ActionTemplate& actionTemplate, const ScoringParams& params) const {
+        return countRepetitions(_frames, actionTemplate, params).size();
+    }
+
+    // ----------------------------------------------------------------------------------------------
+
+    struct GoldenCase {
+        std::string templatePath;
+        std::string recordingPath;
+        float tolerance = kDefaultCaseTolerance;
+        size_t repetitions = 0;
+        std::vector<WindowScore> windows;
+    };
+
+    // 影响得分的配置，golden 文件记录生成时的取值，检查时必须一致
+    static std::string DescribeScoringConfig(const OfflineScorer& scorer) {
+        const auto& config = Config::getInstance();
+        const auto params = config.getScoringParams();
+        std::ostringstream out;
+        out << "resample=" << config.resampleFPS << " window=" << scorer.getWindow() << " step=" << scorer.getStep()
+            << " difficulty=" << params->difficulty << " speedWeight=" << params->speedWeight
+            << " speedRatio=" << params->minSpeedRatio << ":" << params->maxSpeedRatio
+            << " minSpeedPenalty=" << params->minSpeedPenalty << " band=" << params->dtwBandwidthRatio
+            << " rep=" << params->repThreshold << ":" << params->repMinLengthRatio;
+        return out.str();
+    }
+
+    // 相对路径按 base 所在目录解析
+    static std::string ResolvePath(const std::string& base, const std::string& path) {
+        const std::filesystem::path p(path);
+        return p.is_absolute() ? path : (std::filesystem::path(base).parent_path() / p).lexically_normal().string();
+    }
+
+    static std::unique_ptr<ActionTemplate> LoadCaseTemplate(const std::string& path) {
+        try {
+            return std::make_unique<ActionTemplate>(path);
+        } catch (const std::exception&) {
+            return nullptr;   // 构造函数已记录错误
+        }
+    }
+
+    int RecordGoldenScores(const std::string& corpusPath, const std::string& goldenPath) {
+        std::ifstream corpus(corpusPath);
+        if (!corpus) {
+            LOG_E("Cannot open corpus {}", corpusPath);
+            return 1;
+        }
+
+        // 读取用例清单：模板 录制 [容差]，# 开头为注释
+        std::vector<GoldenCase> cases;
+        std::string line;
+        while (std::getline(corpus, line)) {
+            std::istringstream in(line);
+            GoldenCase item;
+            if (!(in >> std::quoted(item.templatePath)) || item.templatePath[0] == '#') {
+                continue;
+            }
+            if (!(in >> std::quoted(item.recordingPath))) {
+                LOG_E("Corpus line needs a template and a recording: {}", line);
+                return 1;
+            }
+            in >> item.tolerance;
+            item.templatePath = ResolvePath(corpusPath, item.templatePath);
+            item.recordingPath = ResolvePath(corpusPath, item.recordingPath);
+            cases.push_back(std::move(item));
+        }
+        if (cases.empty()) {
+            LOG_E("Corpus {} has no cases", corpusPath);
+            return 1;
+        }
+
+        // 各用例互不依赖，作为批量任务并行评分
+        const auto params = MakeVariantParams(*Config::getInstance().getScoringParams(), ScoringVariant::Reference);
+        std::vector<std::future<bool>> jobs;
+        for (auto& item : cases) {
+            jobs.push_back(TaskScheduler::getInstance().submit(TaskPriority::Batch, [&item, &params]() {
+                OfflineScorer scorer;
+                auto actionTemplate = LoadCaseTemplate(item.templatePath);
+                if (!actionTemplate || !scorer.load(item.recordingPath)) {
+                    LOG_E("Cannot load case {} / {}", item.templatePath, item.recordingPath);
+                    return false;
+                }
+                item.windows = scorer.score(*actionTemplate, params);
+                item.repetitions = scorer.countReps(*actionTemplate, params);
+                LOG_I("{} / {}: {} windows, {} reps", item.templatePath, item.recordingPath,
+                      item.windows.size(), item.repetitions);
+                return true;
+            }));
+        }
+        bool loaded = true;
+        for (auto& job : jobs) {
+            loaded = job.get() && loaded;
+        }
+        if (!loaded) {
+            return 1;
+        }
+        const OfflineScorer scorer;
+
+        // 用例中的路径改为相对 golden 文件所在目录保存
+        const auto goldenDir = std::filesystem::path(goldenPath).parent_path();
+        auto relative = [&goldenDir](const std::string& path) {
+            auto rel = std::filesystem::path(path).lexically_relative(goldenDir.empty() ? "." : goldenDir);
+            return rel.empty() ? path : rel.generic_string();
+        };
+
+        std::ofstream out(goldenPath, std::ios::trunc);
+        if (!out) {
+            LOG_E("Cannot write golden file {}", goldenPath);
+            return 1;
+        }
+        out << "# kinect_fitness golden scores, regenerate with --golden-record\n";
+        out << "version " << kGoldenVersion << "\n";
+        out << "config " << DescribeScoringConfig(scorer) << "\n";
+        out << std::setprecision(9);
+        for (const auto& item : cases) {
+            out << "case " << std::quoted(relative(item.templatePath)) << " " << std::quoted(relative(item.recordingPath))
+                << " " << std::setprecision(6) << item.tolerance << std::setprecision(9) << " " << item.repetitions << " " << item.windows.size() << "\n";
+            for (const auto& window : item.windows) {
+                out << window.end << " " << window.raw << " " << window.score << "\n";
+            }
+        }
+        if (!out) {
+            LOG_E("Failed writing golden file {}", goldenPath);
+            return 1;
+        }
+
+        LOG_I("Recorded {} cases to {}", cases.size(), goldenPath);
+        return 0;
+    }
+
+    static bool LoadGolden(const std::string& goldenPath, std::string& configLine, std::vector<GoldenCase>& cases) {
+        std::ifstream in(goldenPath);
+        if (!in) {
+            LOG_E("Cannot open golden file {}", goldenPath);
+            return false;
+        }
+
+        std::string line;
+        int version = 0;
+        while (std::getline(in, line)) {
+            if (line.empty() || line[0] == '#') {
+                continue;
+            }
+            std::istringstream fields(line);
+            std::string keyword;
+            fields >> keyword;
+            if (keyword == "version") {
+                fields >> version;
+            } else if (keyword == "config") {
+                std::getline(fields >> std::ws, configLine);
+            } else if (keyword == "case") {
+                GoldenCase item;
+                size_t count = 0;
+                if (!(fields >> std::quoted(item.templatePath) >> std::quoted(item.recordingPath)
+                             >> item.tolerance >> item.repetitions >> count)) {
+                    LOG_E("Malformed golden case: {}", line);
+                    return false;
+                }
+                item.templatePath = ResolvePath(goldenPath, item.templatePath);
+                item.recordingPath = ResolvePath(goldenPath, item.recordingPath);
+                item.windows.resize(count);
+                for (auto& window : item.windows) {
+                    if (!(in >> window.end >> window.raw >> window.score)) {
+                        LOG_E("Golden case {} is truncated", item.recordingPath);
+                        return false;
+                    }
+                }
+                in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+                cases.push_back(std::move(item));
+            }
+        }
+
+        if (version != kGoldenVersion) {
+            LOG_E("Golden file version {} is not supported (expected {})", version, kGoldenVersion);
+            return false;
+        }
+        return true;
+    }
+
+    int CheckGoldenScores(const std::string& goldenPath) {
+        std::string goldenConfig;
+        std::vector<GoldenCase> cases;
+        if (!LoadGolden(goldenPath, goldenConfig, cases)) {
+            return 1;
+        }
+
+        OfflineScorer scorer;
+        const std::string currentConfig = DescribeScoringConfig(scorer);
+        if (goldenConfig != currentConfig) {
+            LOG_E("Scoring config differs from the golden file, scores are not comparable");
+            LOG_E("  golden:  {}", goldenConfig);
+            LOG_E("  current: {}", currentConfig);
+            return 1;
+        }
+
+        struct VariantTotals {
+            size_t windows = 0;
+            size_t failedCases = 0;
+            float maxDeviation = 0.0f;
+            double elapsedMs = 0.0;
+        };
+        constexpr size_t kVariantCount = static_cast<size_t>(ScoringVariant::Count);
+        VariantTotals totals[kVariantCount];
+        const auto base = *Config::getInstance().getScoringParams();
+
+        for (const auto& item : cases) {
+            auto actionTemplate = LoadCaseTemplate(item.templatePath);
+            if (!actionTemplate || !scorer.load(item.recordingPath)) {
+                LOG_E("Cannot load case {} / {}", item.templatePath, item.recordingPath);
+                return 1;
+            }
+
+            for (size_t v = 0; v < kVariantCount; ++v) {
+                const auto variant = static_cast<ScoringVariant>(v);
+                const auto params = MakeVariantParams(base, variant);
+                const float tolerance = variant == ScoringVariant::FastMath ? item.tolerance : kReferenceTolerance;
+
+                double elapsedMs = 0.0;
+                const auto windows = scorer.score(*actionTemplate, params, &elapsedMs);
+                const size_t reps = scorer.countReps(*actionTemplate, params);
+
+                float maxDeviation = 0.0f;
+                size_t outside = 0;
+                const bool sameWindows = windows.size() == item.windows.size();
+                for (size_t i = 0; sameWindows && i < windows.size(); ++i) {
+                    // 原始相似度与后处理得分使用同一容差，避免后处理的饱和区掩盖 DTW 的偏差
+                    const float deviation = std::max(std::abs(windows[i].raw - item.windows[i].raw),
+                                                     std::abs(windows[i].score - item.windows[i].score));
+                    maxDeviation = std::max(maxDeviation, deviation);
+                    outside += deviation > tolerance ? 1 : 0;
+                }
+                const bool passed = sameWindows && outside == 0 && reps == item.repetitions;
+
+                auto& total = totals[v];
+                total.windows += windows.size();
+                total.elapsedMs += elapsedMs;
+                total.maxDeviation = std::max(total.maxDeviation, maxDeviation);
+                total.failedCases += passed ? 0 : 1;
+
+                if (passed) {
+                    LOG_I("[{}] {}: {} windows, max deviation {:.4f}%, {:.3f} ms/score",
+                          GetScoringVariantName(variant), item.recordingPath, windows.size(), maxDeviation * 100.0f,
+                          windows.empty() ? 0.0 : elapsedMs / windows.size());
+                } else {
+                    LOG_E("[{}] {}: FAILED - windows {} / {}, {} outside {:.4f}% (max {:.4f}%), reps {} / {}",
+                          GetScoringVariantName(variant), item.recordingPath, windows.size(), item.windows.size(),
+                          outside, tolerance * 100.0f, maxDeviation * 100.0f, reps, item.repetitions);
+                }
+            }
+        }
+
+        bool passed = true;
+        const double referenceMs = totals[0].windows > 0 ? totals[0].elapsedMs / totals[0].windows : 0.0;
+        for (size_t v = 0; v < kVariantCount; ++v) {
+            const auto& total = totals[v];
+            const double msPerScore = total.windows > 0 ? total.elapsedMs / total.windows : 0.0;
+            LOG_I("{:>10}: {} cases, {} failed, max deviation {:.4f}%, {:.3f} ms/score ({:.2f}x)",
+                  GetScoringVariantName(static_cast<ScoringVariant>(v)), cases.size(), total.failedCases,
+                  total.maxDeviation * 100.0f, msPerScore, msPerScore > 0.0 ? referenceMs / msPerScore : 0.0);
+            passed = passed && total.failedCases == 0;
+        }
+        return passed ? 0 : 1;
+    }
+
+} // namespace kfc
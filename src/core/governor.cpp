@@ -0,0 +1,88 @@
+#include <algorithm>
+
+#include "core/governor.h"
+#include "core/metrics.h"
+#include "log/logger.h"
+
+namespace kfc {
+
+    static constexpr double kAverageWeight = 0.2;     // 新样本在滑动平均中的权重
+    static constexpr size_t kDegradeSettle = 5;       // 等级变化后至少再记录几次才继续降级，等平均值反映新等级
+    static constexpr size_t kRestoreAfter = 50;       // 连续多少次低于预算一半才升一级
+    static constexpr double kRestoreRatio = 0.5;
+
+    QualityGovernor::QualityGovernor() :
+        _budget(0.0),
+        _average(0.0),
+        _sinceChange(0),
+        _headroom(0),
+        _level(0) {}
+
+    void QualityGovernor::record(double micros, double budgetMicros) {
+        budgetMicros = std::max(0.0, budgetMicros);
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        // 热重载改变了预算：旧预算下的统计不再适用，关闭调节时回到完整质量
+        if (budgetMicros != _budget) {
+            _budget = budgetMicros;
+            _average = 0.0;
+            _sinceChange = 0;
+            _headroom = 0;
+            if (_budget <= 0.0 && _level.load(std::memory_order_relaxed) != 0) {
+                setLevel(0, micros);
+            }
+        }
+        if (_budget <= 0.0) {
+            return;
+        }
+
+        _average = _average == 0.0 ? micros : _average + kAverageWeight * (micros - _average);
+        ++_sinceChange;
+
+        const size_t level = _level.load(std::memory_order_relaxed);
+        if (_average > _budget) {
+            _headroom = 0;
+            if (level + 1 < kQualityLevels.size() && _sinceChange >= kDegradeSettle) {
+                setLevel(level + 1, _average);
+            }
+            return;
+        }
+
+        _headroom = _average < _budget * kRestoreRatio ? _headroom + 1 : 0;
+        if (level > 0 && _headroom >= kRestoreAfter) {
+            setLevel(level - 1, _average);
+        }
+    }
+
+    void QualityGovernor::setLevel(size_t level, double average) {
+        const size_t previous = _level.exchange(level, std::memory_order_relaxed);
+        _sinceChange = 0;
+        _headroom = 0;
+        Metrics::getInstance().set(Gauge_QualityLevel, static_cast<int64_t>(level));
+
+        const auto& q = kQualityLevels[level];
+        LOG_I("Scoring quality {} -> {} (compare latency {:.1f} ms, budget {:.1f} ms): "
+              "band x{:.1f}, stride {}, interval x{:.1f}",
+              previous, level, average / 1000.0, _budget / 1000.0, q.bandScale, q.stride, q.intervalScale);
+    }
+
+    void QualityGovernor::apply(ScoringParams& params) const {
+        const auto& q = kQualityLevels[getLevel()];
+        params.dtwBandwidthRatio *= q.bandScale;
+        params.sequenceStride *= q.stride;
+    }
+
+    INT64 QualityGovernor::scaleInterval(INT64 interval) const {
+        return static_cast<INT64>(interval * kQualityLevels[getLevel()].intervalScale);
+    }
+
+    void QualityGovernor::reset() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _average = 0.0;
+        _sinceChange = 0;
+        _headroom = 0;
+        _level.store(0, std::memory_order_relaxed);
+        Metrics::getInstance().set(Gauge_QualityLevel, 0);
+    }
+
+} // namespace kfc
@@ -0,0 +1,246 @@
+#include <cmath>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#include "core/metrics.h"
+#include "log/logger.h"
+
+namespace kfc {
+
+    static inline int HighestBit(uint64_t value) {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanReverse64(&index, value);
+        return static_cast<int>(index);
+#else
+        return 63 - __builtin_clzll(value);
+#endif
+    }
+
+    size_t LatencyHistogram::bucketIndex(uint64_t value) {
+        // 小于 2 * kSubBuckets 的值每个整数一个桶
+        if (value < 2 * kSubBuckets) {
+            return static_cast<size_t>(value);
+        }
+        const int shift = HighestBit(value) - kSubBucketBits;
+        return static_cast<size_t>(shift) * kSubBuckets + static_cast<size_t>(value >> shift);
+    }
+
+    uint64_t LatencyHistogram::bucketUpperBound(size_t index) {
+        if (index < 2 * kSubBuckets) {
+            return index;
+        }
+        const int shift = static_cast<int>(index / kSubBuckets) - 1;
+        const uint64_t mantissa = index % kSubBuckets + kSubBuckets;
+        return ((mantissa + 1) << shift) - 1;
+    }
+
+    void LatencyHistogram::record(double micros) {
+        const uint64_t value = micros > 0.0 ? static_cast<uint64_t>(std::llround(micros)) : 0;
+        _buckets[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+        _count.fetch_add(1, std::memory_order_relaxed);
+        _sum.fetch_add(value, std::memory_order_relaxed);
+
+        uint64_t current = _max.load(std::memory_order_relaxed);
+        while (value > current && !_max.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    void LatencyHistogram::reset() {
+        for (auto& bucket : _buckets) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        _count.store(0, std::memory_order_relaxed);
+        _sum.store(0, std::memory_order_relaxed);
+        _max.store(0, std::memory_order_relaxed);
+    }
+
+    HistogramSnapshot LatencyHistogram::snapshot() const {
+        // 各桶分别读取，写入并发时总数以桶计数之和为准
+        std::array<uint64_t, kBucketCount> counts;
+        uint64_t total = 0;
+        for (size_t i = 0; i < kBucketCount; ++i) {
+            counts[i] = _buckets[i].load(std::memory_order_relaxed);
+            total += counts[i];
+        }
+
+        HistogramSnapshot snapshot;
+        if (total == 0) {
+            return snapshot;
+        }
+        snapshot.count = total;
+        snapshot.mean = static_cast<double>(_sum.load(std::memory_order_relaxed)) / static_cast<double>(total);
+        snapshot.max = static_cast<double>(_max.load(std::memory_order_relaxed));
+
+        const double quantiles[] = { 0.5, 0.9, 0.99, 0.999 };
+        double* outputs[] = { &snapshot.p50, &snapshot.p90, &snapshot.p99, &snapshot.p999 };
+        size_t bucket = 0;
+        uint64_t cumulative = counts[0];
+        for (size_t q = 0; q < _countof(quantiles); ++q) {
+            const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(quantiles[q] * total)));
+            while (cumulative < rank && bucket + 1 < kBucketCount) {
+                cumulative += counts[++bucket];
+            }
+            *outputs[q] = std::min(static_cast<double>(bucketUpperBound(bucket)), snapshot.max);
+        }
+        return snapshot;
+    }
+
+    const char* GetMetricName(MetricId id) {
+        switch (id) {
+        case Metric_Acquire:     return "acquire";
+        case Metric_Ingest:      return "ingest";
+        case Metric_Similarity:  return "similarity";
+        case Metric_DTW:         return "dtw";
+        case Metric_PostProcess: return "postprocess";
+        case Metric_Render:      return "render";
+        case Metric_RecordWrite: return "record";
+        case Metric_EndToEnd:    return "end_to_end";
+        default:                 return "unknown";
+        }
+    }
+
+    const char* GetCounterName(CounterId id) {
+        switch (id) {
+        case Counter_RingRejected:    return "ring_rejected";
+        case Counter_RingSkipped:     return "ring_skipped";
+        case Counter_InvalidFrames:   return "invalid_frames";
+        case Counter_ComparesSkipped: return "compares_skipped";
+        case Counter_DTWRetries:      return "dtw_retries";
+        case Counter_SharedRingDropped: return "shm_dropped";
+        case Counter_ComparesGated:   return "compares_gated";
+        case Counter_ActivityChanges: return "activity_changes";
+        default:                      return "unknown";
+        }
+    }
+
+    const char* GetGaugeName(GaugeId id) {
+        switch (id) {
+        case Gauge_QualityLevel:      return "quality_level";
+        default:                      return "unknown";
+        }
+    }
+
+    Metrics::Metrics() :
+        _startTick(QueryTicks()),
+        _dumpRunning(false) {}
+
+    Metrics::~Metrics() {
+        stopDump();
+    }
+
+    MetricsSnapshot Metrics::snapshot() const {
+        MetricsSnapshot snapshot;
+        snapshot.uptimeSeconds = TicksToMicroseconds(QueryTicks() - _startTick) / 1000000.0;
+        for (int i = 0; i < Metric_Count; ++i) {
+            snapshot.latencies[i] = _latencies[i].snapshot();
+        }
+        for (int i = 0; i < Counter_Count; ++i) {
+            snapshot.counters[i] = _counters[i].load(std::memory_order_relaxed);
+        }
+        for (int i = 0; i < Gauge_Count; ++i) {
+            snapshot.gauges[i] = _gauges[i].load(std::memory_order_relaxed);
+        }
+        return snapshot;
+    }
+
+    void Metrics::reset() {
+        for (auto& latency : _latencies) {
+            latency.reset();
+        }
+        for (auto& counter : _counters) {
+            counter.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    bool Metrics::dump(const std::string& path) const {
+        std::ofstream file(path, std::ios::app);
+        if (!file) {
+            LOG_E("Failed to open metrics file: {}", path);
+            return false;
+        }
+
+        const MetricsSnapshot s = snapshot();
+        file << std::fixed << std::setprecision(1);
+        file << "{\"uptime\":" << s.uptimeSeconds << ",\"latency_us\":{";
+        for (int i = 0; i < Metric_Count; ++i) {
+            const auto& h = s.latencies[i];
+            file << (i > 0 ? "," : "") << '"' << GetMetricName(static_cast<MetricId>(i)) << "\":{"
+                 << "\"count\":" << h.count << ",\"mean\":" << h.mean
+                 << ",\"p50\":" << h.p50 << ",\"p90\":" << h.p90 << ",\"p99\":" << h.p99
+                 << ",\"p999\":" << h.p999 << ",\"max\":" << h.max << '}';
+        }
+        file << "},\"counters\":{";
+        for (int i = 0; i < Counter_Count; ++i) {
+            file << (i > 0 ? "," : "") << '"' << GetCounterName(static_cast<CounterId>(i)) << "\":" << s.counters[i];
+        }
+        file << "},\"gauges\":{";
+        for (int i = 0; i < Gauge_Count; ++i) {
+            file << (i > 0 ? "," : "") << '"' << GetGaugeName(static_cast<GaugeId>(i)) << "\":" << s.gauges[i];
+        }
+        file << "}}\n";
+        return static_cast<bool>(file);
+    }
+
+    void Metrics::startDump(const std::string& path, int intervalSeconds) {
+        std::lock_guard<std::mutex> lock(_dumpMutex);
+        if (_dumpRunning || path.empty()) {
+            return;
+        }
+        _dumpRunning = true;
+        _dumpThread = std::thread(&Metrics::dumpLoop, this, path, std::max(1, intervalSeconds));
+        LOG_I("Metrics dump to {} every {}s", path, intervalSeconds);
+    }
+
+    void Metrics::stopDump() {
+        {
+            std::lock_guard<std::mutex> lock(_dumpMutex);
+            if (!_dumpRunning) {
+                return;
+            }
+            _dumpRunning = false;
+        }
+        _dumpWake.notify_all();
+        if (_dumpThread.joinable()) {
+            _dumpThread.join();
+        }
+    }
+
+    void Metrics::dumpLoop(std::string path, int intervalSeconds) {
+        std::unique_lock<std::mutex> lock(_dumpMutex);
+        for (;;) {
+            _dumpWake.wait_for(lock, std::chrono::seconds(intervalSeconds), [this]() { return !_dumpRunning; });
+            const bool stopping = !_dumpRunning;
+            lock.unlock();
+            dump(path);
+            if (stopping) {
+                break;
+            }
+            lock.lock();
+        }
+    }
+
+    void Metrics::log() const {
+        const MetricsSnapshot s = snapshot();
+        for (int i = 0; i < Metric_Count; ++i) {
+            const auto& h = s.latencies[i];
+            if (h.count == 0) {
+                continue;
+            }
+            LOG_I("Metric {:>12}: n={}, mean={:.0f}us, p50={:.0f}us, p99={:.0f}us, max={:.0f}us",
+                  GetMetricName(static_cast<MetricId>(i)), h.count, h.mean, h.p50, h.p99, h.max);
+        }
+        for (int i = 0; i < Counter_Count; ++i) {
+            LOG_I("Counter {:>16}: {}", GetCounterName(static_cast<CounterId>(i)), s.counters[i]);
+        }
+        for (int i = 0; i < Gauge_Count; ++i) {
+            LOG_I("Gauge   {:>16}: {}", GetGaugeName(static_cast<GaugeId>(i)), s.gauges[i]);
+        }
+    }
+
+} // namespace kfc
@@ -0,0 +1,345 @@
+#include <chrono>
+#include <memory>
+#include <algorithm>
+
+#include "core/pipeline.h"
+#include "core/utils.h"
+#include "core/trace.h"
+#include "calc/compare.h"
+#include "config/config.h"
+#include "log/logger.h"
+
+namespace kfc {
+
+    static constexpr size_t kFilteredQueueSize = 32;   // filter → buffer
+    static constexpr size_t kResultQueueSize = 16;     // → publish
+    static constexpr size_t kRepEventsReserve = 4;     // 一帧内完成的重复动作数上限（通常至多 1 个）
+    static constexpr double kTimingLogInterval = 10.0 * 1000000.0;  // 每 10 秒输出一次阶段耗时（微秒）
+
+    const char* GetStageName(PipelineStage stage) {
+        switch (stage) {
+        case Stage_Acquire: return "acquire";
+        case Stage_Filter:  return "filter";
+        case Stage_Buffer:  return "buffer";
+        case Stage_Score:   return "score";
+        case Stage_Publish: return "publish";
+        default:            return "unknown";
+        }
+    }
+
+    Pipeline::Pipeline(BodyFrameRing& ring, RingPolicy policy, PublishCallback onPublish) :
+        _ring(ring),
+        _cursor(ring.subscribe(policy)),
+        _onPublish(std::move(onPublish)),
+        _filtered(kFilteredQueueSize, QueuePolicy::Block),
+        _jobs(1, QueuePolicy::DropOldest),
+        _results(kResultQueueSize, QueuePolicy::Block),
+        _running(false),
+        _active(true),
+        _resetRequested(false),
+        _scoreResetRequested(false),
+        _smoothed(),
+        _smoothedValid(),
+        _session(Config::getInstance().getFeatureBufferSize(),
+                 static_cast<float>(Config::getInstance().resampleFPS),
+                 Config::getInstance().similarityHistorySize),
+        _governor() {
+        if (!_cursor) {
+            LOG_E("Pipeline failed to subscribe to body ring");
+        }
+    }
+
+    Pipeline::~Pipeline() {
+        stop();
+        if (_cursor) {
+            _ring.unsubscribe(*_cursor);
+        }
+    }
+
+    void Pipeline::reset() {
+        _session.getStats().reset();
+        _resetRequested.store(true, std::memory_order_release);
+        _scoreResetRequested.store(true, std::memory_order_release);
+    }
+
+    void Pipeline::start() {
+        if (!_cursor || _running.exchange(true, std::memory_order_acq_rel)) {
+            return;
+        }
+
+        _filtered.reopen();
+        _jobs.reopen();
+        _results.reopen();
+
+        _publishThread = std::thread(&Pipeline::publishLoop, this);
+        _scoreThread = std::thread(&Pipeline::scoreLoop, this);
+        _bufferThread = std::thread(&Pipeline::bufferLoop, this);
+        _filterThread = std::thread(&Pipeline::filterLoop, this);
+        LOG_I("Scoring pipeline started");
+    }
+
+    void Pipeline::stop() {
+        if (!_running.exchange(false, std::memory_order_acq_rel)) {
+            return;
+        }
+        notify();
+
+        // 按数据流方向依次关闭，上游的剩余数据全部流到下游
+        if (_filterThread.joinable()) _filterThread.join();
+        _filtered.close();
+        if (_bufferThread.joinable()) _bufferThread.join();
+        _jobs.close();
+        if (_scoreThread.joinable()) _scoreThread.join();
+        _results.close();
+        if (_publishThread.joinable()) _publishThread.join();
+        LOG_I("Scoring pipeline stopped, DTW workspace {} KB, quality level {}",
+              _session.getWorkspace().capacityBytes() / 1024, _governor.getLevel());
+    }
+
+    void Pipeline::notify() {
+        _wake.notify_one();
+    }
+
+    bool Pipeline::filterFrame(BodyFrame& body) {
+        // 没有任何被跟踪关节的帧无法比较
+        bool anyTracked = false;
+        for (const auto& joint : body.joints) {
+            if (joint.trackingState == TrackingState_Tracked) {
+                anyTracked = true;
+                break;
+            }
+        }
+        if (!anyTracked) {
+            return false;
+        }
+
+        const float alpha = Config::getInstance().getScoringParams()->filterSmoothing;
+        if (alpha <= 0.0f || body.bodyIndex < 0 || body.bodyIndex >= BODY_COUNT) {
+            return true;
+        }
+
+        // 指数平滑，换人（trackingId 变化）时重新开始
+        auto& previous = _smoothed[body.bodyIndex];
+        if (_smoothedValid[body.bodyIndex] && previous.trackingId == body.trackingId) {
+            for (int j = 0; j < JointType_Count; ++j) {
+                auto& current = body.joints[j];
+                const auto& last = previous.joints[j];
+                if (current.trackingState == TrackingState_NotTracked || last.trackingState == TrackingState_NotTracked) {
+                    continue;
+                }
+                current.position.X = alpha * last.position.X + (1.0f - alpha) * current.position.X;
+                current.position.Y = alpha * last.position.Y + (1.0f - alpha) * current.position.Y;
+                current.position.Z = alpha * last.position.Z + (1.0f - alpha) * current.position.Z;
+            }
+        }
+        previous = body;
+        _smoothedValid[body.bodyIndex] = true;
+        return true;
+    }
+
+    void Pipeline::filterLoop() {
+        Tracer::getInstance().setThreadName("pipeline.filter");
+        auto& metrics = Metrics::getInstance();
+        uint64_t lastDropped = _cursor->dropped.load(std::memory_order_relaxed);
+        BodyFrame body;
+        for (;;) {
+            const bool popped = _ring.pop(*_cursor, body);
+
+            // 落后一圈被覆盖的帧
+            const uint64_t dropped = _cursor->dropped.load(std::memory_order_relaxed);
+            if (dropped != lastDropped) {
+                metrics.add(Counter_RingSkipped, dropped - lastDropped);
+                lastDropped = dropped;
+            }
+
+            if (!popped) {
+                // 停止后环形缓冲已读空，退出
+                if (!_running.load(std::memory_order_acquire)) {
+                    break;
+                }
+                std::unique_lock<std::mutex> lock(_wakeMutex);
+                _wake.wait_for(lock, std::chrono::milliseconds(5));
+                continue;
+            }
+
+            if (!_active.load(std::memory_order_acquire)) {
+                continue;
+            }
+            KF_TRACE_SCOPE("filter");
+            if (!filterFrame(body)) {
+                metrics.add(Counter_InvalidFrames);
+                continue;
+            }
+
+            StampedFrame item;
+            item.body = body;
+            item.stamps = {};
+            item.stamps.sensorTime = body.timestamp;
+            item.stamps.ticks[Stage_Acquire] = body.acquireTick;
+            item.stamps.ticks[Stage_Filter] = QueryTicks();
+            if (!_filtered.push(std::move(item))) {
+                break;
+            }
+        }
+    }
+
+    void Pipeline::bufferLoop() {
+        Tracer::getInstance().setThreadName("pipeline.buffer");
+        const auto& config = Config::getInstance();
+        auto& metrics = Metrics::getInstance();
+        std::vector<RepEvent> repEvents;
+        repEvents.reserve(kRepEventsReserve);
+        FrameData frame;     // 复用关节数组
+        ScoreJob job;        // 与评分阶段轮转的快照缓冲
+
+        StampedFrame item;
+        while (_filtered.pop(item)) {
+            KF_TRACE_SCOPE("ingest");
+            if (_resetRequested.exchange(false, std::memory_order_acq_rel)) {
+                _session.resetInput();
+            }
+
+            // 重复计数器创建时取参数快照，重新加载的阈值在下次重置后生效；模板重新加载后立即重建
+            if (g_actionTemplate && !_session.isTemplateCurrent(*g_actionTemplate)) {
+                std::lock_guard<std::mutex> lock(templateMutex);
+                _session.setTemplate(*g_actionTemplate, *config.getScoringParams());
+            }
+
+            // 重采样、提取特征并逐帧推进重复计数
+            const INT64 ingestStart = QueryTicks();
+            item.body.toFrameData(frame);
+            repEvents.clear();
+            _session.addFrame(frame, repEvents);
+            item.stamps.ticks[Stage_Buffer] = QueryTicks();
+            metrics.record(Metric_Ingest, TicksToMicroseconds(item.stamps.ticks[Stage_Buffer] - ingestStart));
+
+            for (const auto& repEvent : repEvents) {
+                PipelineResult result = {};
+                result.kind = PipelineResult::Kind::Repetition;
+                result.rep = repEvent;
+                result.stamps = item.stamps;
+                _results.push(result);
+            }
+
+            // 按活动状态提交评分任务；评分阶段忙时旧任务被新快照替换
+            const ScoreTrigger trigger = g_actionTemplate ?
+                _session.nextTrigger(frame.timestamp, _governor.scaleInterval(config.getCompareInterval())) : ScoreTrigger::None;
+            if (trigger == ScoreTrigger::Gated) {
+                metrics.add(Counter_ComparesGated);
+            } else if (trigger == ScoreTrigger::Onset || trigger == ScoreTrigger::Offset) {
+                metrics.add(Counter_ActivityChanges);
+                LOG_FAST_D("Activity {} (energy {:.4f})", trigger == ScoreTrigger::Onset ? "onset" : "offset",
+                           _session.getActivity().energy());
+            }
+            if (ShouldScore(trigger)) {
+                _session.snapshot(job.features);
+                job.averageSpeed = _session.averageSpeed();
+                job.stamps = item.stamps;
+                const uint64_t replaced = _jobs.getDropped();
+                _jobs.pushSwap(job);
+                if (_jobs.getDropped() != replaced) {
+                    metrics.add(Counter_ComparesSkipped);
+                }
+            }
+        }
+    }
+
+    void Pipeline::scoreLoop() {
+        Tracer::getInstance().setThreadName("pipeline.score");
+        const auto& config = Config::getInstance();
+        ScoreJob job;
+        while (_jobs.popSwap(job)) {
+            KF_TRACE_SCOPE_ARG("score", "frames", job.features.size());
+            if (_scoreResetRequested.exchange(false, std::memory_order_acq_rel)) {
+                _session.resetScoring();
+            }
+            // 每个任务取一次参数快照，评分过程中不再访问配置；质量调节器按当前等级在副本上降级
+            const auto params = config.getScoringParams();
+            ScoringParams tuned = *params;
+            _governor.apply(tuned);
+            float similarity = 0.0f;
+            {
+                auto lock = LockTraced(templateMutex, "templateMutex.wait");
+                if (!g_actionTemplate) {
+                    continue;
+                }
+                similarity = _session.score(job.features, job.averageSpeed, *g_actionTemplate, tuned, job.stamps.sensorTime);
+            }
+            // 比较延迟：从缓冲阶段提交快照到得出结果，含排队等待
+            _governor.record(TicksToMicroseconds(QueryTicks() - job.stamps.ticks[Stage_Buffer]), params->governorBudget);
+
+            if (similarity < params->similarityThreshold) {
+                LOG_FAST_D("Similarity {:.2f} below threshold {:.2f}",
+                      similarity * 100.0f, params->similarityThreshold * 100.0f);
+            } else {
+                LOG_FAST_D("Similarity {:.2f} above threshold {:.2f}",
+                      similarity * 100.0f, params->similarityThreshold * 100.0f);
+            }
+
+            PipelineResult result = {};
+            result.kind = PipelineResult::Kind::Similarity;
+            result.similarity = similarity;
+            result.stamps = job.stamps;
+            result.stamps.ticks[Stage_Score] = QueryTicks();
+            _results.push(result);
+        }
+    }
+
+    void Pipeline::publishLoop() {
+        Tracer::getInstance().setThreadName("pipeline.publish");
+        INT64 lastLogTick = QueryTicks();
+        PipelineResult result;
+        while (_results.pop(result)) {
+            if (_onPublish) {
+                KF_TRACE_SCOPE("publish");
+                _onPublish(result);
+            }
+            result.stamps.ticks[Stage_Publish] = QueryTicks();
+            recordTiming(result.stamps);
+
+            if (TicksToMicroseconds(result.stamps.ticks[Stage_Publish] - lastLogTick) >= kTimingLogInterval) {
+                lastLogTick = result.stamps.ticks[Stage_Publish];
+                logTimings();
+            }
+        }
+    }
+
+    void Pipeline::recordTiming(const FrameStamps& stamps) {
+        INT64 previous = stamps.ticks[Stage_Acquire];
+        for (int s = Stage_Filter; s < Stage_Count; ++s) {
+            if (stamps.ticks[s] == 0) {
+                continue;  // 重复计数结果不经过评分阶段
+            }
+            if (previous != 0) {
+                _timings[s].record(TicksToMicroseconds(stamps.ticks[s] - previous));
+            }
+            previous = stamps.ticks[s];
+        }
+
+        // 端到端：采集到发布
+        if (stamps.ticks[Stage_Acquire] != 0) {
+            double micros = TicksToMicroseconds(stamps.ticks[Stage_Publish] - stamps.ticks[Stage_Acquire]);
+            _timings[Stage_Acquire].record(micros);
+            Metrics::getInstance().record(Metric_EndToEnd, micros);
+        }
+    }
+
+    HistogramSnapshot Pipeline::getStageTiming(PipelineStage stage) const {
+        return _timings[stage].snapshot();
+    }
+
+    void Pipeline::logTimings() const {
+        for (int s = Stage_Filter; s < Stage_Count; ++s) {
+            const HistogramSnapshot timing = _timings[s].snapshot();
+            LOG_I("Pipeline {:>8}: n={}, mean={:.0f}us, p50={:.0f}us, p99={:.0f}us, max={:.0f}us",
+                  GetStageName(static_cast<PipelineStage>(s)),
+                  timing.count, timing.mean, timing.p50, timing.p99, timing.max);
+        }
+        const HistogramSnapshot total = _timings[Stage_Acquire].snapshot();
+        LOG_I("Pipeline end-to-end: n={}, mean={:.0f}us, p50={:.0f}us, p99={:.0f}us, max={:.0f}us, "
+              "ring skipped={}, jobs replaced={}",
+              total.count, total.mean, total.p50, total.p99, total.max,
+              _cursor ? _cursor->dropped.load(std::memory_order_relaxed) : 0, _jobs.getDropped());
+    }
+
+} // namespace kfc
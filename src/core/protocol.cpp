@@ -0,0 +1,120 @@
+#define NOMINMAX
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <mutex>
+#include <algorithm>
+
+#include "core/protocol.h"
+#include "log/logger.h"
+
+#pragma comment(lib, "Ws2_32.lib")
+
+namespace kfc {
+
+    WireFrame EncodeFrame(const BodyFrame& body) {
+        WireFrame wire;
+        wire.timestamp = body.timestamp;
+        for (int j = 0; j < JointType_Count; ++j) {
+            const auto& joint = body.joints[j];
+            wire.joints[j].x = joint.position.X;
+            wire.joints[j].y = joint.position.Y;
+            wire.joints[j].z = joint.position.Z;
+            wire.joints[j].trackingState = static_cast<uint8_t>(joint.trackingState);
+        }
+        return wire;
+    }
+
+    void DecodeFrame(const WireFrame& wire, FrameData& out) {
+        out.timestamp = wire.timestamp;
+        out.joints.resize(JointType_Count);
+        for (int j = 0; j < JointType_Count; ++j) {
+            auto& joint = out.joints[j];
+            joint.type = static_cast<JointType>(j);
+            joint.position.X = wire.joints[j].x;
+            joint.position.Y = wire.joints[j].y;
+            joint.position.Z = wire.joints[j].z;
+            joint.trackingState = static_cast<TrackingState>(
+                std::min<uint8_t>(wire.joints[j].trackingState, TrackingState_Tracked));
+        }
+    }
+
+    bool InitSockets() {
+        static std::once_flag once;
+        static bool initialized = false;
+        std::call_once(once, []() {
+            WSADATA data;
+            const int result = WSAStartup(MAKEWORD(2, 2), &data);
+            if (result != 0) {
+                LOG_E("WSAStartup failed: {}", result);
+                return;
+            }
+            initialized = true;
+        });
+        return initialized;
+    }
+
+    static bool SendAll(SOCKET socket, const char* data, size_t length) {
+        while (length > 0) {
+            const int sent = send(socket, data, static_cast<int>(length), 0);
+            if (sent <= 0) {
+                return false;
+            }
+            data += sent;
+            length -= static_cast<size_t>(sent);
+        }
+        return true;
+    }
+
+    static bool ReceiveAll(SOCKET socket, char* data, size_t length) {
+        while (length > 0) {
+            const int received = recv(socket, data, static_cast<int>(length), 0);
+            if (received <= 0) {
+                return false;   // 对端关闭或出错
+            }
+            data += received;
+            length -= static_cast<size_t>(received);
+        }
+        return true;
+    }
+
+    bool SendPacket(uintptr_t socket, MessageType type, const void* payload, uint32_t length) {
+        // 消息头与负载合并为一次 send，避免 Nagle 与延迟确认叠加
+        char buffer[sizeof(MessageHeader) + kMaxMessageSize];
+        if (length > kMaxMessageSize) {
+            return false;
+        }
+
+        MessageHeader header = { static_cast<uint16_t>(type), 0, length };
+        memcpy(buffer, &header, sizeof(header));
+        if (length > 0) {
+            memcpy(buffer + sizeof(header), payload, length);
+        }
+        return SendAll(static_cast<SOCKET>(socket), buffer, sizeof(header) + length);
+    }
+
+    bool ReceivePacket(uintptr_t socket, MessageHeader& header, std::vector<char>& payload) {
+        if (!ReceiveAll(static_cast<SOCKET>(socket), reinterpret_cast<char*>(&header), sizeof(header))) {
+            return false;
+        }
+        if (header.length > kMaxMessageSize) {
+            LOG_W("Protocol error: message of {} bytes", header.length);
+            return false;
+        }
+        payload.resize(header.length);
+        return header.length == 0 ||
+               ReceiveAll(static_cast<SOCKET>(socket), payload.data(), header.length);
+    }
+
+    void CloseSocket(uintptr_t socket) {
+        if (static_cast<SOCKET>(socket) != INVALID_SOCKET) {
+            closesocket(static_cast<SOCKET>(socket));
+        }
+    }
+
+    void ShutdownSocket(uintptr_t socket) {
+        if (static_cast<SOCKET>(socket) != INVALID_SOCKET) {
+            shutdown(static_cast<SOCKET>(socket), SD_BOTH);
+        }
+    }
+
+} // namespace kfc
@@ -0,0 +1,66 @@
+#include <chrono>
+#include <thread>
+
+#include "core/replay.h"
+#include "core/utils.h"
+#include "log/logger.h"
+
+namespace kfc {
+
+    bool ReplaySource::open(const std::string& filename) {
+        _frames.clear();
+        if (!LoadFrames(filename, _frames)) {
+            return false;
+        }
+        LOG_I("Replay source loaded {} frames from {}", _frames.size(), filename);
+        return !_frames.empty();
+    }
+
+    size_t ReplaySource::run(BodyFrameRing& ring, const std::atomic<bool>& stop,
+                             const std::function<void()>& onPublish) const {
+        return run(stop, [&ring, &stop, &onPublish](const BodyFrame& body) {
+            while (!ring.push(body)) {
+                if (stop.load(std::memory_order_acquire)) {
+                    return false;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            if (onPublish) {
+                onPublish();
+            }
+            return true;
+        });
+    }
+
+    size_t ReplaySource::run(const std::atomic<bool>& stop, const std::function<bool(const BodyFrame&)>& sink) const {
+        if (_frames.empty()) {
+            return 0;
+        }
+
+        const auto startClock = std::chrono::steady_clock::now();
+        const INT64 startTime = _frames.front().timestamp;
+        size_t pushed = 0;
+
+        for (const auto& frame : _frames) {
+            if (stop.load(std::memory_order_acquire)) {
+                break;
+            }
+
+            // 按录制时间戳的节奏推送（时间戳单位 100ns）
+            if (_speed > 0.0f) {
+                auto offset = std::chrono::microseconds(
+                    static_cast<INT64>((frame.timestamp - startTime) / 10 / _speed));
+                std::this_thread::sleep_until(startClock + offset);
+            }
+
+            BodyFrame body = BodyFrame::fromFrameData(frame);
+            body.acquireTick = QueryTicks();
+            if (!sink(body)) {
+                break;
+            }
+            ++pushed;
+        }
+        return pushed;
+    }
+
+} // namespace kfc
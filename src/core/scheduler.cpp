@@ -0,0 +1,209 @@
+#include <limits>
+
+#include "core/scheduler.h"
+#include "core/trace.h"
+#include "log/logger.h"
+
+namespace kfc {
+
+    static constexpr size_t kInitialQueueCapacity = 64;   // 每个队列预留的任务数，超出时扩容
+    static constexpr size_t kNoWorker = std::numeric_limits<size_t>::max();
+    static constexpr int kWaitSpinCount = 64;             // 阻塞前让出时间片的次数，剩余块通常很快结束
+
+    // 当前线程在线程池中的序号，非工作线程为 kNoWorker
+    static thread_local size_t t_workerIndex = kNoWorker;
+
+    TaskScheduler::TaskScheduler() :
+        _queued(0),
+        _running(true),
+        _doneWaiters(0) {
+        // 工作线程会用到跟踪器，先构造它，保证析构顺序在线程池之后
+        Tracer::getInstance();
+
+        for (auto& queue : _shared) {
+            queue.reserve(kInitialQueueCapacity);
+        }
+        const size_t count = std::max(1u, std::thread::hardware_concurrency());
+        for (size_t i = 0; i < count; ++i) {
+            auto worker = std::make_unique<Worker>();
+            for (auto& queue : worker->queues) {
+                queue.reserve(kInitialQueueCapacity);
+            }
+            _workers.push_back(std::move(worker));
+        }
+        // 队列全部建好后再启动线程，窃取时可以安全地遍历 _workers
+        for (size_t i = 0; i < count; ++i) {
+            _workers[i]->thread = std::thread(&TaskScheduler::workerLoop, this, i);
+        }
+        LOG_I("Task scheduler started with {} workers", count);
+    }
+
+    TaskScheduler::~TaskScheduler() {
+        {
+            std::lock_guard<std::mutex> lock(_sleepMutex);
+            _running.store(false, std::memory_order_release);
+        }
+        _wake.notify_all();
+        // 工作线程在队列清空后才退出，已提交的任务都会执行
+        for (auto& worker : _workers) {
+            if (worker->thread.joinable()) {
+                worker->thread.join();
+            }
+        }
+    }
+
+    void TaskScheduler::post(TaskPriority priority, const Task& task) {
+        const size_t p = static_cast<size_t>(priority);
+        const size_t self = t_workerIndex;
+        if (self != kNoWorker) {
+            std::lock_guard<std::mutex> lock(_workers[self]->mutex);
+            _workers[self]->queues[p].push_back(task);
+        } else {
+            std::lock_guard<std::mutex> lock(_sharedMutex);
+            _shared[p].push_back(task);
+        }
+        _queued.fetch_add(1, std::memory_order_release);
+
+        // 持有睡眠锁再通知，避免工作线程检查完条件、尚未进入等待时错过唤醒
+        { std::lock_guard<std::mutex> lock(_sleepMutex); }
+        _wake.notify_one();
+    }
+
+    bool TaskScheduler::findTask(TaskPriority maxPriority, Task& task) {
+        if (_queued.load(std::memory_order_acquire) == 0) {
+            return false;
+        }
+
+        const size_t self = t_workerIndex;
+        const size_t count = _workers.size();
+        for (size_t p = 0; p <= static_cast<size_t>(maxPriority); ++p) {
+            if (self != kNoWorker) {
+                Worker& worker = *_workers[self];
+                std::lock_guard<std::mutex> lock(worker.mutex);
+                auto& queue = worker.queues[p];
+                if (!queue.empty()) {
+                    task = queue.back();
+                    queue.pop_back();
+                    _queued.fetch_sub(1, std::memory_order_relaxed);
+                    return true;
+                }
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(_sharedMutex);
+                auto& queue = _shared[p];
+                if (!queue.empty()) {
+                    task = queue.front();
+                    queue.pop_front();
+                    _queued.fetch_sub(1, std::memory_order_relaxed);
+                    return true;
+                }
+            }
+
+            // 从下一个线程开始轮流窃取，分散竞争
+            const size_t start = self == kNoWorker ? 0 : self + 1;
+            for (size_t k = 0; k < count; ++k) {
+                const size_t victim = (start + k) % count;
+                if (victim == self) {
+                    continue;
+                }
+                Worker& worker = *_workers[victim];
+                std::lock_guard<std::mutex> lock(worker.mutex);
+                auto& queue = worker.queues[p];
+                if (!queue.empty()) {
+                    task = queue.front();
+                    queue.pop_front();
+                    _queued.fetch_sub(1, std::memory_order_relaxed);
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    size_t TaskScheduler::takeOwnTasks(TaskPriority priority, const void* context, Task& task) {
+        // 本次提交的任务在队列尾部附近：从尾部向前扫描，用尾部元素填补空位，不整体搬移
+        auto takeMatching = [context, &task](CircularBuffer<Task>& queue) {
+            size_t taken = 0;
+            for (size_t i = queue.size(); i-- > 0;) {
+                if (queue[i].context != context) {
+                    continue;
+                }
+                task = queue[i];
+                queue[i] = queue.back();
+                queue.pop_back();
+                ++taken;
+            }
+            return taken;
+        };
+
+        const size_t p = static_cast<size_t>(priority);
+        const size_t self = t_workerIndex;
+        size_t taken = 0;
+        if (self != kNoWorker) {
+            std::lock_guard<std::mutex> lock(_workers[self]->mutex);
+            taken = takeMatching(_workers[self]->queues[p]);
+        } else {
+            std::lock_guard<std::mutex> lock(_sharedMutex);
+            taken = takeMatching(_shared[p]);
+        }
+        if (taken > 0) {
+            _queued.fetch_sub(taken, std::memory_order_relaxed);
+        }
+        return taken;
+    }
+
+    void TaskScheduler::wait(const std::atomic<size_t>& pending, const void* context, TaskPriority priority) {
+        // 帮助任务只会在提交时入队，取回一次之后队列中不会再有本次的任务
+        Task task;
+        for (size_t taken = takeOwnTasks(priority, context, task); taken > 0; --taken) {
+            task.run(task.context);
+        }
+
+        for (int spin = 0; spin < kWaitSpinCount; ++spin) {
+            if (pending.load() == 0) {
+                return;
+            }
+            std::this_thread::yield();
+        }
+
+        // 先登记再检查 pending，与 runHelper 先递减再检查等待者配对，不会错过通知
+        _doneWaiters.fetch_add(1);
+        {
+            std::unique_lock<std::mutex> lock(_doneMutex);
+            _done.wait(lock, [&pending]() { return pending.load() == 0; });
+        }
+        _doneWaiters.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void TaskScheduler::notifyDone() {
+        if (_doneWaiters.load() == 0) {
+            return;
+        }
+        // 持有锁再通知，避免等待方检查完条件、尚未进入等待时错过唤醒
+        { std::lock_guard<std::mutex> lock(_doneMutex); }
+        _done.notify_all();
+    }
+
+    void TaskScheduler::workerLoop(size_t index) {
+        t_workerIndex = index;
+        Tracer::getInstance().setThreadName("scheduler");
+
+        Task task;
+        for (;;) {
+            if (findTask(TaskPriority::Batch, task)) {
+                task.run(task.context);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(_sleepMutex);
+            _wake.wait(lock, [this]() {
+                return _queued.load(std::memory_order_acquire) > 0 || !_running.load(std::memory_order_acquire);
+            });
+            if (!_running.load(std::memory_order_acquire) && _queued.load(std::memory_order_acquire) == 0) {
+                return;
+            }
+        }
+    }
+
+} // namespace kfc
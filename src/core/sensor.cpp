@@ -0,0 +1,160 @@
+#include "core/sensor.h"
+#include "core/utils.h"
+#include "core/metrics.h"
+#include "core/trace.h"
+#include "log/logger.h"
+
+namespace kfc {
+
+    KinectBodySource::KinectBodySource() :
+        _reader(nullptr),
+        _frameEvent(0),
+        _running(false),
+        _lastFrameTime(0) {}
+
+    KinectBodySource::~KinectBodySource() {
+        stop();
+        close();
+    }
+
+    HRESULT KinectBodySource::open(IKinectSensor* sensor) {
+        if (!sensor) {
+            return E_FAIL;
+        }
+
+        IBodyFrameSource* pBodyFrameSource = nullptr;
+        HRESULT hr = sensor->get_BodyFrameSource(&pBodyFrameSource);
+        if (SUCCEEDED(hr)) {
+            hr = pBodyFrameSource->OpenReader(&_reader);
+        }
+        SafeRelease(pBodyFrameSource);
+
+        if (SUCCEEDED(hr)) {
+            hr = _reader->SubscribeFrameArrived(&_frameEvent);
+        }
+        if (FAILED(hr)) {
+            LOG_E("Failed to open body frame reader: 0x{:08X}", static_cast<unsigned>(hr));
+            close();
+        }
+        return hr;
+    }
+
+    bool KinectBodySource::start(BodyFrameRing& ring, std::function<void()> onPublish) {
+        return start([&ring, onPublish = std::move(onPublish)](INT64, const BodyFrame* bodies, int count) {
+            for (int i = 0; i < count; ++i) {
+                // 录制线程落后时环形缓冲会拒绝写入，此时丢弃该帧而不是阻塞采集
+                if (!ring.push(bodies[i])) {
+                    Metrics::getInstance().add(Counter_RingRejected);
+                    KF_LOG_EVERY_MS(1000, LOG_FAST_W, "Body ring full, frame dropped (rejected {})", ring.getRejected());
+                } else if (onPublish) {
+                    onPublish();
+                }
+            }
+        });
+    }
+
+    bool KinectBodySource::start(BodySink sink) {
+        if (!_reader || _running.load(std::memory_order_acquire)) {
+            return false;
+        }
+        _running.store(true, std::memory_order_release);
+        _thread = std::thread(&KinectBodySource::run, this, std::move(sink));
+        return true;
+    }
+
+    void KinectBodySource::stop() {
+        _running.store(false, std::memory_order_release);
+        if (_thread.joinable()) {
+            _thread.join();
+        }
+    }
+
+    void KinectBodySource::close() {
+        if (_reader && _frameEvent) {
+            _reader->UnsubscribeFrameArrived(_frameEvent);
+        }
+        _frameEvent = 0;
+        SafeRelease(_reader);
+    }
+
+    void KinectBodySource::run(BodySink sink) {
+        Tracer::getInstance().setThreadName("sensor");
+        while (_running.load(std::memory_order_acquire)) {
+            // 等待帧到达，超时后检查停止标志
+            if (WaitForSingleObject(reinterpret_cast<HANDLE>(_frameEvent), 100) != WAIT_OBJECT_0) {
+                continue;
+            }
+
+            IBodyFrameArrivedEventArgs* pArgs = nullptr;
+            if (SUCCEEDED(_reader->GetFrameArrivedEventData(_frameEvent, &pArgs))) {
+                SafeRelease(pArgs);  // 复位事件
+            }
+
+            IBodyFrame* pBodyFrame = nullptr;
+            HRESULT hr = _reader->AcquireLatestFrame(&pBodyFrame);
+            if (FAILED(hr)) {
+                continue;
+            }
+
+            KF_TRACE_SCOPE("AcquireBody");
+            const INT64 acquireTick = QueryTicks();
+            INT64 nTime = 0;
+            IBody* ppBodies[BODY_COUNT] = { 0 };
+
+            hr = pBodyFrame->get_RelativeTime(&nTime);
+            if (SUCCEEDED(hr)) {
+                hr = pBodyFrame->GetAndRefreshBodyData(_countof(ppBodies), ppBodies);
+            }
+
+            if (SUCCEEDED(hr)) {
+                BodyFrame bodies[BODY_COUNT];
+                int count = 0;
+                for (int i = 0; i < BODY_COUNT; ++i) {
+                    IBody* pBody = ppBodies[i];
+                    if (!pBody) {
+                        continue;
+                    }
+
+                    BOOLEAN bTracked = false;
+                    if (FAILED(pBody->get_IsTracked(&bTracked)) || !bTracked) {
+                        continue;
+                    }
+
+                    Joint joints[JointType_Count];
+                    if (FAILED(pBody->GetJoints(_countof(joints), joints))) {
+                        continue;
+                    }
+
+                    BodyFrame& body = bodies[count];
+                    body = {};
+                    body.timestamp = nTime;
+                    body.acquireTick = acquireTick;
+                    body.bodyIndex = i;
+                    body.leftHandState = HandState_Unknown;
+                    body.rightHandState = HandState_Unknown;
+                    pBody->get_TrackingId(&body.trackingId);
+                    pBody->get_HandLeftState(&body.leftHandState);
+                    pBody->get_HandRightState(&body.rightHandState);
+
+                    for (int j = 0; j < JointType_Count; ++j) {
+                        body.joints[j].type = joints[j].JointType;
+                        body.joints[j].position = joints[j].Position;
+                        body.joints[j].trackingState = joints[j].TrackingState;
+                    }
+
+                    ++count;
+                }
+
+                sink(nTime, bodies, count);
+                _lastFrameTime.store(nTime, std::memory_order_release);
+                Metrics::getInstance().record(Metric_Acquire, TicksToMicroseconds(QueryTicks() - acquireTick));
+            }
+
+            for (int i = 0; i < BODY_COUNT; ++i) {
+                SafeRelease(ppBodies[i]);
+            }
+            SafeRelease(pBodyFrame);
+        }
+    }
+
+} // namespace kfc
@@ -0,0 +1,446 @@
+#define NOMINMAX
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <string>
+
+#include "core/server.h"
+#include "core/protocol.h"
+#include "core/metrics.h"
+#include "core/trace.h"
+#include "core/utils.h"
+#include "calc/session.h"
+#include "config/config.h"
+#include "log/logger.h"
+
+namespace kfc {
+
+    static constexpr size_t kReadyQueueSize = 1024;     // 不小于会话上限：每个会话至多在队列中一次，入队不会阻塞
+    static constexpr DWORD kHandshakeTimeoutMs = 5000;  // 连接后多久内须收到 Hello
+    static constexpr int kAcceptBackoffMinMs = 10;      // accept 暂时性失败后的首次重试间隔
+    static constexpr int kAcceptBackoffMaxMs = 1000;    // 连续失败时间隔翻倍，直到此上限
+
+    // accept 失败是否为暂时性的（连接在握手中被重置、句柄或缓冲暂时耗尽等），可稍后重试
+    static bool IsTransientAcceptError(int error) {
+        switch (error) {
+        case WSAEINTR:
+        case WSAEWOULDBLOCK:
+        case WSAEINPROGRESS:
+        case WSAECONNRESET:
+        case WSAECONNABORTED:
+        case WSAEMFILE:
+        case WSAENOBUFS:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    // 设置接收超时（毫秒），0 表示不限；超时后 recv 失败，读线程按断开处理
+    static void SetReceiveTimeout(uintptr_t socket, DWORD timeoutMs) {
+        setsockopt(static_cast<SOCKET>(socket), SOL_SOCKET, SO_RCVTIMEO,
+                   reinterpret_cast<const char*>(&timeoutMs), sizeof(timeoutMs));
+    }
+
+    // 一个采集站的连接与评分会话
+    struct ScoringServer::Connection {
+        // 评分任务：特征快照与触发帧的到达时刻
+        struct ScoreJob {
+            std::vector<FrameFeature> features;
+            float averageSpeed = 0.0f;
+            INT64 timestamp = 0;
+            INT64 receiveTick = 0;
+        };
+
+        uintptr_t socket;
+        uint32_t id;
+        std::string name;
+        ScoringSession session;
+        std::thread reader;
+        std::mutex sendMutex;                    // 读线程与工作线程都会发送
+
+        // 评分任务交接：读线程写入最新快照，工作线程取走
+        std::mutex jobMutex;
+        std::condition_variable idle;
+        ScoreJob job;
+        ScoreJob running;                        // 工作线程正在评分的任务，与 job 交换以复用快照缓冲
+        bool hasJob = false;
+        bool scheduled = false;                  // 已在 _ready 队列中或正在评分
+        std::atomic<bool> resetScoring{ false };
+
+        LatencyHistogram latency;                // 收到触发帧到发出评分（微秒）
+        std::atomic<uint64_t> frames{ 0 };
+        std::atomic<uint64_t> scores{ 0 };
+        std::atomic<uint64_t> repetitions{ 0 };
+        std::atomic<uint64_t> skipped{ 0 };
+        std::atomic<bool> finished{ false };
+
+        Connection(uintptr_t socket, uint32_t id) :
+            socket(socket),
+            id(id),
+            session(Config::getInstance().getFeatureBufferSize(),
+                    static_cast<float>(Config::getInstance().resampleFPS),
+                    Config::getInstance().similarityHistorySize) {}
+
+        ~Connection() {
+            CloseSocket(socket);
+        }
+
+        template<typename T>
+        bool send(MessageType type, const T& payload) {
+            std::lock_guard<std::mutex> lock(sendMutex);
+            return SendPacket(socket, type, payload);
+        }
+    };
+
+    ScoringServer::ScoringServer() :
+        _listenSocket(static_cast<uintptr_t>(INVALID_SOCKET)),
+        _ready(kReadyQueueSize, QueuePolicy::Block),
+        _governor(),
+        _maxSessions(1),
+        _running(false),
+        _nextSessionId(1) {}
+
+    ScoringServer::~ScoringServer() {
+        stop();
+    }
+
+    bool ScoringServer::start(const std::string& host, uint16_t port, size_t workers) {
+        if (_running.load(std::memory_order_acquire) || !InitSockets()) {
+            return false;
+        }
+
+        try {
+            _template = std::make_unique<ActionTemplate>(Config::getInstance().standardPath);
+        } catch (const std::exception& e) {
+            LOG_E("Scoring server: load standard action: {}", e.what());
+            return false;
+        }
+
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        if (inet_pton(AF_INET, host.c_str(), &address.sin_addr) != 1) {
+            LOG_E("Scoring server: invalid listen address '{}'", host);
+            return false;
+        }
+
+        SOCKET listenSocket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+        if (listenSocket == INVALID_SOCKET) {
+            LOG_E("Scoring server: socket failed: {}", WSAGetLastError());
+            return false;
+        }
+
+        if (bind(listenSocket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == SOCKET_ERROR ||
+            listen(listenSocket, SOMAXCONN) == SOCKET_ERROR) {
+            LOG_E("Scoring server: cannot listen on {}:{}: {}", host, port, WSAGetLastError());
+            closesocket(listenSocket);
+            return false;
+        }
+
+        if (workers == 0) {
+            workers = std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        _listenSocket = static_cast<uintptr_t>(listenSocket);
+        _maxSessions = std::min<size_t>(kReadyQueueSize, static_cast<size_t>(Config::getInstance().serverMaxSessions));
+        _ready.reopen();
+        _running.store(true, std::memory_order_release);
+        for (size_t i = 0; i < workers; ++i) {
+            _workers.emplace_back(&ScoringServer::workerLoop, this);
+        }
+        _acceptThread = std::thread(&ScoringServer::acceptLoop, this);
+
+        LOG_I("Scoring server listening on {}:{} with {} workers, template {} frames",
+              host, port, workers, _template->getFeatures().size());
+        if (address.sin_addr.s_addr != htonl(INADDR_LOOPBACK)) {
+            LOG_W("Scoring server accepts connections from other hosts; the protocol is not authenticated");
+        }
+        return true;
+    }
+
+    void ScoringServer::stop() {
+        if (!_running.exchange(false, std::memory_order_acq_rel)) {
+            return;
+        }
+
+        // 关闭监听套接字使 accept 返回
+        ShutdownSocket(_listenSocket);
+        CloseSocket(_listenSocket);
+        _listenSocket = static_cast<uintptr_t>(INVALID_SOCKET);
+        if (_acceptThread.joinable()) {
+            _acceptThread.join();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_connectionsMutex);
+            for (const auto& connection : _connections) {
+                ShutdownSocket(connection->socket);
+            }
+        }
+        reap(true);
+
+        _ready.close();
+        for (auto& worker : _workers) {
+            worker.join();
+        }
+        _workers.clear();
+        LOG_I("Scoring server stopped");
+    }
+
+    size_t ScoringServer::getSessionCount() const {
+        std::lock_guard<std::mutex> lock(_connectionsMutex);
+        return static_cast<size_t>(std::count_if(_connections.begin(), _connections.end(),
+            [](const std::shared_ptr<Connection>& connection) { return !connection->finished.load(); }));
+    }
+
+    void ScoringServer::acceptLoop() {
+        Tracer::getInstance().setThreadName("server.accept");
+        int backoffMs = 0;
+        while (_running.load(std::memory_order_acquire)) {
+            SOCKET clientSocket = accept(static_cast<SOCKET>(_listenSocket), nullptr, nullptr);
+            if (clientSocket == INVALID_SOCKET) {
+                if (!_running.load(std::memory_order_acquire)) {
+                    break;   // stop() 关闭了监听套接字
+                }
+                const int error = WSAGetLastError();
+                if (!IsTransientAcceptError(error)) {
+                    LOG_E("Scoring server: accept failed: {}, no longer accepting connections", error);
+                    break;
+                }
+                // 暂时性错误按指数退避重试，避免持续失败时空转占满一个核
+                backoffMs = std::min(kAcceptBackoffMaxMs, std::max(kAcceptBackoffMinMs, backoffMs * 2));
+                LOG_W("Scoring server: accept failed: {}, retrying in {} ms", error, backoffMs);
+                std::this_thread::sleep_for(std::chrono::milliseconds(backoffMs));
+                continue;
+            }
+            backoffMs = 0;
+
+            // 会话数达到上限时拒绝新连接，已结束的会话先回收
+            reap(false);
+            {
+                std::lock_guard<std::mutex> lock(_connectionsMutex);
+                if (_connections.size() >= _maxSessions) {
+                    LOG_W("Scoring server: {} sessions already connected, rejecting connection", _connections.size());
+                    closesocket(clientSocket);
+                    continue;
+                }
+            }
+
+            // 握手须在 kHandshakeTimeoutMs 内完成，半开或不发数据的连接不会一直占着读线程
+            SetReceiveTimeout(static_cast<uintptr_t>(clientSocket), kHandshakeTimeoutMs);
+
+            // 评分结果很小，关闭 Nagle 以免被攒包延迟
+            const int noDelay = 1;
+            setsockopt(clientSocket, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
+
+            auto connection = std::make_shared<Connection>(static_cast<uintptr_t>(clientSocket),
+                _nextSessionId.fetch_add(1, std::memory_order_relaxed));
+
+            std::lock_guard<std::mutex> lock(_connectionsMutex);
+            connection->reader = std::thread(&ScoringServer::readLoop, this, connection);
+            _connections.push_back(std::move(connection));
+        }
+    }
+
+    void ScoringServer::reap(bool all) {
+        std::vector<std::shared_ptr<Connection>> finished;
+        {
+            std::lock_guard<std::mutex> lock(_connectionsMutex);
+            auto it = std::partition(_connections.begin(), _connections.end(),
+                [all](const std::shared_ptr<Connection>& connection) {
+                    return !all && !connection->finished.load(std::memory_order_acquire);
+                });
+            finished.assign(std::make_move_iterator(it), std::make_move_iterator(_connections.end()));
+            _connections.erase(it, _connections.end());
+        }
+        for (auto& connection : finished) {
+            if (connection->reader.joinable()) {
+                connection->reader.join();
+            }
+        }
+    }
+
+    void ScoringServer::readLoop(std::shared_ptr<Connection> connection) {
+        Tracer::getInstance().setThreadName("server.session");
+        Connection& conn = *connection;
+        MessageHeader header;
+        std::vector<char> payload;
+
+        WireHello hello;
+        if (!ReceivePacket(conn.socket, header, payload) ||
+            header.type != static_cast<uint16_t>(MessageType::Hello) ||
+            !ReadPayload(header, payload, hello) ||
+            hello.magic != kProtocolMagic || hello.version != kProtocolVersion) {
+            LOG_W("Session {}: bad handshake, closing", conn.id);
+            conn.finished.store(true, std::memory_order_release);
+            return;
+        }
+        conn.name.assign(hello.name, strnlen(hello.name, kClientNameSize));
+
+        const auto& config = Config::getInstance();
+        SetReceiveTimeout(conn.socket, static_cast<DWORD>(config.serverIdleTimeout) * 1000);
+        conn.session.setTemplate(*_template, *config.getScoringParams());
+        const WireWelcome welcome = { conn.id, static_cast<uint32_t>(_template->getFeatures().size()) };
+        conn.send(MessageType::Welcome, welcome);
+        LOG_I("Session {} ({}) connected", conn.id, conn.name);
+
+        const INT64 compareInterval = config.getCompareInterval();
+        WireFrame wire;
+        FrameData frame;
+        std::vector<RepEvent> reps;
+        Connection::ScoreJob job;     // 与 conn.job 交换，快照缓冲在读线程与工作线程之间轮转
+        bool bye = false;
+
+        while (!bye && ReceivePacket(conn.socket, header, payload)) {
+            switch (static_cast<MessageType>(header.type)) {
+            case MessageType::Frame: {
+                if (!ReadPayload(header, payload, wire)) {
+                    LOG_W("Session {}: malformed frame of {} bytes", conn.id, header.length);
+                    bye = true;
+                    break;
+                }
+                const INT64 receiveTick = QueryTicks();
+                DecodeFrame(wire, frame);
+                conn.frames.fetch_add(1, std::memory_order_relaxed);
+
+                KF_TRACE_SCOPE("ingest");
+                reps.clear();
+                conn.session.addFrame(frame, reps);
+                for (const auto& rep : reps) {
+                    conn.repetitions.fetch_add(1, std::memory_order_relaxed);
+                    const WireRepetition message = { static_cast<uint32_t>(rep.index), static_cast<uint32_t>(rep.frameCount),
+                                                     rep.startTime, rep.endTime, rep.score };
+                    conn.send(MessageType::Repetition, message);
+                }
+
+                // 按活动状态提交评分任务
+                const ScoreTrigger trigger = conn.session.nextTrigger(frame.timestamp, _governor.scaleInterval(compareInterval));
+                if (trigger == ScoreTrigger::Gated) {
+                    Metrics::getInstance().add(Counter_ComparesGated);
+                } else if (trigger == ScoreTrigger::Onset || trigger == ScoreTrigger::Offset) {
+                    Metrics::getInstance().add(Counter_ActivityChanges);
+                }
+                if (ShouldScore(trigger)) {
+                    conn.session.snapshot(job.features);
+                    job.averageSpeed = conn.session.averageSpeed();
+                    job.timestamp = frame.timestamp;
+                    job.receiveTick = receiveTick;
+
+                    bool schedule = false;
+                    {
+                        std::lock_guard<std::mutex> lock(conn.jobMutex);
+                        if (conn.hasJob) {
+                            conn.skipped.fetch_add(1, std::memory_order_relaxed);
+                            Metrics::getInstance().add(Counter_ComparesSkipped);
+                        }
+                        std::swap(conn.job, job);
+                        conn.hasJob = true;
+                        schedule = !conn.scheduled;
+                        conn.scheduled = true;
+                    }
+                    if (schedule) {
+                        _ready.push(connection);
+                    }
+                }
+                break;
+            }
+            case MessageType::Reset:
+                conn.session.resetInput();
+                conn.session.setTemplate(*_template, *config.getScoringParams());
+                conn.session.getStats().reset();
+                conn.resetScoring.store(true, std::memory_order_release);
+                break;
+            case MessageType::Bye:
+                bye = true;
+                break;
+            default:
+                LOG_W("Session {}: unexpected message type {}", conn.id, header.type);
+                break;
+            }
+        }
+
+        // 等待在途的评分完成，统计才完整
+        {
+            std::unique_lock<std::mutex> lock(conn.jobMutex);
+            conn.idle.wait(lock, [&conn]() { return !conn.scheduled; });
+        }
+        finishSession(conn, bye);
+        conn.finished.store(true, std::memory_order_release);
+    }
+
+    void ScoringServer::workerLoop() {
+        Tracer::getInstance().setThreadName("server.worker");
+        std::shared_ptr<Connection> connection;
+        while (_ready.pop(connection)) {
+            // 每次只处理一个任务再重新排队，避免单个会话占住工作线程
+            // 会话数不超过队列容量且每个会话至多排队一次，重新入队不会阻塞
+            if (runScore(*connection) && !_ready.push(connection)) {
+                std::lock_guard<std::mutex> lock(connection->jobMutex);
+                connection->scheduled = false;
+                connection->idle.notify_all();
+            }
+            connection.reset();
+        }
+    }
+
+    bool ScoringServer::runScore(Connection& conn) {
+        Connection::ScoreJob& job = conn.running;
+        {
+            std::lock_guard<std::mutex> lock(conn.jobMutex);
+            std::swap(job, conn.job);
+            conn.hasJob = false;
+        }
+
+        KF_TRACE_SCOPE_ARG("score", "session", conn.id);
+        if (conn.resetScoring.exchange(false, std::memory_order_acq_rel)) {
+            conn.session.resetScoring();
+        }
+
+        // 模板为服务端只读副本，不同会话可并行评分
+        ScoringParams params = *Config::getInstance().getScoringParams();
+        _governor.apply(params);
+        const float similarity = conn.session.score(job.features, job.averageSpeed, *_template, params, job.timestamp);
+
+        const double latencyUs = TicksToMicroseconds(QueryTicks() - job.receiveTick);
+        conn.latency.record(latencyUs);
+        _governor.record(latencyUs, params.governorBudget);
+        conn.scores.fetch_add(1, std::memory_order_relaxed);
+        const WireScore message = { job.timestamp, similarity, static_cast<uint32_t>(latencyUs) };
+        conn.send(MessageType::Score, message);
+
+        std::lock_guard<std::mutex> lock(conn.jobMutex);
+        conn.scheduled = conn.hasJob;
+        if (!conn.scheduled) {
+            conn.idle.notify_all();
+        }
+        return conn.scheduled;
+    }
+
+    void ScoringServer::finishSession(Connection& conn, bool reply) {
+        const auto stats = conn.session.getStats().snapshot();
+        const HistogramSnapshot latency = conn.latency.snapshot();
+
+        WireStats message = {};
+        message.frames = conn.frames.load(std::memory_order_relaxed);
+        message.scores = conn.scores.load(std::memory_order_relaxed);
+        message.repetitions = conn.repetitions.load(std::memory_order_relaxed);
+        message.scoresSkipped = conn.skipped.load(std::memory_order_relaxed);
+        message.meanSimilarity = stats->sessionMean;
+        message.latencyP50Us = static_cast<float>(latency.p50);
+        message.latencyP99Us = static_cast<float>(latency.p99);
+        message.latencyMaxUs = static_cast<float>(latency.max);
+
+        LOG_I("Session {} ({}) closed: {} frames, {} scores ({} skipped), {} reps, mean {:.1f}%, "
+              "latency p50={:.0f}us p99={:.0f}us max={:.0f}us",
+              conn.id, conn.name, message.frames, message.scores, message.scoresSkipped, message.repetitions,
+              message.meanSimilarity * 100.0f, latency.p50, latency.p99, latency.max);
+
+        if (reply) {
+            conn.send(MessageType::Stats, message);
+        }
+    }
+
+} // namespace kfc
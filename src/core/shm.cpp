@@ -0,0 +1,374 @@
+#include <cstring>
+#include <algorithm>
+
+#include "core/shm.h"
+#include "core/utils.h"
+#include "core/metrics.h"
+#include "log/logger.h"
+
+namespace kfc {
+
+    static constexpr size_t kSharedRingSize = sizeof(SharedRingHeader) + sizeof(SharedBodySlot) * kSharedRingCapacity;
+
+    // 会话内可见的内核对象名（名称只含 ASCII 字符）
+    static std::wstring KernelObjectName(const std::string& name, const char* suffix = "") {
+        std::string full = "Local\\" + name + suffix;
+        return std::wstring(full.begin(), full.end());
+    }
+
+    static std::wstring ReaderEventName(const std::string& name, uint32_t index) {
+        return KernelObjectName(name, (".reader" + std::to_string(index)).c_str());
+    }
+
+    static bool IsProcessAlive(DWORD processId) {
+        if (processId == 0) {
+            return false;
+        }
+        HANDLE process = OpenProcess(SYNCHRONIZE, FALSE, processId);
+        if (!process) {
+            return false;
+        }
+        const bool alive = WaitForSingleObject(process, 0) == WAIT_TIMEOUT;
+        CloseHandle(process);
+        return alive;
+    }
+
+    static SharedBodySlot* SlotsOf(SharedRingHeader* header) {
+        return reinterpret_cast<SharedBodySlot*>(reinterpret_cast<char*>(header) + sizeof(SharedRingHeader));
+    }
+
+    // ----------------------------------------------------------------------------------------------
+
+    SharedBodyRingWriter::SharedBodyRingWriter() :
+        _mapping(nullptr),
+        _header(nullptr),
+        _slots(nullptr),
+        _readerEvents() {}
+
+    SharedBodyRingWriter::~SharedBodyRingWriter() {
+        close();
+    }
+
+    bool SharedBodyRingWriter::create(const std::string& name) {
+        close();
+
+        // 采集进程之间用命名互斥量串行化创建：判断占用、初始化与登记 publisherPid 必须整体完成，
+        // 否则后到的进程可能在先到者登记之后又把头部清零。持有者崩溃时等待返回 WAIT_ABANDONED，同样视为获得
+        HANDLE publisherLock = CreateMutexW(nullptr, FALSE, KernelObjectName(name, ".publisher").c_str());
+        if (!publisherLock) {
+            LOG_E("CreateMutex failed for shared ring {}: {}", name, GetLastError());
+            return false;
+        }
+        const DWORD waited = WaitForSingleObject(publisherLock, INFINITE);
+        if (waited != WAIT_OBJECT_0 && waited != WAIT_ABANDONED) {
+            LOG_E("Waiting for the publisher lock of shared ring {} failed: {}", name, GetLastError());
+            CloseHandle(publisherLock);
+            return false;
+        }
+        const bool created = createLocked(name);
+        ReleaseMutex(publisherLock);
+        CloseHandle(publisherLock);
+        return created;
+    }
+
+    bool SharedBodyRingWriter::createLocked(const std::string& name) {
+        _mapping = CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                      0, static_cast<DWORD>(kSharedRingSize), KernelObjectName(name).c_str());
+        const bool existed = GetLastError() == ERROR_ALREADY_EXISTS;
+        if (!_mapping) {
+            LOG_E("CreateFileMapping failed for shared ring {}: {}", name, GetLastError());
+            return false;
+        }
+
+        void* view = MapViewOfFile(_mapping, FILE_MAP_ALL_ACCESS, 0, 0, kSharedRingSize);
+        if (!view) {
+            LOG_E("MapViewOfFile failed for shared ring {}: {}", name, GetLastError());
+            CloseHandle(_mapping);
+            _mapping = nullptr;
+            return false;
+        }
+
+        auto* header = static_cast<SharedRingHeader*>(view);
+        const bool compatible = existed &&
+            header->magic.load(std::memory_order_acquire) == kSharedRingMagic &&
+            header->version == kSharedRingVersion &&
+            header->capacity == kSharedRingCapacity &&
+            header->slotSize == sizeof(SharedBodySlot);
+
+        // 同一时间只允许一个采集进程；前一个已退出（或崩溃）时接管并沿用原有序号。
+        // 先确认没有存活的采集进程，再初始化或接管，避免清掉正在使用的共享内存
+        const DWORD self = GetCurrentProcessId();
+        const uint32_t previous = compatible ? header->publisherPid.load(std::memory_order_acquire) : 0;
+        if (previous != 0 && previous != self && IsProcessAlive(previous)) {
+            LOG_E("Shared ring {} already has a publisher (pid {})", name, previous);
+            UnmapViewOfFile(view);
+            CloseHandle(_mapping);
+            _mapping = nullptr;
+            return false;
+        }
+
+        if (!compatible) {
+            // 新建的共享内存：先清零，头部字段就绪后最后写入 magic，消费者以此判断可用
+            std::memset(view, 0, kSharedRingSize);
+            header->version = kSharedRingVersion;
+            header->capacity = kSharedRingCapacity;
+            header->slotSize = sizeof(SharedBodySlot);
+            header->magic.store(kSharedRingMagic, std::memory_order_release);
+        }
+
+        header->publisherPid.store(self, std::memory_order_release);
+        const uint32_t epoch = header->publisherEpoch.fetch_add(1, std::memory_order_acq_rel) + 1;
+        header->heartbeatTick.store(QueryTicks(), std::memory_order_release);
+
+        _name = name;
+        _header = header;
+        _slots = SlotsOf(header);
+        LOG_I("Shared ring {} {} ({} KB, epoch {}, head {})", name, compatible ? "taken over" : "created",
+              kSharedRingSize / 1024, epoch, header->head.load(std::memory_order_relaxed));
+        return true;
+    }
+
+    void SharedBodyRingWriter::publish(INT64 timestamp, const BodyFrame* bodies, int count) {
+        if (!_header) {
+            return;
+        }
+
+        const uint32_t bodyCount = static_cast<uint32_t>(std::clamp(count, 0, BODY_COUNT));
+        const uint64_t head = _header->head.load(std::memory_order_relaxed);
+        SharedBodySlot& slot = _slots[head & (kSharedRingCapacity - 1)];
+
+        slot.version.store(head * 2 + 1, std::memory_order_relaxed);   // 奇数：写入中
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.timestamp = timestamp;
+        slot.publishTick = QueryTicks();
+        slot.bodyCount = bodyCount;
+        if (bodyCount > 0) {
+            std::memcpy(slot.bodies, bodies, sizeof(BodyFrame) * bodyCount);
+        }
+        slot.version.store(head * 2 + 2, std::memory_order_release);   // 偶数：序号 head 已就绪
+
+        _header->head.store(head + 1, std::memory_order_release);
+        _header->heartbeatTick.store(slot.publishTick, std::memory_order_release);
+        signalReaders();
+    }
+
+    void SharedBodyRingWriter::signalReaders() {
+        for (uint32_t i = 0; i < kSharedRingMaxReaders; ++i) {
+            if (_header->readers[i].state.load(std::memory_order_acquire) == 0) {
+                // 消费者已退出，释放缓存的事件句柄
+                if (_readerEvents[i]) {
+                    CloseHandle(_readerEvents[i]);
+                    _readerEvents[i] = nullptr;
+                }
+                continue;
+            }
+
+            // 消费者登记后才创建事件，尚未创建时下一帧再试
+            if (!_readerEvents[i]) {
+                _readerEvents[i] = OpenEventW(EVENT_MODIFY_STATE, FALSE, ReaderEventName(_name, i).c_str());
+            }
+            if (_readerEvents[i]) {
+                SetEvent(_readerEvents[i]);
+            }
+        }
+    }
+
+    void SharedBodyRingWriter::close() {
+        for (auto& event : _readerEvents) {
+            if (event) {
+                CloseHandle(event);
+                event = nullptr;
+            }
+        }
+
+        if (_header) {
+            uint32_t self = GetCurrentProcessId();
+            _header->publisherPid.compare_exchange_strong(self, 0, std::memory_order_acq_rel);
+            UnmapViewOfFile(_header);
+            _header = nullptr;
+            _slots = nullptr;
+        }
+        if (_mapping) {
+            CloseHandle(_mapping);
+            _mapping = nullptr;
+        }
+    }
+
+    uint64_t SharedBodyRingWriter::getPublished() const {
+        return _header ? _header->head.load(std::memory_order_acquire) : 0;
+    }
+
+    // ----------------------------------------------------------------------------------------------
+
+    SharedBodyRingReader::SharedBodyRingReader() :
+        _mapping(nullptr),
+        _event(nullptr),
+        _header(nullptr),
+        _slots(nullptr),
+        _index(kSharedRingMaxReaders),
+        _position(0),
+        _pending(0),
+        _dropped(0) {}
+
+    SharedBodyRingReader::~SharedBodyRingReader() {
+        close();
+    }
+
+    bool SharedBodyRingReader::open(const std::string& name) {
+        close();
+
+        // 需要写权限：消费者登记与游标位于共享头部
+        _mapping = OpenFileMappingW(FILE_MAP_ALL_ACCESS, FALSE, KernelObjectName(name).c_str());
+        if (!_mapping) {
+            return false;   // 采集进程尚未启动
+        }
+
+        void* view = MapViewOfFile(_mapping, FILE_MAP_ALL_ACCESS, 0, 0, kSharedRingSize);
+        auto* header = static_cast<SharedRingHeader*>(view);
+        if (!header || header->magic.load(std::memory_order_acquire) != kSharedRingMagic ||
+            header->version != kSharedRingVersion || header->capacity != kSharedRingCapacity ||
+            header->slotSize != sizeof(SharedBodySlot)) {
+            if (header) {
+                LOG_E("Shared ring {} has an incompatible layout", name);
+                UnmapViewOfFile(view);
+            }
+            CloseHandle(_mapping);
+            _mapping = nullptr;
+            return false;
+        }
+
+        // 登记消费者：优先取空闲槽位，其次回收已退出进程留下的槽位
+        const DWORD self = GetCurrentProcessId();
+        uint32_t index = kSharedRingMaxReaders;
+        for (uint32_t i = 0; i < kSharedRingMaxReaders && index == kSharedRingMaxReaders; ++i) {
+            uint32_t expected = 0;
+            if (header->readers[i].state.compare_exchange_strong(expected, 1, std::memory_order_acq_rel)) {
+                header->readers[i].processId.store(self, std::memory_order_release);
+                index = i;
+            }
+        }
+        for (uint32_t i = 0; i < kSharedRingMaxReaders && index == kSharedRingMaxReaders; ++i) {
+            uint32_t owner = header->readers[i].processId.load(std::memory_order_acquire);
+            if (owner != 0 && owner != self && !IsProcessAlive(owner) &&
+                header->readers[i].processId.compare_exchange_strong(owner, self, std::memory_order_acq_rel)) {
+                index = i;
+            }
+        }
+        if (index == kSharedRingMaxReaders) {
+            LOG_E("Shared ring {} has no free reader slot ({} readers)", name, kSharedRingMaxReaders);
+            UnmapViewOfFile(view);
+            CloseHandle(_mapping);
+            _mapping = nullptr;
+            return false;
+        }
+
+        _event = CreateEventW(nullptr, FALSE, FALSE, ReaderEventName(name, index).c_str());
+        _header = header;
+        _slots = SlotsOf(header);
+        _index = index;
+        _position = header->head.load(std::memory_order_acquire);   // 从最新一帧之后开始读
+        _dropped = 0;
+        header->readers[index].position.store(_position, std::memory_order_release);
+
+        LOG_I("Attached to shared ring {} as reader {} (publisher pid {}, epoch {})", name, index,
+              header->publisherPid.load(std::memory_order_relaxed),
+              header->publisherEpoch.load(std::memory_order_relaxed));
+        return true;
+    }
+
+    void SharedBodyRingReader::close() {
+        if (_event) {
+            CloseHandle(_event);
+            _event = nullptr;
+        }
+        if (_header) {
+            auto& reader = _header->readers[_index];
+            reader.processId.store(0, std::memory_order_relaxed);
+            reader.state.store(0, std::memory_order_release);
+            UnmapViewOfFile(_header);
+            _header = nullptr;
+            _slots = nullptr;
+            _index = kSharedRingMaxReaders;
+        }
+        if (_mapping) {
+            CloseHandle(_mapping);
+            _mapping = nullptr;
+        }
+    }
+
+    const SharedBodySlot* SharedBodyRingReader::peek() {
+        if (!_header) {
+            return nullptr;
+        }
+
+        for (;;) {
+            const uint64_t head = _header->head.load(std::memory_order_acquire);
+            if (_position >= head) {
+                return nullptr;
+            }
+
+            // 落后超过一圈：跳到仍然有效的最旧一帧
+            if (head - _position > kSharedRingCapacity) {
+                const uint64_t skipped = head - kSharedRingCapacity - _position;
+                _dropped += skipped;
+                Metrics::getInstance().add(Counter_SharedRingDropped, skipped);
+                _position = head - kSharedRingCapacity;
+            }
+
+            const SharedBodySlot* slot = &_slots[_position & (kSharedRingCapacity - 1)];
+            if (slot->version.load(std::memory_order_acquire) == _position * 2 + 2) {
+                _pending = _position;
+                return slot;
+            }
+
+            // 正在被覆盖，跳过该帧
+            ++_dropped;
+            Metrics::getInstance().add(Counter_SharedRingDropped);
+            ++_position;
+        }
+    }
+
+    bool SharedBodyRingReader::release() {
+        if (!_header) {
+            return false;
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const SharedBodySlot& slot = _slots[_pending & (kSharedRingCapacity - 1)];
+        const bool intact = slot.version.load(std::memory_order_relaxed) == _pending * 2 + 2;
+        if (!intact) {
+            ++_dropped;
+            Metrics::getInstance().add(Counter_SharedRingDropped);
+        }
+
+        _position = _pending + 1;
+        _header->readers[_index].position.store(_position, std::memory_order_release);
+        return intact;
+    }
+
+    bool SharedBodyRingReader::wait(DWORD timeoutMs) {
+        if (!_header) {
+            return false;
+        }
+        if (_header->head.load(std::memory_order_acquire) > _position) {
+            return true;
+        }
+        if (!_event) {
+            Sleep(1);
+            return _header->head.load(std::memory_order_acquire) > _position;
+        }
+        return WaitForSingleObject(_event, timeoutMs) == WAIT_OBJECT_0;
+    }
+
+    bool SharedBodyRingReader::isPublisherAlive() const {
+        return _header && IsProcessAlive(_header->publisherPid.load(std::memory_order_acquire));
+    }
+
+    double SharedBodyRingReader::getPublisherIdleMs() const {
+        if (!_header) {
+            return 0.0;
+        }
+        return TicksToMicroseconds(QueryTicks() - _header->heartbeatTick.load(std::memory_order_acquire)) / 1000.0;
+    }
+
+} // namespace kfc
@@ -0,0 +1,218 @@
+#include <chrono>
+#include <iomanip>
+#include <algorithm>
+
+#include "core/trace.h"
+#include "log/logger.h"
+
+namespace kfc {
+
+    static constexpr auto kFlushInterval = std::chrono::milliseconds(200);
+
+    // 每线程状态：名字随时可设，缓冲只在记录开启后按需取得，线程退出时归还给记录器复用
+    struct TraceThreadState {
+        const char* name = nullptr;
+        TraceBuffer* buffer = nullptr;
+
+        ~TraceThreadState() {
+            if (buffer) {
+                Tracer::getInstance().releaseBuffer(buffer);
+            }
+        }
+    };
+
+    static thread_local TraceThreadState t_traceState;
+
+    Tracer::Tracer() :
+        _enabled(false),
+        _startTick(0),
+        _processId(GetCurrentProcessId()),
+        _firstEvent(true),
+        _flushRunning(false) {}
+
+    Tracer::~Tracer() {
+        stop();
+    }
+
+    bool Tracer::start(const std::string& path) {
+        std::lock_guard<std::mutex> flushLock(_flushMutex);
+        if (_flushRunning) {
+            return false;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_fileMutex);
+            _file.open(path, std::ios::trunc);
+            if (!_file) {
+                LOG_E("Failed to open trace file: {}", path);
+                return false;
+            }
+            _file << std::fixed << std::setprecision(3) << "[\n";
+            _firstEvent = true;
+        }
+
+        {
+            // 重新开始时线程名需要再写一次
+            std::lock_guard<std::mutex> lock(_registryMutex);
+            for (auto& buffer : _buffers) {
+                buffer->nameWritten = false;
+            }
+        }
+
+        _startTick = QueryTicks();
+        _enabled.store(true, std::memory_order_release);
+        _flushRunning = true;
+        _flushThread = std::thread(&Tracer::flushLoop, this);
+        LOG_I("Tracing to {}", path);
+        return true;
+    }
+
+    void Tracer::stop() {
+        {
+            std::lock_guard<std::mutex> lock(_flushMutex);
+            if (!_flushRunning) {
+                return;
+            }
+            _flushRunning = false;
+        }
+        _enabled.store(false, std::memory_order_release);
+        _flushWake.notify_all();
+        if (_flushThread.joinable()) {
+            _flushThread.join();
+        }
+
+        flush();
+
+        uint64_t dropped = 0;
+        {
+            std::lock_guard<std::mutex> lock(_registryMutex);
+            for (const auto& buffer : _buffers) {
+                dropped += buffer->dropped.exchange(0, std::memory_order_relaxed);
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(_fileMutex);
+        _file << "\n]\n";
+        _file.close();
+        LOG_I("Tracing stopped ({} events dropped)", dropped);
+    }
+
+    TraceBuffer* Tracer::threadBuffer() {
+        if (!t_traceState.buffer) {
+            t_traceState.buffer = acquireBuffer(t_traceState.name);
+        }
+        return t_traceState.buffer;
+    }
+
+    TraceBuffer* Tracer::acquireBuffer(const char* threadName) {
+        std::lock_guard<std::mutex> lock(_registryMutex);
+        TraceBuffer* buffer = nullptr;
+        // 只复用事件已全部写出的缓冲，避免把上一个线程的事件记到新线程名下
+        auto free = std::find_if(_freeBuffers.begin(), _freeBuffers.end(), [](const TraceBuffer* candidate) {
+            return candidate->tail.load(std::memory_order_acquire) == candidate->head.load(std::memory_order_relaxed);
+        });
+        if (free != _freeBuffers.end()) {
+            buffer = *free;
+            _freeBuffers.erase(free);
+        } else {
+            _buffers.push_back(std::make_unique<TraceBuffer>());
+            buffer = _buffers.back().get();
+        }
+        buffer->threadId = GetCurrentThreadId();
+        buffer->threadName = threadName ? threadName : "";
+        buffer->nameWritten = false;
+        return buffer;
+    }
+
+    void Tracer::releaseBuffer(TraceBuffer* buffer) {
+        std::lock_guard<std::mutex> lock(_registryMutex);
+        _freeBuffers.push_back(buffer);
+    }
+
+    void Tracer::record(const char* name, INT64 begin, INT64 end, const char* argName, int64_t argValue) {
+        if (!isEnabled()) {
+            return;
+        }
+
+        TraceBuffer* buffer = threadBuffer();
+        const uint64_t head = buffer->head.load(std::memory_order_relaxed);
+        if (head - buffer->tail.load(std::memory_order_acquire) >= TraceBuffer::kCapacity) {
+            buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        buffer->events[head & (TraceBuffer::kCapacity - 1)] = TraceEvent{ name, argName, argValue, begin, end };
+        buffer->head.store(head + 1, std::memory_order_release);
+    }
+
+    void Tracer::setThreadName(const char* name) {
+        t_traceState.name = name;
+        if (TraceBuffer* buffer = t_traceState.buffer) {
+            std::lock_guard<std::mutex> lock(_registryMutex);
+            buffer->threadName = name;
+            buffer->nameWritten = false;
+        }
+    }
+
+    void Tracer::flushLoop() {
+        std::unique_lock<std::mutex> lock(_flushMutex);
+        while (_flushRunning) {
+            _flushWake.wait_for(lock, kFlushInterval, [this]() { return !_flushRunning; });
+            lock.unlock();
+            flush();
+            lock.lock();
+        }
+    }
+
+    void Tracer::flush() {
+        std::vector<TraceBuffer*> buffers;
+        std::vector<std::pair<DWORD, std::string>> names;
+        {
+            std::lock_guard<std::mutex> lock(_registryMutex);
+            for (auto& buffer : _buffers) {
+                buffers.push_back(buffer.get());
+                if (!buffer->nameWritten && !buffer->threadName.empty()) {
+                    names.emplace_back(buffer->threadId, buffer->threadName);
+                    buffer->nameWritten = true;
+                }
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(_fileMutex);
+        if (!_file.is_open()) {
+            return;
+        }
+
+        for (const auto& [threadId, threadName] : names) {
+            _file << (_firstEvent ? "" : ",\n")
+                  << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << _processId << ",\"tid\":" << threadId
+                  << ",\"args\":{\"name\":\"" << threadName << "\"}}";
+            _firstEvent = false;
+        }
+
+        for (TraceBuffer* buffer : buffers) {
+            const uint64_t head = buffer->head.load(std::memory_order_acquire);
+            uint64_t tail = buffer->tail.load(std::memory_order_relaxed);
+            for (; tail < head; ++tail) {
+                const TraceEvent& event = buffer->events[tail & (TraceBuffer::kCapacity - 1)];
+                // 上一次记录遗留的事件
+                if (event.begin < _startTick) {
+                    continue;
+                }
+                _file << (_firstEvent ? "" : ",\n")
+                      << "{\"name\":\"" << event.name << "\",\"cat\":\"kfc\",\"ph\":\"X\""
+                      << ",\"ts\":" << TicksToMicroseconds(event.begin - _startTick)
+                      << ",\"dur\":" << TicksToMicroseconds(event.end - event.begin)
+                      << ",\"pid\":" << _processId << ",\"tid\":" << buffer->threadId;
+                if (event.argName) {
+                    _file << ",\"args\":{\"" << event.argName << "\":" << event.argValue << '}';
+                }
+                _file << '}';
+                _firstEvent = false;
+            }
+            buffer->tail.store(head, std::memory_order_release);
+        }
+        _file.flush();
+    }
+
+} // namespace kfc
@@ -11,8 +11,28 @@ namespace kfc {
 
     void Logger::Init() {
         sLoggerInstance = spdlog::stdout_color_mt<spdlog::async_factory>("async_logger");
-        sLoggerInstance->set_level(spdlog::level::trace);
+        sLoggerInstance->set_level(static_cast<spdlog::level::level_enum>(SPDLOG_ACTIVE_LEVEL));
         sLoggerInstance->set_pattern("%^%H:%M:%S:%e [%P-%t] [%1!L] [%20s:%-4#] - %v%$");
+        LogRecorder::getInstance().start();
+    }
+
+    void Logger::Shutdown() {
+        LogRecorder::getInstance().stop();
+        if (sLoggerInstance) {
+            sLoggerInstance->flush();
+        }
+    }
+
+    void Logger::SetLevel(const std::string& level) {
+        auto parsed = spdlog::level::from_str(level);
+        if (parsed == spdlog::level::off && level != "off") {
+            LOG_W("Unknown log level: {}", level);
+            return;
+        }
+        if (parsed < static_cast<spdlog::level::level_enum>(SPDLOG_ACTIVE_LEVEL)) {
+            LOG_W("Log level {} is below the compiled level, lower levels are stripped", level);
+        }
+        sLoggerInstance->set_level(parsed);
     }
 
 }
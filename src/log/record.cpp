@@ -0,0 +1,155 @@
+#define NOMINMAX
+#include <Windows.h>
+#include <chrono>
+#ifdef SPDLOG_FMT_EXTERNAL
+#include <fmt/args.h>
+#else
+#include "spdlog/fmt/bundled/args.h"
+#endif
+
+#include "log/record.h"
+#include "log/logger.h"
+
+namespace kfc {
+
+    static constexpr auto kDrainInterval = std::chrono::milliseconds(50);
+
+    LogRecorder& LogRecorder::getInstance() {
+        static LogRecorder instance;
+        return instance;
+    }
+
+    LogRecorder::LogRecorder() :
+        _enqueuePos(0),
+        _dequeuePos(0),
+        _dropped(0),
+        _running(false) {
+        for (size_t i = 0; i < kCapacity; ++i) {
+            _cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    LogRecorder::~LogRecorder() {
+        stop();
+    }
+
+    void LogRecorder::enqueue(const LogRecord& record) {
+        // 有界 MPMC 队列（Vyukov），每个槽位的序号表示其状态
+        size_t pos = _enqueuePos.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &_cells[pos & (kCapacity - 1)];
+            const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                _dropped.fetch_add(1, std::memory_order_relaxed);   // 队列已满
+                return;
+            } else {
+                pos = _enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+        cell->record = record;
+        cell->sequence.store(pos + 1, std::memory_order_release);
+    }
+
+    bool LogRecorder::dequeue(LogRecord& record) {
+        Cell& cell = _cells[_dequeuePos & (kCapacity - 1)];
+        if (cell.sequence.load(std::memory_order_acquire) != _dequeuePos + 1) {
+            return false;
+        }
+        record = cell.record;
+        cell.sequence.store(_dequeuePos + kCapacity, std::memory_order_release);
+        ++_dequeuePos;
+        return true;
+    }
+
+    void LogRecorder::drain() {
+        auto* logger = Logger::GetLoggerInstance();
+        LogRecord record;
+        while (dequeue(record)) {
+            fmt::dynamic_format_arg_store<fmt::format_context> store;
+            for (uint8_t i = 0; i < record.argc; ++i) {
+                const LogArg& arg = record.args[i];
+                switch (arg.type) {
+                case LogArg::Type::Int:    store.push_back(arg.i); break;
+                case LogArg::Type::UInt:   store.push_back(arg.u); break;
+                case LogArg::Type::Double: store.push_back(arg.d); break;
+                case LogArg::Type::CStr:   store.push_back(arg.s); break;
+                }
+            }
+
+            const spdlog::source_loc location{ record.file, record.line, "" };
+            try {
+                logger->log(location, record.level, "{}", fmt::vformat(record.format, store));
+            } catch (const std::exception& e) {
+                logger->log(location, spdlog::level::err, "Bad log format \"{}\": {}", record.format, e.what());
+            }
+        }
+    }
+
+    void LogRecorder::run() {
+        std::unique_lock<std::mutex> lock(_mutex);
+        while (_running) {
+            _wake.wait_for(lock, kDrainInterval, [this]() { return !_running; });
+            lock.unlock();
+            drain();
+            lock.lock();
+        }
+    }
+
+    void LogRecorder::start() {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_running) {
+            return;
+        }
+        _running = true;
+        _thread = std::thread(&LogRecorder::run, this);
+    }
+
+    void LogRecorder::stop() {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (!_running) {
+                return;
+            }
+            _running = false;
+        }
+        _wake.notify_all();
+        if (_thread.joinable()) {
+            _thread.join();
+        }
+        drain();
+
+        const uint64_t dropped = _dropped.exchange(0, std::memory_order_relaxed);
+        if (dropped > 0) {
+            LOG_W("Fast log queue overflowed, {} records dropped", dropped);
+        }
+    }
+
+    LogRateLimiter::LogRateLimiter(int intervalMs) :
+        _intervalTicks(0),
+        _next(0),
+        _suppressed(0) {
+        LARGE_INTEGER frequency;
+        QueryPerformanceFrequency(&frequency);
+        _intervalTicks = frequency.QuadPart * intervalMs / 1000;
+    }
+
+    bool LogRateLimiter::allow(uint64_t& suppressed) {
+        LARGE_INTEGER counter;
+        QueryPerformanceCounter(&counter);
+        const int64_t now = counter.QuadPart;
+        int64_t next = _next.load(std::memory_order_relaxed);
+        if (now < next || !_next.compare_exchange_strong(next, now + _intervalTicks, std::memory_order_relaxed)) {
+            _suppressed.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        suppressed = _suppressed.exchange(0, std::memory_order_relaxed);
+        return true;
+    }
+
+} // namespace kfc
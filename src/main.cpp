@@ -10,6 +10,10 @@
 #include "ui/window.h"
 #include "core/application.h"
 #include "config/config.h"
+#include "config/watcher.h"
+#include "core/cli.h"
+#include "core/metrics.h"
+#include "core/trace.h"
 
 int main(int argc, char** argv)
 {
@@ -29,6 +33,22 @@ int main(int argc, char** argv)
     kfc::Logger::Init();
     kfc::Config::Init(KFC_CONFIG_FILE);
 
-    Application application;
-    return application.Run(GetModuleHandle(NULL), SW_SHOWNORMAL);
+    const auto& config = kfc::Config::getInstance();
+    kfc::Metrics::getInstance().startDump(config.metricsPath, config.metricsInterval);
+    if (!config.tracePath.empty()) {
+        kfc::Tracer::getInstance().start(config.tracePath);
+    }
+    kfc::ConfigWatcher::getInstance().start(KFC_CONFIG_FILE);
+
+    int exitCode = 0;
+    if (!kfc::TryRunCommand(argc, argv, exitCode)) {
+        Application application;
+        exitCode = application.Run(GetModuleHandle(NULL), SW_SHOWNORMAL);
+    }
+
+    kfc::ConfigWatcher::getInstance().stop();
+    kfc::Tracer::getInstance().stop();
+    kfc::Metrics::getInstance().stopDump();
+    kfc::Logger::Shutdown();
+    return exitCode;
 }